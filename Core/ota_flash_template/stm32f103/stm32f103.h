@@ -26,7 +26,9 @@ static const MiniOTA_FlashLayout F103_Low_Layout = {
                    (OTA_FLASH_SIZE <= 384 * OTA_1KB) ? 6 :
                    (OTA_FLASH_SIZE <= 512 * OTA_1KB) ? 7 :
                    (OTA_FLASH_SIZE <= 768 * OTA_1KB) ? 8 : 9,
-    .groups = F103Ser
+    .groups = F103Ser,
+    // XL 大容量型 (>512KB) 的 Bank2 从 512KB 处开始，拥有独立的 Flash 控制器
+    .bank2_addr = (OTA_FLASH_SIZE > 512 * OTA_1KB) ? (OTA_FLASH_START_ADDRESS + 512 * OTA_1KB) : 0
 };
 
 const MiniOTA_FlashLayout* MiniOTA_GetLayout(void) 
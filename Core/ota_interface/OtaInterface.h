@@ -63,6 +63,162 @@
 
 /* Flash 页大小 (Cortex-M3 常用 1024 或 2048) */
 #define OTA_FLASH_PAGE_SIZE       1024
+
+/* App 插槽数量 (2~8): 默认布局下 Meta 之后的空间平分为 N 个插槽，也可由分区表给出;
+ * 启动时优先激活插槽，校验失败时回退到版本号最高的已验证插槽;
+ * OTA_DUAL_BANK/OTA_EXT_STAGING/OTA_BACKUP_COMPRESSED/OTA_SWAP_INSTALL 时须为 2 */
+#define OTA_SLOT_NUM              2
+
+/* 升级目标插槽的选择策略: 0-最久未写入 (LRU), 1-固件版本号最低;
+ * 空插槽与无效插槽总是优先，当前启动的插槽不会被选为目标 */
+#define OTA_SLOT_SELECT_POLICY    0
+
+/* 双 Bank: 1-Slot A 位于 Bank1 剩余空间，Slot B 从第二个 Bank 起始处开始 (大小与 A 相同)，
+ * 写入一个 Bank 时在另一个 Bank 中运行的代码不会被挂起 (如 STM32F10x XL 大容量型);
+ * 0-单 Bank，A/B 平分 Meta 之后的空间 */
+#define OTA_DUAL_BANK             0
+
+/* 第二个 Bank 的起始地址 (OTA_DUAL_BANK 为 1 时有效，STM32F10x XL 为 0x08080000) */
+#define OTA_BANK2_START_ADDRESS   0x08080000UL
+
+/* 外部暂存: 1-Slot A 占用 Meta 之后的全部内部空间，新固件先下载到外部 SPI NOR 中的 Slot B，
+ * 校验通过后在下次启动时复制到 Slot A (OTA_SpiSelect/OTA_SpiTransfer/OTA_SpiTransferBlock);
+ * 0-A/B 均位于内部 Flash */
+#define OTA_EXT_STAGING           0
+
+/* 外部 Flash 在 MiniOTA 中使用的虚拟起始地址，不需要内存映射，只需不与内部 Flash/RAM 重叠 */
+#define OTA_EXT_FLASH_BASE        0x90000000UL
+
+/* 暂存分区在外部 Flash 中的偏移，必须按 4KB 扇区对齐; 暂存分区占用 OTA_APP_SLOT_SIZE 向上取整到 4KB 的空间 */
+#define OTA_EXT_STAGING_OFFSET    0x000000UL
+
+/* 压缩备份: 1-Slot A (可执行) 占用大部分空间，Slot B 只保存上一版固件的 LZ 压缩副本，
+ * 升级前由 Bootloader 压缩 A 到 B，新固件校验失败时解压回 A 实现回滚; 0-A/B 等大。
+ * 与 OTA_EXT_STAGING/OTA_DUAL_BANK 互斥 */
+#define OTA_BACKUP_COMPRESSED     0
+
+/* 压缩备份分区占 Meta 之后空间的百分比 (OTA_BACKUP_COMPRESSED 为 1 时有效)，
+ * 需不小于 Slot A 固件的压缩率，固件约能压缩到一半时取 34 */
+#define OTA_BACKUP_SLOT_PERCENT   34
+
+/* 交换安装: 1-固件总是链接并运行在 Slot A，新固件下载到 Slot B 后由 Bootloader 经暂存页与 A 逐页交换，
+ * 交换进度记录在进度页中，掉电后从中断处继续; 交换后 B 保存旧固件，新固件失效时再次交换即可回滚;
+ * Meta 之后空间的末尾两页用作暂存页与进度页，与 OTA_EXT_STAGING/OTA_BACKUP_COMPRESSED/OTA_DUAL_BANK 互斥 */
+#define OTA_SWAP_INSTALL          0
+
+/* 安装时重定位: 1-固件以 0 为基址链接并在尾部附带重定位表 (Tools/OtaRelocGen.py 生成)，
+ * 下载完成后按运行地址修正绝对地址，同一个固件文件可写入任意插槽，不再提示 IOM 地址;
+ * 不带重定位表的固件仍按原样安装; 0-固件须按目标插槽地址链接 */
+#define OTA_RELOC_ENABLE          0
+
+/* 分块修复: 1-v2 固件头带分块 CRC 表 (OTA_TLV_CHUNKS) 时，校验失败的插槽先逐块检查，
+ * 损坏的块与其他插槽中同一位置的内容一致时直接复制，其余损坏的块输出序号，
+ * 上位机只需发送这些块组成的修复流 (Tools/OtaImageGen.py --repair); 0-校验失败即整体重新下载
+ * 与 OTA_EXT_STAGING 同时使能时，暂存分区按 4KB 扇区读-改-写，另占 (4KB - OTA_FLASH_PAGE_SIZE) RAM */
+#define OTA_REPAIR_ENABLE         0
+
+/* 流式摘要: 1-v2 固件头带 SHA-256 摘要 (OTA_TLV_HASH) 时，接收过程中随数据计算固件体的摘要，
+ * 收到 EOT 时只需比对 32 字节，不符则以 CAN 代替应答、插槽不标记为待确认; 0-不计算，摘要 TLV 被忽略 */
+#define OTA_SHA256_ENABLE         0
+
+/* 签名验证: 1-固件头须带 SHA-256 摘要与 Ed25519 签名 (OTA_TLV_SIGNATURE)，收到 EOT 时用内置公钥验证，
+ * 不带签名或验证失败的固件被拒绝; 启动时插槽签名只验证一次，结果记录在 Meta 中，之后只做 CRC 校验;
+ * 需同时使能 OTA_SHA256_ENABLE，不支持 OTA_RELOC_ENABLE (安装时改写固件体); 0-不验证 */
+#define OTA_SIG_ENABLE            0
+
+/* 签名公钥 (32 字节)，由 Tools/OtaImageGen.py --keygen 生成; 默认值为 RFC 8032 的测试公钥，量产前必须替换 */
+#define OTA_SIG_PUBKEY            { 0xD7, 0x5A, 0x98, 0x01, 0x82, 0xB1, 0x0A, 0xB7, 0xD5, 0x4B, 0xFE, 0xD3, 0xC9, 0x64, 0x07, 0x3A, \
+                                    0x0E, 0xE1, 0x72, 0xF3, 0xDA, 0xA6, 0x23, 0x25, 0xAF, 0x02, 0x1A, 0x68, 0xF7, 0x07, 0x51, 0x1A }
+
+/* 加密固件: 1-接受带 OTA_IMG_FLAG_ENCRYPTED 的固件，固件体为 AES-128-CTR 密文 (初始计数块在 OTA_TLV_IV 中)，
+ * 接收时在写入页镜像的同时解密，插槽中保存明文，CRC、摘要与签名均按明文计算; 0-拒绝加密固件 */
+#define OTA_AES_ENABLE            0
+
+/* 固件加密密钥 (16 字节)，由 Tools/OtaImageGen.py --aes-keygen 生成; 默认值为 FIPS 197 的示例密钥，量产前必须替换 */
+#define OTA_AES_KEY               { 0x2B, 0x7E, 0x15, 0x16, 0x28, 0xAE, 0xD2, 0xA6, 0xAB, 0xF7, 0x15, 0x88, 0x09, 0xCF, 0x4F, 0x3C }
+
+/* 1-由硬件 AES 解密 (OTA_AesHwCtr，如 STM32F415/417/437/439 的 CRYP)，不编译查表实现; 0-软件查表实现 */
+#define OTA_AES_HW                0
+
+/* 非内存映射存储 (外部 SPI NOR) 的预读缓存大小(字节)，顺序的小块读取合并为一次总线传输; 0-关闭 */
+#define OTA_BDEV_CACHE_SIZE       256
+
+/* Meta 页中分区表的最大表项数; 分区表由 App 或产线工具写入 (OTA_PartSave)，
+ * 不存在或校验失败时使用上面宏定义的默认布局，调整分区无需重新编译 Bootloader */
+#define OTA_PART_MAX_NUM          8
+/**
+ * @}
+ */
+
+/** @defgroup OTA_Xmodem_Timeout_Settings
+ * @{
+ */
+/* 等待传输开始时发送 'C' 的间隔(ms) */
+#define OTA_XM_START_INTERVAL_MS  100
+
+/* 包内字节间超时(ms): 超时后丢弃当前包，等线路静默该时长后再发送 NAK 请求重发 */
+#define OTA_XM_BYTE_TIMEOUT_MS    50
+
+/* 单包接收超时(ms): 128 字节包 (SOH) 从包头到 CRC 的最长时间，1024 字节包 (STX) 按 8 倍计算;
+ * 与波特率相关，需大于 133 字节在当前波特率下的传输时间 (如 4800 波特约 280ms) */
+#define OTA_XM_PACKET_TIMEOUT_MS  2000
+
+/* 会话超时(ms): 传输开始后超过该时间没有成功写入任何数据包则放弃本次传输 */
+#define OTA_XM_SESSION_TIMEOUT_MS 30000
+/**
+ * @}
+ */
+
+/** @defgroup OTA_Rx_Settings
+ * @{
+ */
+/* 接收环形缓冲区大小(字节)，必须为 2 的幂
+ * 需能容纳 Flash 提交期间到达的数据，建议不小于一个 1024 字节包 */
+#define OTA_RX_BUF_SIZE           2048
+/**
+ * @}
+ */
+
+/** @defgroup OTA_RamFunc_Settings
+ * @{
+ */
+/* SRAM 执行: 1-Flash 擦写校验路径与接收中断链放入 .RamFunc 段在 SRAM 中运行，
+ * IAP 期间向量表也复制到 SRAM，Flash 忙时串口中断仍可及时响应;
+ * 需在分散加载文件/链接脚本中将 .RamFunc 段放入 RAM 执行区; 0-全部在 Flash 中运行 */
+#define OTA_RAMFUNC_ENABLE        0
+
+/* 向量表项数 (16 个内核异常 + 外设中断数)，STM32F10x 互联型最多 16 + 68 */
+#define OTA_VECTOR_NUM            84
+
+/* SRAM 向量表对齐字节数: 不小于 OTA_VECTOR_NUM * 4 的 2 的幂，且不小于 128 */
+#define OTA_VECTOR_ALIGN          512
+
+/* 预擦除: 1-页镜像开始接收数据后即在后台擦除该页 (OTA_EraseStart/OTA_FlashIsBusy/OTA_EraseComplete)，
+ * 提交时只需编程; STM32F1 等擦除期间无法从 Flash 取指的芯片须同时使能 OTA_RAMFUNC_ENABLE，
+ * 否则擦除期间接收中断无法响应; 0-提交时同步擦除 */
+#define OTA_FLASH_ERASE_AHEAD     0
+/**
+ * @}
+ */
+
+/** @defgroup OTA_Log_Settings
+ * @{
+ */
+/* 调试日志等级: 0-关闭 1-错误 2-流程信息 3-调试(含逐包日志)
+ * 高于该等级的日志在编译期被完全剔除，不占用 Flash 与运行时间 */
+#define OTA_LOG_LEVEL             2
+
+/* 调试日志环形缓冲区大小(字节)，必须为 2 的幂 */
+#define OTA_LOG_BUF_SIZE          512
+
+/* 令牌化日志: 1-只发送日志 ID 与参数(每条 3~7 字节，固件中不含日志文本)，
+ * 需用 Tools/OtaLogDecode.py 配合 OtaLogDict.h 还原; 0-直接发送文本 */
+#define OTA_LOG_TOKENIZED         0
+
+/* 热路径耗时统计: 1-使能 DWT CYCCNT 测量 (擦除/编程/校验/CRC/中断/应答/启动各阶段)，
+ * 结果保存在 ota_prof_stats[] 中并在跳转前通过调试日志输出; 0-全部编译为空
+ * 主机仿真时定义 OTA_HOST_BUILD，改用 clock_gettime 计时 (单位纳秒) */
+#define OTA_PROF_ENABLE           0
 /**
  * @}
  */
@@ -75,8 +231,48 @@ void OTA_Run(void);
 
 /**
  * @brief  串口中断/数据接收回调
+ *         仅将字节存入接收缓冲区，协议解析在 OTA_Run 的调度循环中完成
  * @param  byte: 接收到的数据字节
  */
 void OTA_ReceiveTask(uint8_t byte);
 
+/** @defgroup OTA_Link_Error_Flags
+ * @{
+ */
+#define OTA_LINK_ERR_ORE          0x01    /**< 接收溢出 (Overrun) */
+#define OTA_LINK_ERR_FE           0x02    /**< 帧错误 (Framing error) */
+#define OTA_LINK_ERR_NE           0x04    /**< 噪声错误 (Noise error) */
+#define OTA_LINK_ERR_RXBUF        0x08    /**< 接收缓冲区满，字节被丢弃 */
+/**
+ * @}
+ */
+
+/**
+ * @brief  串口接收错误回调
+ *         在接收中断中检测到 ORE/FE/NE 时调用，用于链路健康统计
+ * @param  err: OTA_LINK_ERR_xxx 位组合
+ */
+void OTA_ReceiveErrTask(uint8_t err);
+
+/**
+ * @brief  调试串口发送中断(TXE)回调: 取出下一个待发送字节
+ * @param  byte: 输出的待发送字节
+ * @return 1: 取到字节, 0: 日志已发完 (此时应关闭 TXE 中断)
+ */
+uint8_t OTA_DebugTxTask(uint8_t *byte);
+
+/**
+ * @brief  获取一段连续的待发送日志 (使用 DMA 发送时代替 OTA_DebugTxTask)
+ * @param  buf: 输出的数据起始指针
+ * @return 连续可发送的字节数, 0 表示日志已发完
+ */
+uint16_t OTA_DebugTxGetBlock(const uint8_t **buf);
+
+/**
+ * @brief  调试串口 DMA 发送完成回调
+ *         须在 DMA 已标记为空闲之后调用: 缓冲区中仍有日志时其中会再次调用 OTA_DebugTxStart() 续发
+ * @param  len: 本次发送的字节数 (即 OTA_DebugTxGetBlock 的返回值)
+ */
+void OTA_DebugTxBlockDone(uint16_t len);
+
 #endif
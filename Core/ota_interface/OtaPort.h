@@ -25,26 +25,53 @@ uint8_t OTA_ShouldEnterIap(void);
 void OTA_PeripheralsDeInit(void);
 
 /**
- * @brief  解锁 Flash 写入权限
+ * @brief  解锁 Flash 写入权限 (OTA_DUAL_BANK 时两个 Bank 均需解锁)
  * @return 1: 成功, 0: 失败
  */
 uint8_t OTA_FlashUnlock(void);
 
 /**
- * @brief  上锁 Flash 写入权限
+ * @brief  上锁 Flash 写入权限 (OTA_DUAL_BANK 时两个 Bank 均需上锁)
  * @return 1: 成功, 0: 失败
  */
 uint8_t OTA_FlashLock(void);
 
 /**
  * @brief  擦除指定地址所在的 Flash 页
+ *         OTA_DUAL_BANK 时按 OTA_FLASH_BANK_OF(addr) 选择对应 Bank 的控制寄存器;
+ *         OTA_RAMFUNC_ENABLE 时实现须加 OTA_RAMFUNC 修饰，且等待 BSY 的循环不得调用 Flash 中的函数
  * @param  addr: 目标页地址
  * @return 0: 成功, 其他: 失败
  */
 int OTA_ErasePage(uint32_t addr);
 
+/**
+ * @brief  启动擦除指定地址所在的 Flash 页后立即返回 (非阻塞，OTA_FLASH_ERASE_AHEAD 使用)
+ *         调用前 Flash 已解锁; OTA_RAMFUNC_ENABLE 时须加 OTA_RAMFUNC 修饰
+ * @param  addr: 目标页地址
+ * @return 0: 已启动, 其他: 失败
+ */
+int OTA_EraseStart(uint32_t addr);
+
+/**
+ * @brief  查询 Flash 控制器是否忙 (BSY 标志，或由 EOP 中断维护的标志)
+ *         OTA_RAMFUNC_ENABLE 时须加 OTA_RAMFUNC 修饰
+ * @param  addr: 正在擦除的页地址，OTA_DUAL_BANK 时据此选择 Bank
+ * @return 1: 忙, 0: 空闲
+ */
+uint8_t OTA_FlashIsBusy(uint32_t addr);
+
+/**
+ * @brief  结束一次由 OTA_EraseStart 启动的擦除 (清除擦除模式并检查错误标志)
+ *         在 OTA_FlashIsBusy 返回 0 后调用; OTA_RAMFUNC_ENABLE 时须加 OTA_RAMFUNC 修饰
+ * @param  addr: 擦除的页地址，OTA_DUAL_BANK 时据此选择 Bank
+ * @return 0: 擦除成功, 其他: 失败
+ */
+int OTA_EraseComplete(uint32_t addr);
+
 /**
  * @brief  写入半字数据到 Flash
+ *         Bank 选择及 OTA_RAMFUNC_ENABLE 时的要求同 OTA_ErasePage
  * @param  addr: 目标地址
  * @param  data: 16位数据
  * @return 0: 成功, 其他: 失败
@@ -67,14 +94,18 @@ void OTA_DrvRead(uint32_t addr, uint8_t *buf, uint16_t len);
 uint8_t OTA_SendByte(uint8_t byte);
 
 /**
- * @brief  发送调试信息 (例如字符串日志)
- * @param  data: 字符串指针
- * @return 1: 成功, 0: 失败
+ * @brief  启动调试信息发送
+ *         日志写入环形缓冲区后被调用 (可能处于中断上下文)，实现中不得阻塞：
+ *         使能调试串口 TXE 中断，并在中断中调用 OTA_DebugTxTask() 逐字节取数，
+ *         或在 DMA 空闲时用 OTA_DebugTxGetBlock() 启动一次 DMA 发送 (DMA 忙时直接返回);
+ *         DMA 发送完成中断中先标记 DMA 空闲，再调用 OTA_DebugTxBlockDone()，剩余日志由其续发;
+ *         OTA_LogFlush() 会在等待循环中反复调用本函数，须可重入地忽略发送中的调用
  */
-uint8_t OTA_DebugSend(const char *data);
+void OTA_DebugTxStart(void);
 
 /**
  * @brief  从传输缓冲区读取一个字节
+ *         默认实现读取 OTA_ReceiveTask 写入的接收环形缓冲区
  * @return 接收到的字节
  */
 uint8_t OTA_TransReadByte(void);
@@ -86,8 +117,69 @@ uint8_t OTA_TransReadByte(void);
 uint8_t OTA_IsTransEmpty(void);
 
 /**
- * @brief  毫秒级延时函数
+ * @brief  喂看门狗
+ *         IAP 模式下由调度器每毫秒调用一次，未使用看门狗时留空即可
+ */
+void OTA_WatchdogFeed(void);
+
+/**
+ * @brief  初始化毫秒时基 (例如将 SysTick 配置为 1ms 中断)
+ *         OTA_Run 开始时调用一次; 跳转 App 前 SysTick 会被关闭
+ */
+void OTA_TimebaseInit(void);
+
+/**
+ * @brief  获取单调递增的毫秒计数 (允许 32 位回绕)
+ *         可能在中断上下文中调用
+ * @return 当前毫秒计数
+ */
+uint32_t OTA_GetTickMs(void);
+
+/**
+ * @brief  切换到高性能时钟配置 (PLL 最高频率 + 匹配的 Flash 等待周期 + 预取缓冲)
+ *         OTA_Run 开始时、OTA_TimebaseInit 之前调用一次，使校验与接收提交全程运行在最高主频;
+ *         切换后须更新 SystemCoreClock，并按新的总线时钟重新设置串口波特率
+ */
+void OTA_ClockHighPerf(void);
+
+/**
+ * @brief  将时钟树恢复为复位默认状态 (HSI、关闭 PLL、Flash 等待周期归零)
+ *         OTA_JumpToApp 中关中断、关 SysTick 后调用，使 App 的 SystemInit 与冷启动时行为一致
+ */
+void OTA_ClockRestore(void);
+
+/**
+ * @brief  控制外部 SPI NOR 的片选 (OTA_EXT_STAGING 使用)
+ * @param  sel: 1-拉低片选开始一次传输, 0-拉高片选结束传输
+ */
+void OTA_SpiSelect(uint8_t sel);
+
+/**
+ * @brief  SPI 全双工收发一个字节 (OTA_EXT_STAGING 使用)
+ * @param  byte: 发送的字节
+ * @return 同时收到的字节
+ */
+uint8_t OTA_SpiTransfer(uint8_t byte);
+
+/**
+ * @brief  SPI 连续收发一段数据 (OTA_EXT_STAGING 使用)，返回前传输须已完成
+ *         可用 DMA 实现以减少逐字节等待; 未使用 DMA 时循环调用 OTA_SpiTransfer 即可
+ * @param  tx: 发送数据，为 NULL 时发送 0xFF
+ * @param  rx: 接收缓冲区，为 NULL 时丢弃收到的数据
+ * @param  len: 传输长度
+ */
+void OTA_SpiTransferBlock(const uint8_t *tx, uint8_t *rx, uint32_t len);
+
+/**
+ * @brief  用硬件 AES 对整分组数据做 AES-128-CTR 加解密 (OTA_AES_HW 使用)，返回前须已完成
+ *         每个分组后计数块的低 32 位 (大端) 加 1，与 STM32F4 CRYP 的 AES-CTR 模式一致;
+ *         数据量通常为一包 (8 个分组)，可用 DMA 在 IN/OUT FIFO 与缓冲区之间搬运
+ * @param  key: 16 字节密钥 (同一次接收中不变，实现可缓存以免重复装载)
+ * @param  ctr: 16 字节初始计数块
+ * @param  in: 输入数据
+ * @param  out: 输出数据，可与 in 相同
+ * @param  blocks: 分组数
  */
-void OTA_Delay1ms(void);
+void OTA_AesHwCtr(const uint8_t *key, const uint8_t *ctr, const uint8_t *in, uint8_t *out, uint32_t blocks);
 
 #endif
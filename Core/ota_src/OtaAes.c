@@ -0,0 +1,261 @@
+/**
+ ******************************************************************************
+ * @file    OtaAes.c
+ * @author  MiniOTA Team
+ * @brief   AES-128-CTR 流式解密实现
+ *          CTR 模式只用到分组加密。软件实现面向 Cortex-M3: 每轮 16 次查表，
+ *          四个 T 表互为字节循环移位，只在 Flash 中保存 Te0 (1KB)，其余由 ROR 得到，
+ *          ROR 可并入 EOR 的移位操作数，不增加指令; S 盒取自 Te0 的中间字节，不另建表。
+ *          OTA_AES_HW 时整分组交给 OTA_AesHwCtr (如 STM32F4 的 CRYP)，不编译查表实现
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 MiniOTA.
+ * All rights reserved.
+ *
+ ******************************************************************************
+ */
+
+#include "OtaInterface.h"
+#include "OtaUtils.h"
+#include "OtaProf.h"
+#include "OtaAes.h"
+#if OTA_AES_HW
+#include "OtaPort.h"
+#endif
+
+#define AES_GET32(p)        (((uint32_t)(p)[0] << 24) | ((uint32_t)(p)[1] << 16) | \
+                             ((uint32_t)(p)[2] << 8) | (uint32_t)(p)[3])
+#define AES_PUT32(p, v)     do { (p)[0] = (uint8_t)((v) >> 24); (p)[1] = (uint8_t)((v) >> 16); \
+                                 (p)[2] = (uint8_t)((v) >> 8); (p)[3] = (uint8_t)(v); } while (0)
+
+#if !OTA_AES_HW
+/** Te0[x] = {2·S(x), S(x), S(x), 3·S(x)} (大端); Te1..Te3 为其依次循环右移 8 位 */
+static const uint32_t aes_te0[256] =
+{
+    0xC66363A5UL, 0xF87C7C84UL, 0xEE777799UL, 0xF67B7B8DUL, 0xFFF2F20DUL, 0xD66B6BBDUL, 0xDE6F6FB1UL, 0x91C5C554UL,
+    0x60303050UL, 0x02010103UL, 0xCE6767A9UL, 0x562B2B7DUL, 0xE7FEFE19UL, 0xB5D7D762UL, 0x4DABABE6UL, 0xEC76769AUL,
+    0x8FCACA45UL, 0x1F82829DUL, 0x89C9C940UL, 0xFA7D7D87UL, 0xEFFAFA15UL, 0xB25959EBUL, 0x8E4747C9UL, 0xFBF0F00BUL,
+    0x41ADADECUL, 0xB3D4D467UL, 0x5FA2A2FDUL, 0x45AFAFEAUL, 0x239C9CBFUL, 0x53A4A4F7UL, 0xE4727296UL, 0x9BC0C05BUL,
+    0x75B7B7C2UL, 0xE1FDFD1CUL, 0x3D9393AEUL, 0x4C26266AUL, 0x6C36365AUL, 0x7E3F3F41UL, 0xF5F7F702UL, 0x83CCCC4FUL,
+    0x6834345CUL, 0x51A5A5F4UL, 0xD1E5E534UL, 0xF9F1F108UL, 0xE2717193UL, 0xABD8D873UL, 0x62313153UL, 0x2A15153FUL,
+    0x0804040CUL, 0x95C7C752UL, 0x46232365UL, 0x9DC3C35EUL, 0x30181828UL, 0x379696A1UL, 0x0A05050FUL, 0x2F9A9AB5UL,
+    0x0E070709UL, 0x24121236UL, 0x1B80809BUL, 0xDFE2E23DUL, 0xCDEBEB26UL, 0x4E272769UL, 0x7FB2B2CDUL, 0xEA75759FUL,
+    0x1209091BUL, 0x1D83839EUL, 0x582C2C74UL, 0x341A1A2EUL, 0x361B1B2DUL, 0xDC6E6EB2UL, 0xB45A5AEEUL, 0x5BA0A0FBUL,
+    0xA45252F6UL, 0x763B3B4DUL, 0xB7D6D661UL, 0x7DB3B3CEUL, 0x5229297BUL, 0xDDE3E33EUL, 0x5E2F2F71UL, 0x13848497UL,
+    0xA65353F5UL, 0xB9D1D168UL, 0x00000000UL, 0xC1EDED2CUL, 0x40202060UL, 0xE3FCFC1FUL, 0x79B1B1C8UL, 0xB65B5BEDUL,
+    0xD46A6ABEUL, 0x8DCBCB46UL, 0x67BEBED9UL, 0x7239394BUL, 0x944A4ADEUL, 0x984C4CD4UL, 0xB05858E8UL, 0x85CFCF4AUL,
+    0xBBD0D06BUL, 0xC5EFEF2AUL, 0x4FAAAAE5UL, 0xEDFBFB16UL, 0x864343C5UL, 0x9A4D4DD7UL, 0x66333355UL, 0x11858594UL,
+    0x8A4545CFUL, 0xE9F9F910UL, 0x04020206UL, 0xFE7F7F81UL, 0xA05050F0UL, 0x783C3C44UL, 0x259F9FBAUL, 0x4BA8A8E3UL,
+    0xA25151F3UL, 0x5DA3A3FEUL, 0x804040C0UL, 0x058F8F8AUL, 0x3F9292ADUL, 0x219D9DBCUL, 0x70383848UL, 0xF1F5F504UL,
+    0x63BCBCDFUL, 0x77B6B6C1UL, 0xAFDADA75UL, 0x42212163UL, 0x20101030UL, 0xE5FFFF1AUL, 0xFDF3F30EUL, 0xBFD2D26DUL,
+    0x81CDCD4CUL, 0x180C0C14UL, 0x26131335UL, 0xC3ECEC2FUL, 0xBE5F5FE1UL, 0x359797A2UL, 0x884444CCUL, 0x2E171739UL,
+    0x93C4C457UL, 0x55A7A7F2UL, 0xFC7E7E82UL, 0x7A3D3D47UL, 0xC86464ACUL, 0xBA5D5DE7UL, 0x3219192BUL, 0xE6737395UL,
+    0xC06060A0UL, 0x19818198UL, 0x9E4F4FD1UL, 0xA3DCDC7FUL, 0x44222266UL, 0x542A2A7EUL, 0x3B9090ABUL, 0x0B888883UL,
+    0x8C4646CAUL, 0xC7EEEE29UL, 0x6BB8B8D3UL, 0x2814143CUL, 0xA7DEDE79UL, 0xBC5E5EE2UL, 0x160B0B1DUL, 0xADDBDB76UL,
+    0xDBE0E03BUL, 0x64323256UL, 0x743A3A4EUL, 0x140A0A1EUL, 0x924949DBUL, 0x0C06060AUL, 0x4824246CUL, 0xB85C5CE4UL,
+    0x9FC2C25DUL, 0xBDD3D36EUL, 0x43ACACEFUL, 0xC46262A6UL, 0x399191A8UL, 0x319595A4UL, 0xD3E4E437UL, 0xF279798BUL,
+    0xD5E7E732UL, 0x8BC8C843UL, 0x6E373759UL, 0xDA6D6DB7UL, 0x018D8D8CUL, 0xB1D5D564UL, 0x9C4E4ED2UL, 0x49A9A9E0UL,
+    0xD86C6CB4UL, 0xAC5656FAUL, 0xF3F4F407UL, 0xCFEAEA25UL, 0xCA6565AFUL, 0xF47A7A8EUL, 0x47AEAEE9UL, 0x10080818UL,
+    0x6FBABAD5UL, 0xF0787888UL, 0x4A25256FUL, 0x5C2E2E72UL, 0x381C1C24UL, 0x57A6A6F1UL, 0x73B4B4C7UL, 0x97C6C651UL,
+    0xCBE8E823UL, 0xA1DDDD7CUL, 0xE874749CUL, 0x3E1F1F21UL, 0x964B4BDDUL, 0x61BDBDDCUL, 0x0D8B8B86UL, 0x0F8A8A85UL,
+    0xE0707090UL, 0x7C3E3E42UL, 0x71B5B5C4UL, 0xCC6666AAUL, 0x904848D8UL, 0x06030305UL, 0xF7F6F601UL, 0x1C0E0E12UL,
+    0xC26161A3UL, 0x6A35355FUL, 0xAE5757F9UL, 0x69B9B9D0UL, 0x17868691UL, 0x99C1C158UL, 0x3A1D1D27UL, 0x279E9EB9UL,
+    0xD9E1E138UL, 0xEBF8F813UL, 0x2B9898B3UL, 0x22111133UL, 0xD26969BBUL, 0xA9D9D970UL, 0x078E8E89UL, 0x339494A7UL,
+    0x2D9B9BB6UL, 0x3C1E1E22UL, 0x15878792UL, 0xC9E9E920UL, 0x87CECE49UL, 0xAA5555FFUL, 0x50282878UL, 0xA5DFDF7AUL,
+    0x038C8C8FUL, 0x59A1A1F8UL, 0x09898980UL, 0x1A0D0D17UL, 0x65BFBFDAUL, 0xD7E6E631UL, 0x844242C6UL, 0xD06868B8UL,
+    0x824141C3UL, 0x299999B0UL, 0x5A2D2D77UL, 0x1E0F0F11UL, 0x7BB0B0CBUL, 0xA85454FCUL, 0x6DBBBBD6UL, 0x2C16163AUL,
+};
+
+#define AES_ROR(x, n)       (((x) >> (n)) | ((x) << (32U - (n))))
+/** S 盒: Te0 的第 2、3 字节均为 S(x) */
+#define AES_SBOX(x)         ((aes_te0[(x)] >> 8) & 0xFFU)
+
+/** 一列的 SubBytes + ShiftRows + MixColumns + AddRoundKey */
+#define AES_ROUND_COL(a, b, c, d, k)                                            \
+    (aes_te0[(a) >> 24] ^ AES_ROR(aes_te0[((b) >> 16) & 0xFFU], 8U) ^         \
+     AES_ROR(aes_te0[((c) >> 8) & 0xFFU], 16U) ^ AES_ROR(aes_te0[(d) & 0xFFU], 24U) ^ (k))
+
+/** 最后一轮没有 MixColumns: 从 Te0 中按位置取出 S(x) */
+#define AES_FINAL_COL(a, b, c, d, k)                                            \
+    (((aes_te0[(a) >> 24] << 8) & 0xFF000000UL) ^ (aes_te0[((b) >> 16) & 0xFFU] & 0x00FF0000UL) ^ \
+     (aes_te0[((c) >> 8) & 0xFFU] & 0x0000FF00UL) ^ ((aes_te0[(d) & 0xFFU] >> 8) & 0x000000FFUL) ^ (k))
+
+/**
+ * @brief  展开 AES-128 轮密钥
+ * @param  rk: 输出 44 个字的轮密钥
+ * @param  key: 16 字节密钥
+ */
+static void Aes_KeyExpand(uint32_t rk[44], const uint8_t key[OTA_AES_KEY_SIZE])
+{
+    uint32_t rcon = 0x01U;
+    uint32_t t;
+
+    for (uint32_t i = 0; i < 4U; i++)
+    {
+        rk[i] = AES_GET32(&key[i * 4U]);
+    }
+    for (uint32_t i = 4U; i < 44U; i++)
+    {
+        t = rk[i - 1U];
+        if ((i & 3U) == 0)
+        {
+            // RotWord + SubWord + Rcon
+            t = (AES_SBOX((t >> 16) & 0xFFU) << 24) ^ (AES_SBOX((t >> 8) & 0xFFU) << 16) ^
+                (AES_SBOX(t & 0xFFU) << 8) ^ AES_SBOX(t >> 24) ^ (rcon << 24);
+            rcon = (rcon << 1) ^ ((rcon & 0x80U) ? 0x11BU : 0U);
+        }
+        rk[i] = rk[i - 4U] ^ t;
+    }
+}
+
+/**
+ * @brief  加密一个分组 (状态按大端读出的 4 个字)
+ * @param  rk: 轮密钥
+ * @param  in: 输入分组
+ * @param  out: 输出 16 字节
+ */
+static void Aes_Encrypt(const uint32_t rk[44], const uint32_t in[4], uint8_t out[OTA_AES_BLOCK_SIZE])
+{
+    uint32_t s0 = in[0] ^ rk[0];
+    uint32_t s1 = in[1] ^ rk[1];
+    uint32_t s2 = in[2] ^ rk[2];
+    uint32_t s3 = in[3] ^ rk[3];
+    uint32_t t0, t1, t2, t3;
+
+    for (uint32_t r = 1U; r < 10U; r++)
+    {
+        rk += 4;
+        t0 = AES_ROUND_COL(s0, s1, s2, s3, rk[0]);
+        t1 = AES_ROUND_COL(s1, s2, s3, s0, rk[1]);
+        t2 = AES_ROUND_COL(s2, s3, s0, s1, rk[2]);
+        t3 = AES_ROUND_COL(s3, s0, s1, s2, rk[3]);
+        s0 = t0; s1 = t1; s2 = t2; s3 = t3;
+    }
+    rk += 4;
+    t0 = AES_FINAL_COL(s0, s1, s2, s3, rk[0]);
+    t1 = AES_FINAL_COL(s1, s2, s3, s0, rk[1]);
+    t2 = AES_FINAL_COL(s2, s3, s0, s1, rk[2]);
+    t3 = AES_FINAL_COL(s3, s0, s1, s2, rk[3]);
+    AES_PUT32(&out[0], t0);
+    AES_PUT32(&out[4], t1);
+    AES_PUT32(&out[8], t2);
+    AES_PUT32(&out[12], t3);
+}
+#endif
+
+#if OTA_AES_HW
+/**
+ * @brief  输出第 idx 个分组的计数块
+ * @param  pCtx: 解密上下文
+ * @param  idx: 分组序号
+ * @param  block: 输出 16 字节计数块
+ */
+static void Aes_Counter(const OTA_AES_CTR_CTX_E *pCtx, uint32_t idx, uint8_t block[OTA_AES_BLOCK_SIZE])
+{
+    AES_PUT32(&block[0], pCtx->ctr[0]);
+    AES_PUT32(&block[4], pCtx->ctr[1]);
+    AES_PUT32(&block[8], pCtx->ctr[2]);
+    AES_PUT32(&block[12], pCtx->ctr[3] + idx);
+}
+#endif
+
+/**
+ * @brief  计算第 idx 个分组的密钥流，存入 pCtx->ks
+ * @param  pCtx: 解密上下文
+ * @param  idx: 分组序号
+ */
+static void Aes_Keystream(OTA_AES_CTR_CTX_E *pCtx, uint32_t idx)
+{
+#if OTA_AES_HW
+    uint8_t block[OTA_AES_BLOCK_SIZE];
+
+    // 加密全 0 分组得到的就是密钥流
+    Aes_Counter(pCtx, idx, block);
+    OTA_MemSet(pCtx->ks, 0, sizeof(pCtx->ks));
+    OTA_AesHwCtr(pCtx->key, block, pCtx->ks, pCtx->ks, 1U);
+#else
+    uint32_t block[4];
+
+    block[0] = pCtx->ctr[0];
+    block[1] = pCtx->ctr[1];
+    block[2] = pCtx->ctr[2];
+    block[3] = pCtx->ctr[3] + idx;
+    Aes_Encrypt(pCtx->rk, block, pCtx->ks);
+#endif
+    pCtx->ks_idx   = idx;
+    pCtx->ks_valid = OTA_TRUE;
+}
+
+/**
+ * @brief  开始解密: 展开密钥并记录初始计数块
+ * @param  pCtx: 解密上下文
+ * @param  key: 16 字节密钥
+ * @param  iv: 16 字节初始计数块
+ */
+void OTA_AesCtrInit(OTA_AES_CTR_CTX_E *pCtx, const uint8_t key[OTA_AES_KEY_SIZE], const uint8_t iv[OTA_AES_BLOCK_SIZE])
+{
+#if OTA_AES_HW
+    OTA_MemCopy(pCtx->key, key, OTA_AES_KEY_SIZE);
+#else
+    Aes_KeyExpand(pCtx->rk, key);
+#endif
+    for (uint32_t i = 0; i < 4U; i++)
+    {
+        pCtx->ctr[i] = AES_GET32(&iv[i * 4U]);
+    }
+    pCtx->ks_valid = OTA_FALSE;
+}
+
+/**
+ * @brief  对固件体中偏移 off 起的 len 字节做 CTR 变换
+ * @param  pCtx: 解密上下文
+ * @param  off: 数据在固件体中的偏移
+ * @param  in: 输入
+ * @param  out: 输出，可与 in 相同
+ * @param  len: 数据长度
+ */
+void OTA_AesCtrXor(OTA_AES_CTR_CTX_E *pCtx, uint32_t off, const uint8_t *in, uint8_t *out, uint32_t len)
+{
+    uint32_t idx = off / OTA_AES_BLOCK_SIZE;
+    uint32_t pos = off % OTA_AES_BLOCK_SIZE;
+    uint32_t n;
+#if OTA_AES_HW
+    uint8_t  block[OTA_AES_BLOCK_SIZE];
+#endif
+
+    OTA_PROF_BEGIN(OTA_PROF_AES_CTR);
+    while (len > 0)
+    {
+#if OTA_AES_HW
+        // 整分组由硬件直接加解密，不经过 ks
+        if (pos == 0 && len >= OTA_AES_BLOCK_SIZE)
+        {
+            n = len & ~(OTA_AES_BLOCK_SIZE - 1U);
+            Aes_Counter(pCtx, idx, block);
+            OTA_AesHwCtr(pCtx->key, block, in, out, n / OTA_AES_BLOCK_SIZE);
+            idx += n / OTA_AES_BLOCK_SIZE;
+            in  += n;
+            out += n;
+            len -= n;
+            continue;
+        }
+#endif
+        // 包边界落在分组中间时，前后两包共用同一个分组的密钥流
+        if (pCtx->ks_valid != OTA_TRUE || pCtx->ks_idx != idx)
+        {
+            Aes_Keystream(pCtx, idx);
+        }
+        n = (OTA_AES_BLOCK_SIZE - pos < len) ? OTA_AES_BLOCK_SIZE - pos : len;
+        for (uint32_t i = 0; i < n; i++)
+        {
+            out[i] = in[i] ^ pCtx->ks[pos + i];
+        }
+        idx++;
+        pos  = 0;
+        in  += n;
+        out += n;
+        len -= n;
+    }
+    OTA_PROF_END(OTA_PROF_AES_CTR);
+}
@@ -0,0 +1,61 @@
+/**
+ ******************************************************************************
+ * @file    OtaAes.h
+ * @author  MiniOTA Team
+ * @brief   AES-128-CTR 流式解密头文件 (FIPS 197 / SP 800-38A)
+ *          CTR 模式加解密相同，按固件体内的偏移随机访问: 偏移 off 处的字节使用
+ *          第 off / 16 个计数块的密钥流，分段固件与修复流可按各自的偏移解密
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 MiniOTA.
+ * All rights reserved.
+ *
+ ******************************************************************************
+ */
+
+#ifndef OTAAES_H
+#define OTAAES_H
+
+#include "OtaInterface.h"
+#include "OtaUtils.h"
+
+#define OTA_AES_KEY_SIZE        16U     /**< 密钥长度 (字节) */
+#define OTA_AES_BLOCK_SIZE      16U     /**< 分组长度 (字节)，也是初始计数块的长度 */
+
+/**
+ * @brief AES-128-CTR 解密上下文
+ *        第 n 个分组的计数块: 初始计数块的低 32 位 (大端) 加 n，高 96 位不变 (与 STM32 CRYP 的计数方式一致)
+ */
+typedef struct __OTA_AES_CTR_CTX
+{
+#if OTA_AES_HW
+    uint8_t  key[OTA_AES_KEY_SIZE];     /**< 密钥，每次调用 OTA_AesHwCtr 时传入 */
+#else
+    uint32_t rk[44];                    /**< 轮密钥 */
+#endif
+    uint32_t ctr[4];                    /**< 初始计数块 (按大端读出的 4 个字) */
+    uint32_t ks_idx;                    /**< ks 对应的分组序号 */
+    OTA_BOOL ks_valid;                  /**< ks 有效 */
+    uint8_t  ks[OTA_AES_BLOCK_SIZE];    /**< 最近一个分组的密钥流 (包边界落在分组中间时复用) */
+} OTA_AES_CTR_CTX_E;
+
+/**
+ * @brief  开始解密: 展开密钥并记录初始计数块
+ * @param  pCtx: 解密上下文
+ * @param  key: 16 字节密钥
+ * @param  iv: 16 字节初始计数块
+ */
+void OTA_AesCtrInit(OTA_AES_CTR_CTX_E *pCtx, const uint8_t key[OTA_AES_KEY_SIZE], const uint8_t iv[OTA_AES_BLOCK_SIZE]);
+
+/**
+ * @brief  对固件体中偏移 off 起的 len 字节做 CTR 变换 (加解密相同)，可按任意顺序、任意长度调用
+ * @param  pCtx: 解密上下文
+ * @param  off: 数据在固件体中的偏移
+ * @param  in: 输入 (密文)
+ * @param  out: 输出 (明文)，可与 in 相同
+ * @param  len: 数据长度
+ */
+void OTA_AesCtrXor(OTA_AES_CTR_CTX_E *pCtx, uint32_t off, const uint8_t *in, uint8_t *out, uint32_t len);
+
+#endif
@@ -0,0 +1,247 @@
+/**
+ ******************************************************************************
+ * @file    OtaApp.c
+ * @author  MiniOTA Team
+ * @brief   App 侧 MiniOTA 库实现
+ *          运行中的应用在空闲时分步擦除非激活插槽，或在后台接收固件写入非激活插槽，
+ *          下一次复位时由 Bootloader 校验并切换
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 MiniOTA.
+ * All rights reserved.
+ *
+ ******************************************************************************
+ */
+
+#include "OtaInterface.h"
+#include "OtaPort.h"
+#include "OtaUtils.h"
+#include "OtaMeta.h"
+#include "OtaFlash.h"
+#include "OtaBdev.h"
+#include "OtaXmodem.h"
+#include "OtaSched.h"
+#include "OtaReloc.h"
+#include "OtaImage.h"
+#include "OtaApp.h"
+
+/** 预擦除游标: 下一个待检查的页地址，0 表示尚未开始 */
+static uint32_t pre_erase_addr;
+
+/** 后台升级代理状态 */
+static OTA_APP_AGENT_STATE_E agent_state;
+
+/** 后台升级代理的目标插槽 */
+static OTA_ACIVE_SLOT_E agent_slot;
+
+/** 后台升级代理任务表: 与 Bootloader 的 IAP 任务表相同的接收/提交流水线 */
+static const OTA_SCHED_TASK agent_tasks[] = {
+    { OTA_EVT_RX,    OTA_XmodemRxTask     },
+    { OTA_EVT_FLASH, OTA_XmodemCommitTask },
+    { OTA_EVT_TICK,  OTA_XmodemTickTask   },
+    { OTA_EVT_TICK,  OTA_FlashPoll        },
+};
+
+/**
+ * @brief  检查一个擦除单元是否已为擦除状态 (内部或外部 Flash)
+ * @param  addr: 起始地址
+ * @param  len: 长度
+ * @return OTA_TRUE: 全为 0xFF
+ */
+static OTA_BOOL App_IsBlank(uint32_t addr, uint32_t len)
+{
+    uint32_t buf[16];
+
+    for (uint32_t off = 0; off < len; off += sizeof(buf))
+    {
+        OTA_BdevRead(addr + off, (uint8_t *)buf, sizeof(buf));
+        for (uint32_t i = 0; i < sizeof(buf) / 4; i++)
+        {
+            if (buf[i] != 0xFFFFFFFFUL)
+            {
+                return OTA_FALSE;
+            }
+        }
+    }
+    return OTA_TRUE;
+}
+
+/**
+ * @brief  在空闲时分步擦除下一次升级的目标插槽
+ *         每次调用最多运行 budget_ms (以页为粒度，单页擦除本身不可打断)，
+ *         全部擦除后在 Meta 中记录 pre_erased，Bootloader 进入 IAP 时跳过擦除;
+ *         已是空白的页直接跳过，不重复擦除
+ * @param  budget_ms: 本次调用的时间预算(ms)
+ * @return 预擦除进度
+ */
+OTA_APP_PRE_ERASE_E OTA_AppPreErase(uint32_t budget_ms)
+{
+    OTA_META_DATA_E meta;
+    OTA_ACIVE_SLOT_E slot;
+    uint32_t slot_end;
+    uint32_t unit;
+    uint32_t start = OTA_GetTickMs();
+
+    // 压缩备份模式下新固件覆盖正在运行的 Slot A，只能由 Bootloader 接收
+    if (OTA_BACKUP_COMPRESSED || OTA_MetaLoad(&meta) != OTA_TRUE)
+    {
+        return OTA_PRE_ERASE_ERR;
+    }
+
+    slot = OTA_MetaGetIapSlot(&meta);
+    if (meta.pre_erased == slot)
+    {
+        return OTA_PRE_ERASE_DONE;
+    }
+
+    slot_end = OTA_MetaSlotAddr(slot) + OTA_MetaSlotSize(slot);
+    if (pre_erase_addr < OTA_MetaSlotAddr(slot) || pre_erase_addr > slot_end)
+    {
+        pre_erase_addr = OTA_MetaSlotAddr(slot);
+    }
+
+    while (pre_erase_addr < slot_end)
+    {
+        if ((OTA_GetTickMs() - start) >= budget_ms)
+        {
+            return OTA_PRE_ERASE_BUSY;
+        }
+
+        // 按所在块设备的擦除单元推进 (外部 SPI NOR 为 4KB 扇区，内部 Flash 为页)
+        unit = OTA_BdevEraseSize(pre_erase_addr);
+        if (App_IsBlank(pre_erase_addr, unit) != OTA_TRUE)
+        {
+            if (OTA_BdevErase(pre_erase_addr) != 0)
+            {
+                return OTA_PRE_ERASE_ERR;
+            }
+        }
+        pre_erase_addr += unit;
+    }
+
+    // 擦除期间其他代码可能更新过 Meta，记录前重新确认目标插槽
+    if (OTA_MetaLoad(&meta) != OTA_TRUE || OTA_MetaGetIapSlot(&meta) != slot)
+    {
+        pre_erase_addr = 0;
+        return OTA_PRE_ERASE_BUSY;
+    }
+
+    meta.pre_erased = slot;
+    if (OTA_MetaSave(&meta) != 0)
+    {
+        return OTA_PRE_ERASE_ERR;
+    }
+    return OTA_PRE_ERASE_DONE;
+}
+
+/**
+ * @brief  启动后台升级代理
+ *         在 App 运行期间通过 Xmodem 接收固件并写入非激活插槽;
+ *         启动后串口接收中断须调用 OTA_ReceiveTask()
+ * @return 0: 成功, 1: Meta 无效、Meta 写入失败或处于 OTA_BACKUP_COMPRESSED 模式
+ */
+int OTA_AppAgentStart(void)
+{
+    OTA_META_DATA_E meta;
+    uint32_t addr;
+    OTA_BOOL pre_erased;
+    OTA_BOOL save = OTA_FALSE;
+
+    // 压缩备份模式下新固件覆盖正在运行的 Slot A，只能由 Bootloader 接收
+    if (OTA_BACKUP_COMPRESSED || OTA_MetaLoad(&meta) != OTA_TRUE)
+    {
+        agent_state = OTA_AGENT_FAILED;
+        return 1;
+    }
+
+    agent_slot = OTA_MetaGetIapSlot(&meta);
+    addr = OTA_MetaSlotAddr(agent_slot);
+    // 预擦除标记只使用一次: 接收开始后插槽不再空白，本次传输中断时之后的会话 (代理或 Bootloader) 不能再信任该标记
+    pre_erased = (meta.pre_erased == agent_slot) ? OTA_TRUE : OTA_FALSE;
+    if (pre_erased == OTA_TRUE)
+    {
+        meta.pre_erased = OTA_PRE_ERASED_NONE;
+        save = OTA_TRUE;
+    }
+#if OTA_SIG_ENABLE
+    // 插槽即将被改写，清除签名的已验证记录
+    if (OTA_MetaIsVerified(&meta, agent_slot) == OTA_TRUE)
+    {
+        OTA_MetaSetVerified(&meta, agent_slot, OTA_FALSE);
+        save = OTA_TRUE;
+    }
+#endif
+    // Meta 写入会占用 Flash 页镜像，须在 OTA_XmodemInit 之前完成
+    if (save == OTA_TRUE && OTA_MetaSave(&meta) != 0)
+    {
+        agent_state = OTA_AGENT_FAILED;
+        return 1;
+    }
+    OTA_XmodemInit(addr);
+    OTA_ImageStreamInit(agent_slot);
+    if (pre_erased == OTA_TRUE)
+    {
+        OTA_FlashSetErased(addr, OTA_MetaSlotSize(agent_slot));
+    }
+    agent_state = OTA_AGENT_RUNNING;
+    return 0;
+}
+
+/**
+ * @brief  推进后台升级代理 (在 App 主循环或 RTOS 任务中周期调用，不会睡眠)
+ *         每次调用最多提交一页 Flash (已预擦除时只有编程时间)，其余时间立即返回
+ * @return 代理状态
+ */
+OTA_APP_AGENT_STATE_E OTA_AppAgentPoll(void)
+{
+    OTA_META_DATA_E meta;
+
+    if (agent_state != OTA_AGENT_RUNNING)
+    {
+        return agent_state;
+    }
+
+    OTA_SchedPoll(agent_tasks, sizeof(agent_tasks) / sizeof(agent_tasks[0]));
+
+    if (OTA_XmodemRevCompFlag() == REC_FLAG_FINISH)
+    {
+        OTA_FlashWaitIdle();
+        OTA_XmodemReportStats();
+        // 固件完整性由 Bootloader 在下次复位时校验，失败则回退到当前插槽
+#if OTA_RELOC_ENABLE
+        if (OTA_RelocApply(agent_slot) != 0)
+        {
+            agent_state = OTA_AGENT_FAILED;
+            return agent_state;
+        }
+#endif
+        if (OTA_MetaLoad(&meta) != OTA_TRUE)
+        {
+            agent_state = OTA_AGENT_FAILED;
+            return agent_state;
+        }
+        OTA_MetaMarkPending(&meta, agent_slot);
+#if OTA_SIG_ENABLE
+        OTA_MetaSetVerified(&meta, agent_slot, OTA_ImageStreamSigned());
+#endif
+        agent_state = (OTA_MetaSave(&meta) == 0) ? OTA_AGENT_DONE : OTA_AGENT_FAILED;
+    }
+    else if (OTA_XmodemRevCompFlag() == REC_FLAG_INT)
+    {
+        OTA_FlashWaitIdle();
+        OTA_XmodemReportStats();
+        agent_state = OTA_AGENT_FAILED;
+    }
+
+    return agent_state;
+}
+
+/**
+ * @brief  获取后台升级代理状态
+ * @return 代理状态
+ */
+OTA_APP_AGENT_STATE_E OTA_AppAgentGetState(void)
+{
+    return agent_state;
+}
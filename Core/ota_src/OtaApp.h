@@ -0,0 +1,75 @@
+/**
+ ******************************************************************************
+ * @file    OtaApp.h
+ * @author  MiniOTA Team
+ * @brief   App 侧 MiniOTA 库头文件
+ *          由应用程序链接 (与 OtaXmodem.c、OtaFlash.c、OtaMeta.c、OtaSched.c、OtaLog.c、
+ *          OtaUtils.c 及应用的 OtaPort 实现一起)，
+ *          与 Bootloader 使用同一份 OtaInterface.h，双方对分区布局的理解一致
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 MiniOTA.
+ * All rights reserved.
+ *
+ ******************************************************************************
+ */
+
+#ifndef OTAAPP_H
+#define OTAAPP_H
+
+#include "OtaInterface.h"
+
+/**
+ * @brief 预擦除进度
+ */
+typedef enum __OTA_APP_PRE_ERASE
+{
+    OTA_PRE_ERASE_DONE = 0,   /**< 目标插槽已全部擦除，且已记录到 Meta */
+    OTA_PRE_ERASE_BUSY,       /**< 本次时间预算用完，下次空闲时继续 */
+    OTA_PRE_ERASE_ERR         /**< Meta 无效、擦除失败或处于 OTA_BACKUP_COMPRESSED 模式 */
+} OTA_APP_PRE_ERASE_E;
+
+/**
+ * @brief  在空闲时分步擦除下一次升级的目标插槽
+ *         每次调用最多运行 budget_ms (以页为粒度，单页擦除本身不可打断)，
+ *         全部擦除后在 Meta 中记录 pre_erased，Bootloader 进入 IAP 时跳过擦除;
+ *         已是空白的页直接跳过，不重复擦除
+ * @param  budget_ms: 本次调用的时间预算(ms)
+ * @return 预擦除进度
+ */
+OTA_APP_PRE_ERASE_E OTA_AppPreErase(uint32_t budget_ms);
+
+/**
+ * @brief 后台升级代理状态
+ */
+typedef enum __OTA_APP_AGENT_STATE
+{
+    OTA_AGENT_IDLE = 0,       /**< 未启动 */
+    OTA_AGENT_RUNNING,        /**< 正在等待/接收固件 */
+    OTA_AGENT_DONE,           /**< 接收完成，目标插槽已标记为待确认，复位后生效 */
+    OTA_AGENT_FAILED          /**< 传输中断或 Meta 写入失败 */
+} OTA_APP_AGENT_STATE_E;
+
+/**
+ * @brief  启动后台升级代理
+ *         在 App 运行期间通过 Xmodem 接收固件并写入非激活插槽;
+ *         启动后串口接收中断须调用 OTA_ReceiveTask()
+ * @return 0: 成功, 1: Meta 无效、Meta 写入失败或处于 OTA_BACKUP_COMPRESSED 模式
+ */
+int OTA_AppAgentStart(void);
+
+/**
+ * @brief  推进后台升级代理 (在 App 主循环或 RTOS 任务中周期调用，不会睡眠)
+ *         每次调用最多提交一页 Flash (已预擦除时只有编程时间)，其余时间立即返回
+ * @return 代理状态
+ */
+OTA_APP_AGENT_STATE_E OTA_AppAgentPoll(void);
+
+/**
+ * @brief  获取后台升级代理状态
+ * @return 代理状态
+ */
+OTA_APP_AGENT_STATE_E OTA_AppAgentGetState(void);
+
+#endif
@@ -0,0 +1,366 @@
+/**
+ ******************************************************************************
+ * @file    OtaBackup.c
+ * @author  MiniOTA Team
+ * @brief   压缩备份分区实现
+ *          LZ77 贪心压缩，序列采用 LZ4 风格的编码:
+ *          token(字面量长度高4位 | 匹配长度-4 低4位) + 扩展长度 + 字面量 + 2字节偏移 + 扩展长度，
+ *          最后一个序列只有字面量。压缩时以 Flash 中的原始固件作为滑动窗口，
+ *          只需一张哈希表; 解压时匹配源为已写入 Slot A 的数据或当前页镜像
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 MiniOTA.
+ * All rights reserved.
+ *
+ ******************************************************************************
+ */
+
+#include "OtaInterface.h"
+#include "OtaPort.h"
+#include "OtaUtils.h"
+#include "OtaFlash.h"
+#include "OtaBdev.h"
+#include "OtaMeta.h"
+#include "OtaLog.h"
+#include "OtaBackup.h"
+
+#define LZ_MIN_MATCH        4U          /**< 最短匹配长度 */
+#define LZ_MAX_OFFSET       0xFFFFU     /**< 最大匹配距离 */
+
+/** 压缩器哈希表: 4 字节序列 -> 最近出现位置 + 1 (0 表示空) */
+static uint32_t lz_hash[1U << OTA_LZ_HASH_BITS];
+
+/** 输出写入位置 (相对于目标插槽起始) 及上限 */
+static uint32_t lz_out;
+static uint32_t lz_out_max;
+
+/** 解压目标 Slot A 的起始地址 */
+static uint32_t lz_dst;
+
+/**
+ * @brief  向 Flash 页镜像输出一个字节，页满时写入
+ * @return 0: 成功, 1: 超出上限或写入失败
+ */
+static int Lz_Put(uint8_t byte)
+{
+    uint16_t offset = OTA_FlashGetPageOffset();
+
+    if (lz_out >= lz_out_max)
+    {
+        return 1;
+    }
+    OTA_FlashGetMirr()[offset++] = byte;
+    lz_out++;
+    if (offset == OTA_FLASH_PAGE_SIZE)
+    {
+        return OTA_FlashWrite();
+    }
+    OTA_FlashSetPageOffset(offset);
+    return 0;
+}
+
+/**
+ * @brief  写回页镜像中剩余的数据
+ * @return 0: 成功, 1: 写入失败
+ */
+static int Lz_Flush(void)
+{
+    return (OTA_FlashGetPageOffset() > 0) ? OTA_FlashWrite() : 0;
+}
+
+/**
+ * @brief  输出扩展长度 (255 连续累加)
+ */
+static int Lz_PutLen(uint32_t len)
+{
+    while (len >= 255U)
+    {
+        if (Lz_Put(255U) != 0)
+        {
+            return 1;
+        }
+        len -= 255U;
+    }
+    return Lz_Put((uint8_t)len);
+}
+
+/**
+ * @brief  读取源数据中的 4 字节
+ */
+static uint32_t Lz_Read32(uint32_t addr)
+{
+    uint32_t v;
+
+    OTA_BdevRead(addr, (uint8_t *)&v, sizeof(v));
+    return v;
+}
+
+/**
+ * @brief  输出一个序列: 字面量 [lit_addr, lit_addr + lit_len) 后跟一个匹配 (match_len 为 0 表示最后一个序列)
+ * @return 0: 成功, 1: 失败
+ */
+static int Lz_PutSeq(uint32_t lit_addr, uint32_t lit_len, uint16_t dist, uint32_t match_len)
+{
+    uint8_t  buf[32];
+    uint32_t ml = (match_len > 0) ? (match_len - LZ_MIN_MATCH) : 0;
+    uint8_t  token = (uint8_t)(((lit_len < 15U) ? lit_len : 15U) << 4) | (uint8_t)((ml < 15U) ? ml : 15U);
+
+    if (Lz_Put(token) != 0 || (lit_len >= 15U && Lz_PutLen(lit_len - 15U) != 0))
+    {
+        return 1;
+    }
+    while (lit_len > 0)
+    {
+        uint32_t chunk = (lit_len > sizeof(buf)) ? sizeof(buf) : lit_len;
+        OTA_BdevRead(lit_addr, buf, chunk);
+        for (uint32_t i = 0; i < chunk; i++)
+        {
+            if (Lz_Put(buf[i]) != 0)
+            {
+                return 1;
+            }
+        }
+        lit_addr += chunk;
+        lit_len  -= chunk;
+    }
+    if (match_len == 0)
+    {
+        return 0;
+    }
+    if (Lz_Put((uint8_t)dist) != 0 || Lz_Put((uint8_t)(dist >> 8)) != 0)
+    {
+        return 1;
+    }
+    return (ml >= 15U) ? Lz_PutLen(ml - 15U) : 0;
+}
+
+/**
+ * @brief  Slot B 中是否已是 Slot A 当前固件的备份
+ * @param  raw_size: Slot A 中需要备份的字节数 (固件头 + 固件)
+ * @return OTA_TRUE: 大小与 CRC 一致，无需重新压缩
+ */
+OTA_BOOL OTA_BackupIsCurrent(uint32_t raw_size)
+{
+    OTA_BACKUP_HEADER_E header;
+
+    OTA_BdevRead(OTA_MetaSlotAddr(SLOT_B), (uint8_t *)&header, sizeof(header));
+    return (header.magic == OTA_BACKUP_MAGIC && header.raw_size == raw_size &&
+            header.raw_crc16 == OTA_BdevCrc16(OTA_MetaSlotAddr(SLOT_A), raw_size)) ? OTA_TRUE : OTA_FALSE;
+}
+
+/**
+ * @brief  将 Slot A 中的固件压缩保存到 Slot B
+ * @param  raw_size: Slot A 中需要备份的字节数 (固件头 + 固件)
+ * @return 0: 成功, 1: 压缩后放不下或写入失败
+ */
+int OTA_BackupSave(uint32_t raw_size)
+{
+    OTA_BACKUP_HEADER_E header;
+    uint32_t src = OTA_MetaSlotAddr(SLOT_A);
+    uint32_t pos = 0;
+    uint32_t anchor = 0;
+
+    if (raw_size > OTA_MetaSlotSize(SLOT_A))
+    {
+        return 1;
+    }
+
+    OTA_MemSet((uint8_t *)&header, 0xFF, sizeof(header));
+    header.magic     = OTA_BACKUP_MAGIC;
+    header.raw_size  = raw_size;
+    header.raw_crc16 = OTA_BdevCrc16(src, raw_size);
+
+    OTA_MemSet((uint8_t *)lz_hash, 0, sizeof(lz_hash));
+    OTA_FlashHandleInit(OTA_MetaSlotAddr(SLOT_B));
+    lz_out = 0;
+    lz_out_max = OTA_MetaSlotSize(SLOT_B);
+    for (uint32_t i = 0; i < sizeof(header); i++)
+    {
+        Lz_Put(((const uint8_t *)&header)[i]);
+    }
+
+    while (pos + LZ_MIN_MATCH <= raw_size)
+    {
+        uint32_t seq  = Lz_Read32(src + pos);
+        uint32_t h    = (uint32_t)(seq * 2654435761U) >> (32 - OTA_LZ_HASH_BITS);
+        uint32_t cand = lz_hash[h];
+
+        lz_hash[h] = pos + 1U;
+        if (cand != 0 && pos - (cand - 1U) <= LZ_MAX_OFFSET && Lz_Read32(src + cand - 1U) == seq)
+        {
+            uint32_t match = cand - 1U;
+            uint32_t len = LZ_MIN_MATCH;
+            uint8_t  a[16];
+            uint8_t  b[16];
+
+            // 按块比较延长匹配
+            while (pos + len < raw_size)
+            {
+                uint32_t chunk = raw_size - (pos + len);
+                uint32_t i;
+
+                if (chunk > sizeof(a))
+                {
+                    chunk = sizeof(a);
+                }
+                OTA_BdevRead(src + match + len, a, chunk);
+                OTA_BdevRead(src + pos + len, b, chunk);
+                for (i = 0; i < chunk && a[i] == b[i]; i++)
+                {
+                }
+                len += i;
+                if (i < chunk)
+                {
+                    break;
+                }
+            }
+
+            if (Lz_PutSeq(src + anchor, pos - anchor, (uint16_t)(pos - match), len) != 0)
+            {
+                return 1;
+            }
+            pos += len;
+            anchor = pos;
+            OTA_WatchdogFeed();
+        }
+        else
+        {
+            pos++;
+        }
+    }
+
+    if (Lz_PutSeq(src + anchor, raw_size - anchor, 0, 0) != 0 || Lz_Flush() != 0)
+    {
+        return 1;
+    }
+    OTA_LOGI_HEX(BACKUP_DONE, lz_out);
+    return 0;
+}
+
+/** 解压输入: 压缩数据的分块读取缓冲 */
+static struct
+{
+    uint32_t addr;          /**< 下一块的读取地址 */
+    uint8_t  pos;           /**< 当前块内的读取位置 */
+    uint8_t  buf[64];       /**< 当前块 */
+} lz_in;
+
+/**
+ * @brief  读取一个压缩数据字节
+ */
+static uint8_t Lz_Get(void)
+{
+    if (lz_in.pos >= sizeof(lz_in.buf))
+    {
+        OTA_BdevRead(lz_in.addr, lz_in.buf, sizeof(lz_in.buf));
+        lz_in.addr += sizeof(lz_in.buf);
+        lz_in.pos = 0;
+    }
+    return lz_in.buf[lz_in.pos++];
+}
+
+/**
+ * @brief  读取扩展长度
+ */
+static uint32_t Lz_GetLen(uint32_t len)
+{
+    uint8_t b;
+
+    do
+    {
+        b = Lz_Get();
+        len += b;
+    } while (b == 255U);
+    return len;
+}
+
+/**
+ * @brief  读取已解压输出中的一个字节 (当前页镜像中或已写入 Slot A)
+ * @param  pos: 相对于 Slot A 起始的位置
+ */
+static uint8_t Lz_OutByte(uint32_t pos)
+{
+    uint32_t page_start = OTA_FlashGetCurAddr() - lz_dst;
+    uint8_t  b;
+
+    if (pos >= page_start)
+    {
+        return OTA_FlashGetMirr()[pos - page_start];
+    }
+    OTA_BdevRead(lz_dst + pos, &b, 1);
+    return b;
+}
+
+/**
+ * @brief  将 Slot B 中的压缩备份解压回 Slot A
+ * @return 0: 成功, 1: 备份无效或写入失败
+ */
+int OTA_BackupRestore(void)
+{
+    OTA_BACKUP_HEADER_E header;
+
+    OTA_BdevRead(OTA_MetaSlotAddr(SLOT_B), (uint8_t *)&header, sizeof(header));
+    if (header.magic != OTA_BACKUP_MAGIC || header.raw_size > OTA_MetaSlotSize(SLOT_A))
+    {
+        return 1;
+    }
+
+    lz_dst = OTA_MetaSlotAddr(SLOT_A);
+    lz_in.addr = OTA_MetaSlotAddr(SLOT_B) + sizeof(header);
+    lz_in.pos  = sizeof(lz_in.buf);
+    OTA_FlashHandleInit(lz_dst);
+    lz_out = 0;
+    lz_out_max = header.raw_size;
+
+    while (lz_out < header.raw_size)
+    {
+        uint8_t  token = Lz_Get();
+        uint32_t len = token >> 4;
+        uint32_t dist;
+
+        if (len == 15U)
+        {
+            len = Lz_GetLen(len);
+        }
+        while (len-- > 0)
+        {
+            if (Lz_Put(Lz_Get()) != 0)
+            {
+                return 1;
+            }
+        }
+        if (lz_out >= header.raw_size)
+        {
+            break;
+        }
+
+        dist  = Lz_Get();
+        dist |= (uint32_t)Lz_Get() << 8;
+        len   = token & 0x0FU;
+        if (len == 15U)
+        {
+            len = Lz_GetLen(len);
+        }
+        len += LZ_MIN_MATCH;
+        if (dist == 0 || dist > lz_out)
+        {
+            return 1;
+        }
+        while (len-- > 0)
+        {
+            if (Lz_Put(Lz_OutByte(lz_out - dist)) != 0)
+            {
+                return 1;
+            }
+        }
+        OTA_WatchdogFeed();
+    }
+
+    if (Lz_Flush() != 0 || OTA_BdevCrc16(lz_dst, header.raw_size) != header.raw_crc16)
+    {
+        return 1;
+    }
+    OTA_LOGI_HEX(BACKUP_RESTORED, header.raw_size);
+    return 0;
+}
@@ -0,0 +1,60 @@
+/**
+ ******************************************************************************
+ * @file    OtaBackup.h
+ * @author  MiniOTA Team
+ * @brief   压缩备份分区头文件
+ *          升级前将 Slot A 中的固件以 LZ77 压缩保存到 Slot B，回滚时解压回 Slot A
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 MiniOTA.
+ * All rights reserved.
+ *
+ ******************************************************************************
+ */
+
+#ifndef OTABACKUP_H
+#define OTABACKUP_H
+
+#include "OtaInterface.h"
+#include "OtaUtils.h"
+
+#define OTA_BACKUP_MAGIC    0x435A4C42  /**< "BLZC" - 压缩备份头魔数 */
+
+/** 压缩器哈希表位数: 表占用 4 << OTA_LZ_HASH_BITS 字节 RAM */
+#ifndef OTA_LZ_HASH_BITS
+#define OTA_LZ_HASH_BITS    10
+#endif
+
+/**
+ * @brief 压缩备份头部结构 (放在 Slot B 的头部，其后为压缩数据)
+ */
+typedef struct __OTA_BACKUP_HEADER
+{
+    uint32_t magic;         /**< OTA_BACKUP_MAGIC */
+    uint32_t raw_size;      /**< 解压后大小 (固件头 + 固件) */
+    uint16_t raw_crc16;     /**< 解压后数据的 CRC16 */
+    uint8_t  reserved[6];   /**< 保留字段，保证结构体16字节对齐 */
+} OTA_BACKUP_HEADER_E;
+
+/**
+ * @brief  Slot B 中是否已是 Slot A 当前固件的备份
+ * @param  raw_size: Slot A 中需要备份的字节数 (固件头 + 固件)
+ * @return OTA_TRUE: 大小与 CRC 一致，无需重新压缩
+ */
+OTA_BOOL OTA_BackupIsCurrent(uint32_t raw_size);
+
+/**
+ * @brief  将 Slot A 中的固件压缩保存到 Slot B
+ * @param  raw_size: Slot A 中需要备份的字节数 (固件头 + 固件)
+ * @return 0: 成功, 1: 压缩后放不下或写入失败
+ */
+int OTA_BackupSave(uint32_t raw_size);
+
+/**
+ * @brief  将 Slot B 中的压缩备份解压回 Slot A
+ * @return 0: 成功 (解压数据 CRC 一致), 1: 备份无效或写入失败
+ */
+int OTA_BackupRestore(void);
+
+#endif
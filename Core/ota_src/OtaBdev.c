@@ -0,0 +1,370 @@
+/**
+ ******************************************************************************
+ * @file    OtaBdev.c
+ * @author  MiniOTA Team
+ * @brief   块设备存储抽象实现
+ *          内部 Flash 通过端口层接口访问，外部 SPI NOR 通过 OtaSpiNor 访问，
+ *          RAM 设备直接读写内存; 非内存映射设备的读取经过一行预读缓存
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 MiniOTA.
+ * All rights reserved.
+ *
+ ******************************************************************************
+ */
+
+#include "OtaInterface.h"
+#include "OtaPort.h"
+#include "OtaUtils.h"
+#include "OtaSpiNor.h"
+#include "OtaBdev.h"
+
+/**
+ * @brief  内部 Flash: 读取
+ */
+static void Bdev_IntRead(uint32_t off, uint8_t *buf, uint32_t len)
+{
+    while (len > 0)
+    {
+        uint16_t chunk = (len > 0x8000U) ? 0x8000U : (uint16_t)len;
+        OTA_DrvRead(OTA_FLASH_START_ADDRESS + off, buf, chunk);
+        off += chunk;
+        buf += chunk;
+        len -= chunk;
+    }
+}
+
+/**
+ * @brief  内部 Flash: 按半字编程
+ */
+static int Bdev_IntProg(uint32_t off, const uint8_t *buf, uint32_t len)
+{
+    int ret = 0;
+
+    if (OTA_FlashUnlock() != 0)
+    {
+        return 1;
+    }
+    for (uint32_t i = 0; i + 1 < len; i += 2)
+    {
+        uint16_t hw = buf[i] | (buf[i + 1] << 8);
+        if (OTA_DrvProgramHalfword(OTA_FLASH_START_ADDRESS + off + i, hw) != 0)
+        {
+            ret = 1;
+            break;
+        }
+    }
+    OTA_FlashLock();
+    return ret;
+}
+
+/**
+ * @brief  内部 Flash: 擦除一页
+ */
+static int Bdev_IntErase(uint32_t off)
+{
+    int ret;
+
+    if (OTA_FlashUnlock() != 0)
+    {
+        return 1;
+    }
+    ret = OTA_ErasePage(OTA_FLASH_START_ADDRESS + off);
+    OTA_FlashLock();
+    return (ret != 0) ? 1 : 0;
+}
+
+/** 内部 Flash 块设备 */
+static const OTA_BDEV bdev_internal = {
+    OTA_FLASH_START_ADDRESS, OTA_FLASH_SIZE, 2U, OTA_FLASH_PAGE_SIZE,
+    (const uint8_t *)OTA_FLASH_START_ADDRESS,
+    Bdev_IntRead, Bdev_IntProg, Bdev_IntErase
+};
+
+#if OTA_EXT_STAGING
+/**
+ * @brief  外部 SPI NOR: 擦除一个扇区
+ */
+static int Bdev_NorErase(uint32_t off)
+{
+    return OTA_SpiNorEraseSector(off);
+}
+
+/** 外部 SPI NOR 块设备 (不可直接按地址读取) */
+static const OTA_BDEV bdev_spi_nor = {
+    OTA_EXT_FLASH_BASE, OTA_SPI_NOR_MAX_SIZE, 1U, OTA_SPI_NOR_SECTOR_SIZE,
+    0,
+    OTA_SpiNorRead, OTA_SpiNorWrite, Bdev_NorErase
+};
+#endif
+
+/** RAM 块设备的内存起始地址 */
+static uint8_t *ram_mem;
+
+/**
+ * @brief  RAM: 读取
+ */
+static void Bdev_RamRead(uint32_t off, uint8_t *buf, uint32_t len)
+{
+    OTA_MemCopy(buf, ram_mem + off, len);
+}
+
+/**
+ * @brief  RAM: 编程
+ */
+static int Bdev_RamProg(uint32_t off, const uint8_t *buf, uint32_t len)
+{
+    OTA_MemCopy(ram_mem + off, buf, len);
+    return 0;
+}
+
+/**
+ * @brief  RAM: 按 Flash 页大小擦除为 0xFF
+ */
+static int Bdev_RamErase(uint32_t off)
+{
+    OTA_MemSet(ram_mem + off / OTA_FLASH_PAGE_SIZE * OTA_FLASH_PAGE_SIZE, 0xFF, OTA_FLASH_PAGE_SIZE);
+    return 0;
+}
+
+/** RAM 块设备，由 OTA_BdevRamAttach 设置范围 */
+static OTA_BDEV bdev_ram = {
+    0, 0, 1U, OTA_FLASH_PAGE_SIZE,
+    0,
+    Bdev_RamRead, Bdev_RamProg, Bdev_RamErase
+};
+
+#if OTA_BDEV_CACHE_SIZE
+/** 预读缓存: 缓存非内存映射设备上最近读取位置之后的一段数据 */
+static struct
+{
+    const OTA_BDEV *dev;                    /**< 缓存所属设备，NULL 表示无效 */
+    uint32_t off;                           /**< 缓存数据在设备中的偏移 */
+    uint32_t len;                           /**< 缓存数据长度 */
+    uint8_t  buf[OTA_BDEV_CACHE_SIZE];      /**< 缓存数据 */
+} bdev_cache;
+#endif
+
+/**
+ * @brief  地址是否位于设备范围内
+ */
+static OTA_BOOL Bdev_Contains(const OTA_BDEV *dev, uint32_t addr)
+{
+    return (dev->size != 0 && addr >= dev->base && addr - dev->base < dev->size) ? OTA_TRUE : OTA_FALSE;
+}
+
+/**
+ * @brief  查找地址所在的块设备
+ * @param  addr: 目标地址
+ * @return 块设备，地址不属于任何设备时为 NULL
+ */
+const OTA_BDEV *OTA_BdevFind(uint32_t addr)
+{
+    if (Bdev_Contains(&bdev_ram, addr))
+    {
+        return &bdev_ram;
+    }
+    if (Bdev_Contains(&bdev_internal, addr))
+    {
+        return &bdev_internal;
+    }
+#if OTA_EXT_STAGING
+    if (Bdev_Contains(&bdev_spi_nor, addr))
+    {
+        return &bdev_spi_nor;
+    }
+#endif
+    return 0;
+}
+
+/**
+ * @brief  地址是否位于内部 Flash
+ * @param  addr: 目标地址
+ * @return OTA_TRUE: 内部 Flash
+ */
+OTA_BOOL OTA_BdevIsInternal(uint32_t addr)
+{
+    return (OTA_BdevFind(addr) == &bdev_internal) ? OTA_TRUE : OTA_FALSE;
+}
+
+/**
+ * @brief  读取数据
+ * @param  addr: 起始地址
+ * @param  buf: 目标缓冲区
+ * @param  len: 读取长度
+ * @return 0: 成功, 1: 地址无效
+ */
+int OTA_BdevRead(uint32_t addr, uint8_t *buf, uint32_t len)
+{
+    const OTA_BDEV *dev = OTA_BdevFind(addr);
+    uint32_t off;
+
+    if (dev == 0 || len > dev->size - (addr - dev->base))
+    {
+        OTA_MemSet(buf, 0xFF, len);
+        return 1;
+    }
+    off = addr - dev->base;
+
+#if OTA_BDEV_CACHE_SIZE
+    if (dev->map == 0)
+    {
+        while (len > 0)
+        {
+            uint32_t chunk;
+
+            if (bdev_cache.dev == dev && off >= bdev_cache.off && off - bdev_cache.off < bdev_cache.len)
+            {
+                // 命中: 从缓存中取出尽可能多的数据
+                chunk = bdev_cache.len - (off - bdev_cache.off);
+                if (chunk > len)
+                {
+                    chunk = len;
+                }
+                OTA_MemCopy(buf, &bdev_cache.buf[off - bdev_cache.off], chunk);
+            }
+            else if (len >= OTA_BDEV_CACHE_SIZE)
+            {
+                // 大块读取不经过缓存
+                dev->read(off, buf, len);
+                return 0;
+            }
+            else
+            {
+                // 未命中: 从当前位置起预读一整行
+                bdev_cache.dev = dev;
+                bdev_cache.off = off;
+                bdev_cache.len = dev->size - off;
+                if (bdev_cache.len > OTA_BDEV_CACHE_SIZE)
+                {
+                    bdev_cache.len = OTA_BDEV_CACHE_SIZE;
+                }
+                dev->read(off, bdev_cache.buf, bdev_cache.len);
+                continue;
+            }
+            off += chunk;
+            buf += chunk;
+            len -= chunk;
+        }
+        return 0;
+    }
+#endif
+
+    dev->read(off, buf, len);
+    return 0;
+}
+
+/**
+ * @brief  编程数据
+ * @param  addr: 起始地址
+ * @param  buf: 源数据
+ * @param  len: 写入长度
+ * @return 0: 成功, 1: 失败
+ */
+int OTA_BdevProgram(uint32_t addr, const uint8_t *buf, uint32_t len)
+{
+    const OTA_BDEV *dev = OTA_BdevFind(addr);
+
+    if (dev == 0 || len > dev->size - (addr - dev->base))
+    {
+        return 1;
+    }
+#if OTA_BDEV_CACHE_SIZE
+    if (bdev_cache.dev == dev)
+    {
+        bdev_cache.dev = 0;
+    }
+#endif
+    return (dev->prog(addr - dev->base, buf, len) != 0) ? 1 : 0;
+}
+
+/**
+ * @brief  擦除地址所在的擦除单元
+ * @param  addr: 目标地址
+ * @return 0: 成功, 1: 失败
+ */
+int OTA_BdevErase(uint32_t addr)
+{
+    const OTA_BDEV *dev = OTA_BdevFind(addr);
+
+    if (dev == 0)
+    {
+        return 1;
+    }
+#if OTA_BDEV_CACHE_SIZE
+    if (bdev_cache.dev == dev)
+    {
+        bdev_cache.dev = 0;
+    }
+#endif
+    return (dev->erase(addr - dev->base) != 0) ? 1 : 0;
+}
+
+/**
+ * @brief  获取地址所在设备的擦除单元大小
+ * @param  addr: 目标地址
+ * @return 擦除单元(字节)
+ */
+uint32_t OTA_BdevEraseSize(uint32_t addr)
+{
+    const OTA_BDEV *dev = OTA_BdevFind(addr);
+
+    return (dev != 0) ? dev->erase_size : OTA_FLASH_PAGE_SIZE;
+}
+
+/**
+ * @brief  计算一段数据的 CRC16
+ * @param  addr: 起始地址
+ * @param  len: 数据长度
+ * @return CRC16 校验值
+ */
+uint16_t OTA_BdevCrc16(uint32_t addr, uint32_t len)
+{
+    return OTA_BdevUpdateCrc16(0, addr, len);
+}
+
+/**
+ * @brief  分段计算一段数据的 CRC16
+ * @param  crc: 上一段的计算结果，首段传 0
+ * @param  addr: 起始地址
+ * @param  len: 数据长度
+ * @return 累计的 CRC16 校验值
+ */
+uint16_t OTA_BdevUpdateCrc16(uint16_t crc, uint32_t addr, uint32_t len)
+{
+    const OTA_BDEV *dev = OTA_BdevFind(addr);
+    uint8_t  buf[64];
+
+    if (dev != 0 && dev->map != 0 && len <= dev->size - (addr - dev->base))
+    {
+        return OTA_UpdateCrc16(crc, dev->map + (addr - dev->base), len);
+    }
+
+    while (len > 0)
+    {
+        uint32_t chunk = (len > sizeof(buf)) ? sizeof(buf) : len;
+        OTA_BdevRead(addr, buf, chunk);
+        crc = OTA_UpdateCrc16(crc, buf, chunk);
+        addr += chunk;
+        len  -= chunk;
+    }
+    return crc;
+}
+
+/**
+ * @brief  挂接 RAM 块设备
+ * @param  mem: 内存起始地址，为 NULL 时卸载
+ * @param  base: 在 MiniOTA 地址空间中的起始地址
+ * @param  size: 容量(字节)
+ */
+void OTA_BdevRamAttach(uint8_t *mem, uint32_t base, uint32_t size)
+{
+    ram_mem        = mem;
+    bdev_ram.base  = base;
+    bdev_ram.size  = (mem != 0) ? size : 0;
+    bdev_ram.map   = mem;
+#if OTA_BDEV_CACHE_SIZE
+    bdev_cache.dev = 0;
+#endif
+}
@@ -0,0 +1,117 @@
+/**
+ ******************************************************************************
+ * @file    OtaBdev.h
+ * @author  MiniOTA Team
+ * @brief   块设备存储抽象头文件
+ *          插槽的读、编程、擦除统一按地址查找块设备后访问，
+ *          后端包括内部 Flash、外部 SPI NOR 及 RAM (主机仿真或 RAM 缓冲)
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 MiniOTA.
+ * All rights reserved.
+ *
+ ******************************************************************************
+ */
+
+#ifndef OTABDEV_H
+#define OTABDEV_H
+
+#include "OtaInterface.h"
+#include "OtaUtils.h"
+
+/** @defgroup OTA_Bdev_Handle
+ * @{
+ */
+/**
+ * @brief 块设备描述结构体 (偏移均相对于 base)
+ */
+typedef struct __OTA_BDEV
+{
+    uint32_t base;          /**< 在 MiniOTA 地址空间中的起始地址 */
+    uint32_t size;          /**< 容量(字节) */
+    uint32_t prog_size;     /**< 最小编程单元(字节) */
+    uint32_t erase_size;    /**< 擦除单元(字节) */
+    const uint8_t *map;     /**< 可直接按指针读取时为数据起始地址，否则为 NULL (读取经过预读缓存) */
+    void (*read)(uint32_t off, uint8_t *buf, uint32_t len);         /**< 读取 */
+    int  (*prog)(uint32_t off, const uint8_t *buf, uint32_t len);   /**< 编程 (目标已擦除)，0 成功 */
+    int  (*erase)(uint32_t off);                                    /**< 擦除 off 所在的擦除单元，0 成功 */
+} OTA_BDEV;
+/**
+ * @}
+ */
+
+/**
+ * @brief  查找地址所在的块设备
+ *         RAM 设备优先，其次内部 Flash、外部 SPI NOR
+ * @param  addr: 目标地址
+ * @return 块设备，地址不属于任何设备时为 NULL
+ */
+const OTA_BDEV *OTA_BdevFind(uint32_t addr);
+
+/**
+ * @brief  地址是否位于内部 Flash (可使用后台预擦除等内部 Flash 专用路径)
+ * @param  addr: 目标地址
+ * @return OTA_TRUE: 内部 Flash
+ */
+OTA_BOOL OTA_BdevIsInternal(uint32_t addr);
+
+/**
+ * @brief  读取数据 (非内存映射设备经过预读缓存，顺序的小块读取合并为一次设备访问)
+ * @param  addr: 起始地址
+ * @param  buf: 目标缓冲区
+ * @param  len: 读取长度
+ * @return 0: 成功, 1: 地址无效 (buf 填充为 0xFF)
+ */
+int OTA_BdevRead(uint32_t addr, uint8_t *buf, uint32_t len);
+
+/**
+ * @brief  编程数据 (目标区域须已擦除，地址与长度按设备编程单元对齐)
+ * @param  addr: 起始地址
+ * @param  buf: 源数据
+ * @param  len: 写入长度
+ * @return 0: 成功, 1: 失败
+ */
+int OTA_BdevProgram(uint32_t addr, const uint8_t *buf, uint32_t len);
+
+/**
+ * @brief  擦除地址所在的擦除单元
+ * @param  addr: 目标地址
+ * @return 0: 成功, 1: 失败
+ */
+int OTA_BdevErase(uint32_t addr);
+
+/**
+ * @brief  获取地址所在设备的擦除单元大小
+ * @param  addr: 目标地址
+ * @return 擦除单元(字节)，地址无效时为 Flash 页大小
+ */
+uint32_t OTA_BdevEraseSize(uint32_t addr);
+
+/**
+ * @brief  计算一段数据的 CRC16 (内存映射设备直接计算，否则分块读取)
+ * @param  addr: 起始地址
+ * @param  len: 数据长度
+ * @return CRC16 校验值
+ */
+uint16_t OTA_BdevCrc16(uint32_t addr, uint32_t len);
+
+/**
+ * @brief  分段计算一段数据的 CRC16 (需要跳过或替换其中部分数据时使用)
+ * @param  crc: 上一段的计算结果，首段传 0
+ * @param  addr: 起始地址
+ * @param  len: 数据长度
+ * @return 累计的 CRC16 校验值
+ */
+uint16_t OTA_BdevUpdateCrc16(uint16_t crc, uint32_t addr, uint32_t len);
+
+/**
+ * @brief  挂接 RAM 块设备 (覆盖同一地址范围内的其他设备)
+ *         用于主机仿真 (mmap 的文件映射到内部 Flash 地址) 或以 RAM 缓冲作为临时插槽
+ * @param  mem: 内存起始地址，为 NULL 时卸载
+ * @param  base: 在 MiniOTA 地址空间中的起始地址
+ * @param  size: 容量(字节)
+ */
+void OTA_BdevRamAttach(uint8_t *mem, uint32_t base, uint32_t size);
+
+#endif
@@ -18,114 +18,342 @@
 #include "OtaJump.h"
 #include "OtaUtils.h"
 #include "OtaFlash.h"
+#include "OtaFlashIfoDef.h"
+#include "OtaLog.h"
+#include "OtaProf.h"
+#include "OtaSched.h"
+#include "OtaMeta.h"
+#include "OtaSpiNor.h"
+#include "OtaBdev.h"
+#include "OtaBackup.h"
+#include "OtaSwap.h"
+#include "OtaReloc.h"
+#include "OtaImage.h"
+#include "OtaRepair.h"
+#include "OtaSig.h"
 
 /**
- * @brief  验证 App 分区的完整性和有效性
- * @param  slot_addr: 分区起始地址
- * @return 1: 分区有效, 0: 分区无效
+ * @brief  验证固件的完整性和有效性
+ * @param  slot_addr: 分区起始地址 (内部 Flash 或外部暂存分区)
+ * @param  slot_size: 分区大小 (含固件头)
+ * @param  run_slot_addr: 固件运行分区的起始地址 (检查链接地址; 带重定位表的固件按其还原后计算 CRC)
+ * @return 1: 固件有效, 0: 固件无效
  */
-static int Verify_App_Slot(uint32_t slot_addr) {
+static int Verify_App_Image(uint32_t slot_addr, uint32_t slot_size, uint32_t run_slot_addr) {
 	
-    OTA_APP_IMG_HEADER_E *header = (OTA_APP_IMG_HEADER_E*)slot_addr;
+    OTA_IMG_INFO_E info;
 
-    // 1. 检查魔数
-    if (header->magic != APP_MAGIC_NUM) {
+    // 1. 检查魔数与固件头格式 (v1/v2)
+    if (OTA_ImageLoad(slot_addr, &info) != OTA_TRUE) {
         return 0; // 头部无效
     }
 
-    // 2. 简单的范围检查
-    if (header->img_size == 0 || header->img_size > OTA_APP_SLOT_SIZE) {
-        return 0; // 大小异常
+    // 2. 大小、特性与链接地址检查
+    if (OTA_ImageCheck(&info, slot_size, run_slot_addr) != 0) {
+        return 0; // 固件头与分区不匹配
     }
 
-    // 3. 计算固件体的 CRC (注意：固件体紧跟在 Header 后面)
-    const uint8_t *bin_start = (const uint8_t *)(slot_addr + sizeof(OTA_APP_IMG_HEADER_E));
-    uint16_t cal_crc = OTA_GetCrc16(bin_start, header->img_size);
+    // 3. 计算 CRC: v2 固件头的 TLV 扩展区 + 固件体 (固件体紧跟在固件头后面)
+    uint16_t cal_crc = OTA_BdevCrc16(slot_addr + sizeof(OTA_APP_IMG_HEADER_E), info.hdr_len - sizeof(OTA_APP_IMG_HEADER_E));
+#if OTA_RELOC_ENABLE
+    cal_crc = OTA_RelocCrc16(cal_crc, slot_addr + info.hdr_len, info.img_size, OTA_RelocDelta(slot_addr, run_slot_addr));
+#else
+    cal_crc = OTA_BdevUpdateCrc16(cal_crc, slot_addr + info.hdr_len, info.img_size);
+#endif
 
-    if (cal_crc != header->img_crc16) {
+    if (cal_crc != info.img_crc16) {
         return 0; // CRC 校验失败
     }
 
     return 1; // 验证通过
 }
 
+#if OTA_SIG_ENABLE
 /**
- * @brief  将 Meta 信息保存到 Flash 状态区
- * @param  pMeta: 指向 Meta 结构体的指针
+ * @brief  验证插槽中固件的签名，Meta 中已记录为验证通过的插槽直接跳过
+ *         首次验证从插槽读出整个固件体计算摘要，通过后记入 Meta，之后的启动只做 CRC 校验
+ * @param  pMeta: Meta 信息
+ * @param  slot: 插槽
+ * @return 1: 签名有效, 0: 无效
  */
-static void OTA_SaveMeta(OTA_META_DATA_E *pMeta) {
-    uint8_t flashPage[OTA_FLASH_PAGE_SIZE];
-    OTA_MemSet(flashPage, 0xFF, OTA_FLASH_PAGE_SIZE);
-    OTA_MemCopy(flashPage, (uint8_t *)pMeta, sizeof(OTA_META_DATA_E));
-    OTA_FlashSetCurAddr(OTA_META_ADDR);
-    OTA_FlashSetMirr(flashPage, OTA_FLASH_PAGE_SIZE);
-    OTA_FlashWrite();
+static int Verify_App_Sig(OTA_META_DATA_E *pMeta, OTA_ACIVE_SLOT_E slot)
+{
+	if(OTA_MetaIsVerified(pMeta, slot))
+	{
+		return 1;
+	}
+	if(OTA_SigVerifySlot(OTA_MetaSlotAddr(slot)) != 0)
+	{
+		OTA_LOGE_HEX(SIG_BAD, OTA_MetaSlotAddr(slot));
+		return 0;
+	}
+	OTA_LOGI_HEX(SIG_OK, OTA_MetaSlotAddr(slot));
+	OTA_MetaSetVerified(pMeta, slot, OTA_TRUE);
+	OTA_MetaSave(pMeta);
+	return 1;
 }
 
-static void OTA_UpdateMeta(OTA_META_DATA_E *pMeta)
+/**
+ * @brief  即将改写插槽: 把 Meta 中的已验证记录清除并保存，改写中途掉电或固件被拒绝时不会沿用旧的记录
+ * @param  pMeta: Meta 信息
+ * @param  slot: 插槽
+ */
+static void OTA_SigForget(OTA_META_DATA_E *pMeta, OTA_ACIVE_SLOT_E slot)
 {
-	uint8_t isSlotAValid = Verify_App_Slot(OTA_APP_A_ADDR);
-	uint8_t isSlotBValid = Verify_App_Slot(OTA_APP_B_ADDR);
-	
-	/* state = unconfirmed */
-	if(pMeta->slotAStatus == SLOT_STATE_UNCONFIRMED)
+	if(OTA_MetaIsVerified(pMeta, slot))
 	{
-		if(isSlotAValid)
-		{
-			pMeta->slotAStatus = SLOT_STATE_VALID;
-		}
-		else
+		OTA_MetaSetVerified(pMeta, slot, OTA_FALSE);
+		OTA_MetaSave(pMeta);
+	}
+}
+#endif
+
+/**
+ * @brief  验证 App 分区的完整性和有效性
+ *         OTA_REPAIR_ENABLE 时校验失败的分区先按分块 CRC 修复，修复后重新校验;
+ *         OTA_SIG_ENABLE 时 CRC 通过后再验证签名
+ * @param  pMeta: Meta 信息 (记录签名的验证状态)
+ * @param  slot: 插槽 (地址与大小取自分区表或默认布局)
+ * @return 1: 分区有效, 0: 分区无效
+ */
+static int Verify_App_Slot(OTA_META_DATA_E *pMeta, OTA_ACIVE_SLOT_E slot)
+{
+	if(!Verify_App_Image(OTA_MetaSlotAddr(slot), OTA_MetaSlotSize(slot), OTA_ImageRunSlotAddr(slot)))
+	{
+#if OTA_REPAIR_ENABLE
+		if(OTA_RepairSlot(slot) != 0 ||
+		   !Verify_App_Image(OTA_MetaSlotAddr(slot), OTA_MetaSlotSize(slot), OTA_ImageRunSlotAddr(slot)))
 		{
-			pMeta->slotAStatus = SLOT_STATE_INVALID;
+			return 0;
 		}
+#if OTA_SIG_ENABLE
+		// 修复改写了插槽内容，重新验证签名
+		OTA_MetaSetVerified(pMeta, slot, OTA_FALSE);
+#endif
+#else
+		return 0;
+#endif
 	}
+#if OTA_SIG_ENABLE
+	return Verify_App_Sig(pMeta, slot);
+#else
+	(void)pMeta;
+	return 1;
+#endif
+}
+
+/**
+ * @brief  校验待确认的插槽，按结果标记为有效或无效 (仅修改内存中的副本)
+ * @param  pMeta: Meta 信息
+ * @return 状态被修改的插槽数
+ */
+static uint8_t OTA_ConfirmSlots(OTA_META_DATA_E *pMeta)
+{
+	uint8_t slot;
+	uint8_t changed = 0;
 	
-	if(pMeta->slotBStatus == SLOT_STATE_UNCONFIRMED)
+	/* state = unconfirmed，只校验待确认的插槽 */
+	for(slot = 0; slot < OTA_SLOT_NUM; slot++)
 	{
-		if(isSlotBValid)
+		if(pMeta->slot_status[slot] == SLOT_STATE_UNCONFIRMED)
 		{
-			pMeta->slotBStatus = SLOT_STATE_VALID;
-		}
-		else
-		{
-			pMeta->slotBStatus = SLOT_STATE_INVALID;
+			pMeta->slot_status[slot] = Verify_App_Slot(pMeta, (OTA_ACIVE_SLOT_E)slot) ? SLOT_STATE_VALID : SLOT_STATE_INVALID;
+			changed++;
 		}
 	}
+	return changed;
+}
+
+static void OTA_UpdateMeta(OTA_META_DATA_E *pMeta)
+{
+	// 没有状态变化时不重写 Meta 页: 每次擦写都是一个掉电后 Meta 丢失的窗口
+	if(OTA_ConfirmSlots(pMeta) != 0)
+	{
+		OTA_MetaSave(pMeta);
+	}
+}
+
+#if OTA_BACKUP_COMPRESSED
+/**
+ * @brief  覆盖 Slot A 之前将其中已验证的固件压缩保存到 Slot B
+ *         B 已是同一固件的备份时不重复压缩; 压缩期间 B 标记为无效，掉电后不会被误用
+ * @param  pMeta: Meta 信息
+ */
+static void OTA_SaveBackup(OTA_META_DATA_E *pMeta)
+{
+	OTA_IMG_INFO_E info;
+	uint32_t raw_size;
+	
+	if(pMeta->slot_status[SLOT_A] != SLOT_STATE_VALID || OTA_ImageLoad(OTA_MetaSlotAddr(SLOT_A), &info) != OTA_TRUE)
+	{
+		return;
+	}
+	raw_size = info.hdr_len + info.img_size;
+	if(pMeta->slot_status[SLOT_B] == SLOT_STATE_VALID && OTA_BackupIsCurrent(raw_size))
+	{
+		return;
+	}
+	
+	pMeta->slot_status[SLOT_B] = SLOT_STATE_INVALID;
+	OTA_MetaSave(pMeta);
+	if(OTA_BackupSave(raw_size) != 0)
+	{
+		OTA_LOGE(BACKUP_FAIL);
+		return;
+	}
+	pMeta->slot_status[SLOT_B] = SLOT_STATE_VALID;
+	OTA_MetaSave(pMeta);
+}
+
+/**
+ * @brief  Slot A 无效时将压缩备份解压回 Slot A
+ *         解压过程中掉电，下次启动重新解压; 解压后校验失败则放弃该备份
+ * @param  pMeta: Meta 信息
+ * @return 1: 回滚成功, 0: 失败
+ */
+static int OTA_RestoreBackup(OTA_META_DATA_E *pMeta)
+{
+#if OTA_SIG_ENABLE
+	OTA_SigForget(pMeta, SLOT_A);
+#endif
+	if(OTA_BackupRestore() != 0 || !Verify_App_Slot(pMeta, SLOT_A))
+	{
+		OTA_LOGE(RESTORE_FAIL);
+		pMeta->slot_status[SLOT_B] = SLOT_STATE_INVALID;
+		OTA_MetaSave(pMeta);
+		return 0;
+	}
+	pMeta->slot_status[SLOT_A] = SLOT_STATE_VALID;
+	OTA_MetaSave(pMeta);
+	return 1;
+}
+#endif
+
+#if OTA_SWAP_INSTALL
+/**
+ * @brief  交换结束后将交换头中记录的插槽状态写入 Meta，再清除进度页
+ *         交换中途失败或掉电时 Meta 与进度页均保持不变，下次启动从中断处继续;
+ *         待确认的新固件在清除进度页之前校验，之后不再需要写 Meta，
+ *         写 Meta 时掉电总能由进度页中的完成记录重做
+ * @param  pMeta: Meta 信息
+ * @param  ret: OTA_SwapBegin/OTA_SwapRun 的返回值
+ * @return 0: 交换完成, 1: 失败
+ */
+static int OTA_SwapComplete(OTA_META_DATA_E *pMeta, int ret)
+{
+	OTA_SWAP_HEADER_E swap;
+#if OTA_SIG_ENABLE
+	OTA_BOOL verified_a;
+#endif
+	
+	if(ret != 0 || OTA_SwapLoad(&swap) != OTA_TRUE)
+	{
+		OTA_LOGE(SWAP_FAIL);
+		return 1;
+	}
+	pMeta->slot_status[SLOT_A] = swap.a_status;
+	pMeta->slot_status[SLOT_B] = swap.b_status;
+#if OTA_SIG_ENABLE
+	// 两个插槽的内容已互换，签名验证状态随之互换
+	verified_a = OTA_MetaIsVerified(pMeta, SLOT_A);
+	OTA_MetaSetVerified(pMeta, SLOT_A, OTA_MetaIsVerified(pMeta, SLOT_B));
+	OTA_MetaSetVerified(pMeta, SLOT_B, verified_a);
+#endif
+	pMeta->active_slot = SLOT_A;
+	pMeta->pre_erased  = OTA_PRE_ERASED_NONE;
+	OTA_ConfirmSlots(pMeta);
+	OTA_MetaSave(pMeta);
+	OTA_SwapFinish();
+	return 0;
+}
+
+/**
+ * @brief  将 Slot B 中校验通过的新固件交换到 Slot A，A 中的旧固件换到 B 作为回滚备份
+ *         新固件无效时放弃本次升级，继续使用 Slot A
+ * @param  pMeta: Meta 信息 (active_slot 为 SLOT_B 时调用)
+ * @return 0: 安装完成, 1: 失败
+ */
+static int OTA_InstallSwap(OTA_META_DATA_E *pMeta)
+{
+	uint8_t old = pMeta->slot_status[SLOT_A];
 	
-	OTA_SaveMeta(pMeta);
+	if(!Verify_App_Slot(pMeta, SLOT_B))
+	{
+		OTA_LOGE(INSTALL_FAIL);
+		pMeta->slot_status[SLOT_B] = SLOT_STATE_INVALID;
+		pMeta->active_slot = SLOT_A;
+		OTA_MetaSave(pMeta);
+		return 1;
+	}
+	
+	OTA_LOGI(SWAP_START);
+	return OTA_SwapComplete(pMeta, OTA_SwapBegin(SLOT_STATE_UNCONFIRMED,
+	                        (old == SLOT_STATE_UNCONFIRMED) ? SLOT_STATE_INVALID : old));
 }
+#endif
 
+/**
+ * @brief  确定启动目标
+ *         优先启动激活插槽 (待确认的新固件或当前固件)，校验失败时回退到版本号最高的已验证插槽，
+ *         校验失败的插槽标记为无效; 均不可用时启动分区表中的出厂固件
+ * @param  pMeta: Meta 信息
+ * @return 固件头地址，无可用固件时为 U32_INVALID
+ */
 static uint32_t OTA_GetJumpTar(OTA_META_DATA_E *pMeta)
 {
+	const OTA_PART_ENTRY_E *pGolden;
+	OTA_ACIVE_SLOT_E slot = pMeta->active_slot;
+	uint16_t tried = 0;
 	
-	if(pMeta->active_slot == SLOT_A)
+	if(OTA_MetaIsBootable(slot) &&
+	   (pMeta->slot_status[slot] == SLOT_STATE_UNCONFIRMED || pMeta->slot_status[slot] == SLOT_STATE_VALID))
 	{
-		if((pMeta->slotAStatus == SLOT_STATE_UNCONFIRMED || pMeta->slotAStatus == SLOT_STATE_VALID))
+		if(Verify_App_Slot(pMeta, slot))
 		{
-			if(Verify_App_Slot(OTA_APP_A_ADDR))
-			{
-				return OTA_APP_A_ADDR;
-			}
-			else if(pMeta->slotBStatus == SLOT_STATE_VALID)
-			{
-				return OTA_APP_B_ADDR;
-			}
+			return OTA_MetaSlotAddr(slot);
 		}
+		tried |= (uint16_t)(1U << slot);
+		pMeta->slot_status[slot] = SLOT_STATE_INVALID;
+		OTA_MetaSave(pMeta);
 	}
 	
-	if(pMeta->active_slot == SLOT_B)
+#if OTA_BACKUP_COMPRESSED
+	// 新固件校验失败或写入中断: 解压备份回滚
+	if(pMeta->slot_status[SLOT_B] == SLOT_STATE_VALID && OTA_RestoreBackup(pMeta))
 	{
-		if((pMeta->slotBStatus == SLOT_STATE_UNCONFIRMED || pMeta->slotBStatus == SLOT_STATE_VALID))
+		return OTA_MetaSlotAddr(SLOT_A);
+	}
+#elif OTA_SWAP_INSTALL
+	// 新固件校验失败: 将 Slot B 中的旧固件交换回 Slot A
+	if(pMeta->slot_status[SLOT_B] == SLOT_STATE_VALID && Verify_App_Slot(pMeta, SLOT_B))
+	{
+		OTA_LOGI(SWAP_START);
+		if(OTA_SwapComplete(pMeta, OTA_SwapBegin(SLOT_STATE_VALID, SLOT_STATE_INVALID)) == 0 &&
+		   Verify_App_Slot(pMeta, SLOT_A))
 		{
-			if(Verify_App_Slot(OTA_APP_B_ADDR))
-			{
-				return OTA_APP_B_ADDR;
-			}
-			else if(pMeta->slotAStatus == SLOT_STATE_VALID)
-			{
-				return OTA_APP_A_ADDR;
-			}
+			return OTA_MetaSlotAddr(SLOT_A);
+		}
+	}
+#endif
+	
+	// 外部暂存分区与压缩备份分区不可执行，不作为回退目标
+	while((slot = OTA_MetaBestSlot(pMeta, tried)) != OTA_SLOT_NONE)
+	{
+		if(Verify_App_Slot(pMeta, slot))
+		{
+			return OTA_MetaSlotAddr(slot);
 		}
+		tried |= (uint16_t)(1U << slot);
+		pMeta->slot_status[slot] = SLOT_STATE_INVALID;
+		OTA_MetaSave(pMeta);
+	}
+	
+	// 插槽均不可用时启动分区表中的出厂固件
+	pGolden = OTA_PartFind(OTA_PART_ROLE_GOLDEN);
+	if(pGolden != 0 && Verify_App_Image(OTA_PartAddr(pGolden), pGolden->size, OTA_PartAddr(pGolden)))
+	{
+		OTA_LOGI_HEX(GOLDEN_BOOT, OTA_PartAddr(pGolden));
+		return OTA_PartAddr(pGolden);
 	}
 	
 	// 无可用固件
@@ -145,100 +373,260 @@ static uint8_t OTA_IsUserSetingsValid(void)
     if (OTA_TOTAL_START_ADDRESS < OTA_FLASH_START_ADDRESS ||
         OTA_TOTAL_START_ADDRESS > flash_end)
     {
-		OTA_DebugSend("[OTA][Error]:In OtaInterface - The flash space allocated to MiniOTA must be located within the Flash memory..\r\n");
+		OTA_LOGE(CFG_FLASH_RANGE);
         return OTA_ERR_FLASH_RANGE;
     }
 
     /* MiniOTA起始地址必须按 Flash 页对齐 */
     if ((OTA_TOTAL_START_ADDRESS % OTA_FLASH_PAGE_SIZE) != 0)
     {
-		OTA_DebugSend("[OTA][Error]:In OtaInterface - MiniOTA's starting address must be aligned to the Flash page.\r\n");
+		OTA_LOGE(CFG_ALIGN);
         return OTA_ERR_ALIGN;
     }
 
     /* MiniOTA可用的flash空间必须大于一个 Flash 页 */
     if (app_max_size < OTA_FLASH_PAGE_SIZE)
     {
-		OTA_DebugSend("[OTA][Error]:In OtaInterface - MiniOTA available flash storage space must be larger than one Flash page.\r\n");
+		OTA_LOGE(CFG_SIZE);
         return OTA_ERR_SIZE;
     }
 
+#if OTA_DUAL_BANK
+    /* 芯片须为双 Bank 且 Bank2 起始地址与布局模板一致;
+       Bank2 须位于 Meta 之后，且能容纳与 Slot A 同样大小的 Slot B */
+    if (MiniOTA_GetLayout()->bank2_addr == 0 ||
+        MiniOTA_GetLayout()->bank2_addr != OTA_BANK2_START_ADDRESS ||
+        OTA_BANK2_START_ADDRESS <= OTA_APP_REGION_ADDR ||
+        OTA_APP_SLOT_SIZE < OTA_FLASH_PAGE_SIZE ||
+        OTA_APP_B_ADDR + OTA_APP_SLOT_SIZE - 1 > flash_end)
+    {
+		OTA_LOGE(CFG_BANK);
+        return OTA_ERR_BANK;
+    }
+#endif
+
+#if OTA_BACKUP_COMPRESSED
+    /* Slot A 与压缩备份分区均须至少一页 */
+    if (OTA_BACKUP_SLOT_PERCENT >= 100 ||
+        OTA_APP_B_SIZE < OTA_FLASH_PAGE_SIZE || OTA_APP_SLOT_SIZE < OTA_FLASH_PAGE_SIZE)
+    {
+		OTA_LOGE(CFG_BACKUP);
+        return OTA_ERR_BACKUP;
+    }
+#endif
+
+    /* 插槽数量: 2~8，特殊布局下只能为 2 */
+    if (OTA_SLOT_NUM < 2 || OTA_SLOT_NUM > OTA_PART_MAX_NUM ||
+        ((OTA_DUAL_BANK || OTA_EXT_STAGING || OTA_BACKUP_COMPRESSED || OTA_SWAP_INSTALL) && OTA_SLOT_NUM != 2))
+    {
+		OTA_LOGE(CFG_SLOT_NUM);
+        return OTA_ERR_SLOT_NUM;
+    }
+
+    /* Meta 结构与分区表须能放入 Meta 页 */
+    if (sizeof(OTA_META_DATA_E) > OTA_PART_TABLE_OFFSET ||
+        OTA_PART_TABLE_OFFSET + sizeof(OTA_PART_TABLE_E) > OTA_META_SIZE)
+    {
+		OTA_LOGE(CFG_PART);
+        return OTA_ERR_PART;
+    }
+
+#if OTA_SWAP_INSTALL
+    /* 交换安装与其他布局互斥，且一个插槽的页数须能全部记录在进度页中 */
+    if (OTA_EXT_STAGING || OTA_BACKUP_COMPRESSED || OTA_DUAL_BANK ||
+        OTA_APP_SLOT_SIZE < OTA_FLASH_PAGE_SIZE || OTA_APP_SLOT_SIZE / OTA_FLASH_PAGE_SIZE > OTA_SWAP_MAX_PAGES)
+    {
+		OTA_LOGE(CFG_SWAP);
+        return OTA_ERR_SWAP;
+    }
+#endif
+
+#if OTA_SIG_ENABLE
+    /* 签名覆盖固件头中的摘要; 重定位会在安装时改写固件体，摘要随之失效 */
+    if (!OTA_SHA256_ENABLE || OTA_RELOC_ENABLE)
+    {
+		OTA_LOGE(CFG_SIG);
+        return OTA_ERR_SIG;
+    }
+#endif
+
+#if OTA_EXT_STAGING
+    /* 暂存分区按 4KB 扇区擦除，起始处须对齐 */
+    if ((OTA_EXT_STAGING_OFFSET % OTA_SPI_NOR_SECTOR_SIZE) != 0)
+    {
+		OTA_LOGE(CFG_EXT);
+        return OTA_ERR_EXT;
+    }
+#endif
+
     return OTA_OK;
 }
 
-static OTA_REC_FLAG_STATE_E OTA_RunIAP(uint32_t addr)
+/** IAP 任务表: 接收解析、Flash 提交、超时检查、预擦除、日志发送、喂狗 */
+static const OTA_SCHED_TASK iap_tasks[] = {
+	{ OTA_EVT_RX,    OTA_XmodemRxTask     },
+	{ OTA_EVT_FLASH, OTA_XmodemCommitTask },
+	{ OTA_EVT_TICK,  OTA_XmodemTickTask   },
+	{ OTA_EVT_TICK,  OTA_FlashPoll        },
+	{ OTA_EVT_TICK,  OTA_LogPoll          },
+	{ OTA_EVT_TICK,  OTA_WatchdogFeed     },
+};
+
+static OTA_REC_FLAG_STATE_E OTA_RunIAP(OTA_META_DATA_E *pMeta, OTA_ACIVE_SLOT_E slot)
 {
-	OTA_DebugSend("[OTA]:IAPing...\r\n");
+	uint32_t addr = OTA_MetaSlotAddr(slot);
+	OTA_BOOL pre_erased = (pMeta->pre_erased == slot) ? OTA_TRUE : OTA_FALSE;
+	
+	OTA_LOGI(IAP_RUNNING);
+	// 预擦除标记只使用一次: 接收开始后插槽不再空白，本次传输中断时下次会话不能再信任该标记
+	// (Meta 写入会占用 Flash 页镜像，须在 OTA_XmodemInit 之前完成)
+	if(pre_erased)
+	{
+		pMeta->pre_erased = OTA_PRE_ERASED_NONE;
+		OTA_MetaSave(pMeta);
+	}
+	// Flash 擦写期间取向量不被阻塞
+	OTA_VectorToRam();
 	OTA_XmodemInit(addr);
+	OTA_ImageStreamInit(slot);
+	// App 已在空闲时擦除过目标插槽，写入时跳过擦除
+	if(pre_erased)
+	{
+		OTA_LOGI_HEX(IAP_PRE_ERASED, addr);
+		OTA_FlashSetErased(addr, OTA_MetaSlotSize(slot));
+	}
 	while(1)
 	{
-		/* 周期为1s得检查传输是否未开始 */
-		if(OTA_GetXmodemState() == XM_WAIT_START && OTA_XmodemRevCompFlag() == REC_FLAG_IDLE)
-		{
-			OTA_SendByte(0x43);
-			
-			uint8_t i;
-			for(i = 0; i < 100 ; i++ )
-			{
-				OTA_Delay1ms();
-			}
-		}
+		/* 运行一轮任务，无事件时 WFI 睡眠 */
+		OTA_SchedRunOnce(iap_tasks, sizeof(iap_tasks) / sizeof(iap_tasks[0]));
 		
 		if(OTA_XmodemRevCompFlag() == REC_FLAG_FINISH)
 		{
+			OTA_FlashWaitIdle();
+			OTA_XmodemReportStats();
 			return REC_FLAG_FINISH;
 		}
 		else if(OTA_XmodemRevCompFlag() == REC_FLAG_INT)
 		{
+			OTA_FlashWaitIdle();
+			OTA_XmodemReportStats();
 			return REC_FLAG_INT;
 		}
 	}
 }
 
-void OTA_UserConfirmedJump(OTA_META_DATA_E *meta)
+#if OTA_EXT_STAGING
+/**
+ * @brief  将暂存分区 (外部 SPI NOR) 中的固件校验后逐页复制到 Slot A
+ *         复制期间 Meta 仍指向暂存分区，掉电后下次启动重新安装;
+ *         暂存固件无效或写入失败时放弃本次升级，回到 Slot A
+ * @param  pMeta: Meta 信息 (active_slot 为 SLOT_B 时调用)
+ * @return 0: 安装完成, 1: 失败
+ */
+static int OTA_InstallStaged(OTA_META_DATA_E *pMeta)
 {
-	// 发送IOM信息
-	uint32_t tarAddr;
-	// 首次写入flash特例
-	if(meta->active_slot == SLOT_A && meta->slotAStatus == SLOT_STATE_EMPTY)
-	{
-		tarAddr = OTA_APP_A_ADDR;
-	}
-	else
-	{
-		tarAddr = (meta->active_slot == SLOT_A) ? OTA_APP_B_ADDR : OTA_APP_A_ADDR;
-	}
-	
-	OTA_DebugSend("[OTA]:Selecting IAP... \r\n");
-	OTA_DebugSend("[OTA]:Please set the IOM address to : \r\n");
-	OTA_PrintHex32(tarAddr + sizeof(OTA_APP_IMG_HEADER_E));
-	OTA_DebugSend("\r\n");
+	OTA_IMG_INFO_E info;
+	uint32_t src = OTA_MetaSlotAddr(SLOT_B);
+	uint32_t total;
+	uint32_t off;
 	
-	if(OTA_RunIAP(tarAddr) == REC_FLAG_FINISH)
+	if(Verify_App_Slot(pMeta, SLOT_B))
 	{
-		if(meta->active_slot == SLOT_A)
+		OTA_ImageLoad(src, &info);
+		total = info.hdr_len + info.img_size;
+		OTA_LOGI_HEX(INSTALL_START, total);
+		
+#if OTA_SIG_ENABLE
+		// Slot A 被改写，复制完成后重新验证签名
+		OTA_SigForget(pMeta, SLOT_A);
+#endif
+		OTA_FlashHandleInit(OTA_MetaSlotAddr(SLOT_A));
+		for(off = 0; off < total && off < OTA_MetaSlotSize(SLOT_A); off += OTA_FLASH_PAGE_SIZE)
 		{
-			// 首次写入flash特例
-			if(meta->slotAStatus == SLOT_STATE_EMPTY)
-			{
-				meta->slotAStatus = SLOT_STATE_UNCONFIRMED;
-				meta->active_slot = SLOT_A;
-			}
-			else
+			OTA_BdevRead(src + off, OTA_FlashGetMirr(), OTA_FLASH_PAGE_SIZE);
+			if(OTA_FlashWrite() != 0)
 			{
-				meta->slotBStatus = SLOT_STATE_UNCONFIRMED;
-				meta->active_slot = SLOT_B;
+				break;
 			}
+			OTA_WatchdogFeed();
 		}
-		else
+		
+		if(Verify_App_Slot(pMeta, SLOT_A))
+		{
+			// 暂存分区已使用完毕，新固件在 Slot A 中待确认
+			OTA_MetaMarkPending(pMeta, SLOT_A);
+			pMeta->slot_status[SLOT_B] = SLOT_STATE_EMPTY;
+			OTA_MetaSave(pMeta);
+			return 0;
+		}
+	}
+	
+	OTA_LOGE(INSTALL_FAIL);
+	pMeta->slot_status[SLOT_B] = SLOT_STATE_INVALID;
+	pMeta->active_slot = SLOT_A;
+	OTA_MetaSave(pMeta);
+	return 1;
+}
+#endif
+
+void OTA_UserConfirmedJump(OTA_META_DATA_E *meta)
+{
+	// 发送IOM信息
+	OTA_ACIVE_SLOT_E tarSlot = OTA_MetaGetIapSlot(meta);
+	uint32_t tarAddr = OTA_MetaSlotAddr(tarSlot);
+	
+	OTA_LOGI(IAP_SELECT);
+#if OTA_RELOC_ENABLE
+	// 固件以 0 为基址链接，下载后按目标插槽重定位，无需提示 IOM 地址
+#elif OTA_EXT_STAGING || OTA_SWAP_INSTALL
+	// 固件最终运行在 Slot A
+	OTA_LOGI_HEX(IAP_IOM_ADDR, OTA_MetaSlotAddr(SLOT_A) + sizeof(OTA_APP_IMG_HEADER_E));
+#else
+	OTA_LOGI_HEX(IAP_IOM_ADDR, tarAddr + sizeof(OTA_APP_IMG_HEADER_E));
+#endif
+	
+#if OTA_BACKUP_COMPRESSED
+	// 覆盖 Slot A 前先保存压缩备份，用于回滚
+	OTA_SaveBackup(meta);
+#endif
+#if OTA_SIG_ENABLE
+	OTA_SigForget(meta, tarSlot);
+#endif
+	
+	if(OTA_RunIAP(meta, tarSlot) == REC_FLAG_FINISH)
+	{
+#if OTA_RELOC_ENABLE
+		// 重定位失败时插槽不标记为待确认，重新进入 IAP
+		if(OTA_RelocApply(tarSlot) != 0)
 		{
-			meta->slotAStatus = SLOT_STATE_UNCONFIRMED;
-			meta->active_slot = SLOT_A;
+			return;
 		}
+#endif
+		
+		OTA_MetaMarkPending(meta, tarSlot);
+#if OTA_SIG_ENABLE
+		// 接收时已验证过签名，下次启动不必再读出整个插槽
+		OTA_MetaSetVerified(meta, tarSlot, OTA_ImageStreamSigned());
+#endif
 		
-		OTA_SaveMeta(meta);
+		OTA_MetaSave(meta);
+		
+#if OTA_EXT_STAGING
+		if(OTA_InstallStaged(meta) != 0)
+		{
+			return;
+		}
+		tarAddr = OTA_MetaSlotAddr(SLOT_A);
+#elif OTA_SWAP_INSTALL
+		if(OTA_InstallSwap(meta) != 0)
+		{
+			return;
+		}
+		tarAddr = OTA_MetaSlotAddr(SLOT_A);
+#endif
 	
-		OTA_JumpToApp(tarAddr + sizeof(OTA_APP_IMG_HEADER_E));
+		OTA_PROF_DUMP();
+		OTA_JumpToApp(OTA_ImageEntryAddr(tarAddr));
 	}
 }
 
@@ -250,36 +638,74 @@ void OTA_UserConfirmedJump(OTA_META_DATA_E *meta)
 void OTA_Run(void) {
     OTA_META_DATA_E meta;
     uint32_t target_addr;
+#if OTA_SWAP_INSTALL
+    OTA_SWAP_HEADER_E swap;
+#endif
+	
+	OTA_PROF_INIT();
+	// 切换到高性能时钟后再按新主频初始化时基
+	OTA_ClockHighPerf();
+	OTA_TimebaseInit();
 	
 	while(1)
 	{
 		// 检查用户参数设置合理性
+		OTA_PROF_BEGIN(OTA_PROF_BOOT_CFG);
 		if(OTA_IsUserSetingsValid() != OTA_OK)
 		{
 			return;
 		}
+		OTA_PROF_END(OTA_PROF_BOOT_CFG);
+		
+		// 读取 Meta 页中的分区表，无效时沿用默认布局
+		switch(OTA_PartLoad())
+		{
+		case OTA_PART_LOADED:
+			OTA_LOGI(PART_LOADED);
+			break;
+		case OTA_PART_INVALID:
+			OTA_LOGE(PART_INVALID);
+			break;
+		default:
+			break;
+		}
 	
-		// 读取 Meta 信息
-		meta = *(OTA_META_DATA_E *)OTA_META_ADDR;
-	
-		// 检查 Meta 是否合法
-		if (meta.magic != OTA_MAGIC_NUM) {
+		// 读取 Meta 信息并检查是否合法
+		OTA_PROF_BEGIN(OTA_PROF_BOOT_META);
+		if (OTA_MetaLoad(&meta) != OTA_TRUE) {
 			/* Meta 无效：
-				忽略OTA_ShouldEnterIap接口
-				将Slot_A作为目标slot，进行IAP
+				空片时将Slot_A作为目标slot，进行IAP;
+				写 Meta 途中掉电时按插槽中的固件头重建，已有的完整固件经校验后照常启动
 			*/
-			meta.magic = OTA_MAGIC_NUM;
-			meta.seq_num = 0UL;
-			meta.active_slot = SLOT_A;
-			meta.slotAStatus = SLOT_STATE_EMPTY;
-			meta.slotBStatus = SLOT_STATE_EMPTY;
+			OTA_MetaRebuild(&meta);
 			
 			// 保存meta分区状态
-			OTA_SaveMeta(&meta);
+			OTA_MetaSave(&meta);
 		}
 		
+#if OTA_EXT_STAGING
+		// 暂存分区中有待安装的固件 (含安装过程中掉电的情况)
+		if(meta.active_slot == SLOT_B)
+		{
+			OTA_InstallStaged(&meta);
+		}
+#elif OTA_SWAP_INSTALL
+		// 进度页中有未完成的交换 (含交换过程中掉电的情况) 时从中断处继续，
+		// 否则安装 Slot B 中待确认的新固件
+		if(OTA_SwapLoad(&swap))
+		{
+			OTA_LOGI(SWAP_RESUME);
+			OTA_SwapComplete(&meta, OTA_SwapRun());
+		}
+		else if(meta.active_slot == SLOT_B)
+		{
+			OTA_InstallSwap(&meta);
+		}
+#endif
+		
 		// 根据固件头更新meta信息
 		OTA_UpdateMeta(&meta);
+		OTA_PROF_END(OTA_PROF_BOOT_META);
 		
 		// 如果用户需要刷入新的固件
 		if(OTA_ShouldEnterIap())
@@ -289,27 +715,42 @@ void OTA_Run(void) {
 		}
 		
 		// 确定跳转目标地址
+		OTA_PROF_BEGIN(OTA_PROF_BOOT_SELECT);
 		target_addr = OTA_GetJumpTar(&meta);
+		OTA_PROF_END(OTA_PROF_BOOT_SELECT);
 		if(target_addr != U32_INVALID)
 		{
+			OTA_PROF_DUMP();
 			// 跳转到目标地址
-			OTA_JumpToApp(target_addr + sizeof(OTA_APP_IMG_HEADER_E));
+			OTA_JumpToApp(OTA_ImageEntryAddr(target_addr));
 		}
 	
 		// 无可用固件，默认尝试使用slot_a接收新固件
+#if !OTA_RELOC_ENABLE
 		// 发送IOM信息
-		OTA_DebugSend("[OTA]:Please set the IOM address to : \r\n");
-		OTA_PrintHex32(OTA_APP_A_ADDR + sizeof(OTA_APP_IMG_HEADER_E));
-		OTA_DebugSend("\r\n");
+		OTA_LOGI_HEX(IAP_IOM_ADDR, OTA_MetaSlotAddr(SLOT_A) + sizeof(OTA_APP_IMG_HEADER_E));
+#endif
+#if OTA_SIG_ENABLE
+		OTA_SigForget(&meta, SLOT_A);
+#endif
 		
-		if(OTA_RunIAP(OTA_APP_A_ADDR) == REC_FLAG_FINISH)
+		if(OTA_RunIAP(&meta, SLOT_A) == REC_FLAG_FINISH)
 		{
-			meta.active_slot = SLOT_A;
-			meta.slotAStatus = SLOT_STATE_UNCONFIRMED;
-			meta.slotBStatus = SLOT_STATE_EMPTY;
-			OTA_SaveMeta(&meta);
+#if OTA_RELOC_ENABLE
+			if(OTA_RelocApply(SLOT_A) != 0)
+			{
+				return;
+			}
+#endif
+			
+			OTA_MetaMarkPending(&meta, SLOT_A);
+#if OTA_SIG_ENABLE
+			OTA_MetaSetVerified(&meta, SLOT_A, OTA_ImageStreamSigned());
+#endif
+			OTA_MetaSave(&meta);
 		
-			OTA_JumpToApp(OTA_APP_A_ADDR + sizeof(OTA_APP_IMG_HEADER_E));
+			OTA_PROF_DUMP();
+			OTA_JumpToApp(OTA_ImageEntryAddr(OTA_MetaSlotAddr(SLOT_A)));
 		}
 		
 		return;
@@ -0,0 +1,959 @@
+/**
+ ******************************************************************************
+ * @file    OtaEd25519.c
+ * @author  MiniOTA Team
+ * @brief   Ed25519 签名验证实现 (RFC 8032)
+ *          域元素为 8 个 32 位字 (基数 2^32)，乘法用 32x32->64 位乘加 (Cortex-M3 的 UMULL/UMLAL)，
+ *          2^256 = 38 (mod p) 折叠约简，运算中只保证小于 2^256，比较与编码前才完全约简;
+ *          [s]B - [h]A 用交错的滑动窗口 (Straus) 一次完成: 253 次倍点共用，
+ *          B 的奇数倍 (B, 3B, ..., 15B) 为 Flash 中预计算的仿射表，A 的奇数倍在运行时计算;
+ *          签名验证只处理公开数据，全部按可变时间实现
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 MiniOTA.
+ * All rights reserved.
+ *
+ ******************************************************************************
+ */
+
+#include "OtaInterface.h"
+#include "OtaUtils.h"
+#include "OtaProf.h"
+#include "OtaEd25519.h"
+
+/** 域元素 (模 p = 2^255 - 19)，小端字序 */
+typedef uint32_t Ed_Fe[8];
+
+/**
+ * @brief 扩展坐标点 (x = X/Z, y = Y/Z, T = XY/Z)
+ */
+typedef struct
+{
+    Ed_Fe X;
+    Ed_Fe Y;
+    Ed_Fe Z;
+    Ed_Fe T;
+} Ed_Point;
+
+/**
+ * @brief 加法用的预处理点: (Y+X, Y-X, 2dT)，仿射点 Z = 1 时省去 2Z
+ */
+typedef struct
+{
+    Ed_Fe YpX;
+    Ed_Fe YmX;
+    Ed_Fe T2d;
+} Ed_Niels;
+
+/**
+ * @brief 运行时的预处理点 (射影坐标，另带 2Z)
+ */
+typedef struct
+{
+    Ed_Niels n;
+    Ed_Fe    Z2;
+} Ed_Cached;
+
+/**
+ * @brief 验证过程中的大块数据，放在静态区以减小栈占用
+ */
+typedef struct
+{
+    Ed_Cached a_odd[8];     /**< -A, -3A, ..., -15A */
+    int8_t    h_naf[256];   /**< h 的滑动窗口表示 */
+    int8_t    s_naf[256];   /**< S 的滑动窗口表示 */
+} Ed_Work;
+
+static Ed_Work ed_work;
+
+/** d = -121665/121666 */
+static const Ed_Fe ed_d =
+    { 0x135978A3UL, 0x75EB4DCAUL, 0x4141D8ABUL, 0x00700A4DUL, 0x7779E898UL, 0x8CC74079UL, 0x2B6FFE73UL, 0x52036CEEUL };
+/** 2d */
+static const Ed_Fe ed_d2 =
+    { 0x26B2F159UL, 0xEBD69B94UL, 0x8283B156UL, 0x00E0149AUL, 0xEEF3D130UL, 0x198E80F2UL, 0x56DFFCE7UL, 0x2406D9DCUL };
+/** sqrt(-1) */
+static const Ed_Fe ed_sqrtm1 =
+    { 0x4A0EA0B0UL, 0xC4EE1B27UL, 0xAD2FE478UL, 0x2F431806UL, 0x3DFBD7A7UL, 0x2B4D0099UL, 0x4FC1DF0BUL, 0x2B832480UL };
+/** 群的阶 L = 2^252 + 27742317777372353535851937790883648493 */
+static const uint32_t ed_l[8] =
+    { 0x5CF5D3EDUL, 0x5812631AUL, 0xA2F79CD6UL, 0x14DEF9DEUL, 0x00000000UL, 0x00000000UL, 0x00000000UL, 0x10000000UL };
+
+/** 基点 B 的奇数倍 B, 3B, ..., 15B (仿射坐标的 (y+x, y-x, 2dxy)，可用 Tools/OtaImageGen.py 中的 ed_mul 计算) */
+static const Ed_Niels ed_base_odd[8] =
+{
+    { { 0xF58C3B85UL, 0x2FBC93C6UL, 0xFB8C0E19UL, 0xCF932DC6UL, 0x643D42C2UL, 0x270B4898UL, 0x33D4BA65UL, 0x07CF9D3AUL },
+      { 0xD740913EUL, 0x9D103905UL, 0xD140BEB3UL, 0xFD399F05UL, 0x688F8A09UL, 0xA5C18434UL, 0x98F81267UL, 0x44FD2F92UL },
+      { 0x877AAA68UL, 0xABC91205UL, 0xCCAAC49EUL, 0x26D9E823UL, 0xDD43598CUL, 0x5A1B7DCBUL, 0x9F0C65A8UL, 0x6F117B68UL } },
+    { { 0x4CEE9730UL, 0xAF25B0A8UL, 0xE8864B8AUL, 0x025A8430UL, 0x9F016732UL, 0xC11B5002UL, 0x9A80F8F4UL, 0x7A164E1BUL },
+      { 0xA4FCD265UL, 0x56611FE8UL, 0xE5C1BA7DUL, 0x3BD353FDUL, 0x214BD6BDUL, 0x8131F31AUL, 0x555BDA62UL, 0x2AB91587UL },
+      { 0x0DD0D889UL, 0x14AE933FUL, 0x1C35DA62UL, 0x58942322UL, 0x8CF2DB4CUL, 0xD170E545UL, 0x12B9B4C6UL, 0x5A2826AFUL } },
+    { { 0x08A5BB33UL, 0xA212BC44UL, 0xC75EED02UL, 0x8D5048C3UL, 0x5ABFEC44UL, 0xDD1BEB0CUL, 0x46E206EBUL, 0x2945CCF1UL },
+      { 0xA447D6BAUL, 0x7F9182C3UL, 0x4B2729B7UL, 0xD50014D1UL, 0xB864A087UL, 0xE33CF11CUL, 0xEB1B55F3UL, 0x154A7E73UL },
+      { 0x812A8285UL, 0xBCBBDBF1UL, 0xD0BDD1FCUL, 0x270E0807UL, 0x1BBDA72DUL, 0xB41B670BUL, 0x6B3BB69AUL, 0x43AABE69UL } },
+    { { 0x944EA3BFUL, 0x6B1A5CD0UL, 0xB39DC0D2UL, 0x7470353AUL, 0x28542E49UL, 0x71B25282UL, 0x283C927EUL, 0x461BEA69UL },
+      { 0xAA3221B1UL, 0xBA6F2C9AUL, 0x3BBA23A7UL, 0x6CA02153UL, 0x92192C3AUL, 0x9DEA764FUL, 0x2E5317E0UL, 0x1D6EDD5DUL },
+      { 0x01B8B3A2UL, 0xF1836DC8UL, 0x053EA49AUL, 0xB3035F47UL, 0x5877ADF3UL, 0x529C41BAUL, 0x6A0F90A7UL, 0x7A9FBB1CUL } },
+    { { 0xA6A8632FUL, 0x9B2E678AUL, 0x51BC46C5UL, 0xA6509E6FUL, 0xC686F5B5UL, 0xCEB233C9UL, 0x8ADD7F59UL, 0x34B9ED33UL },
+      { 0x039D8064UL, 0xF36E217EUL, 0xF520419BUL, 0x98A081B6UL, 0xE75EB044UL, 0x96CBC608UL, 0xFADC9C8FUL, 0x49C05A51UL },
+      { 0x9045AF1BUL, 0x06B4E8BFUL, 0xA719D22FUL, 0xE2FF83E8UL, 0x93D4CF16UL, 0xAAF6FC29UL, 0x1B008B06UL, 0x73C17202UL } },
+    { { 0x8A802ADEUL, 0x2FBF0084UL, 0x02302E27UL, 0xE5D9FECFUL, 0x17703406UL, 0x113E8471UL, 0x546D8FAFUL, 0x4275AAE2UL },
+      { 0x49864348UL, 0x315F5B02UL, 0x77088381UL, 0x3ED6B369UL, 0x6A8DEB95UL, 0xA3A07555UL, 0x29D5C77FUL, 0x18AB5980UL },
+      { 0xFD6089E9UL, 0xD82B2CC5UL, 0x3282E4A4UL, 0x031EB4A1UL, 0xB51A8622UL, 0x44311199UL, 0xB53DF948UL, 0x3DC65522UL } },
+    { { 0xA2007F6DUL, 0xBF70C222UL, 0xB5BCDEDBUL, 0xBF84B39AUL, 0xFB07BA07UL, 0x537A0E12UL, 0xC346F241UL, 0x234FD7EEUL },
+      { 0x327FBF93UL, 0x506F013BUL, 0x9B776F6BUL, 0xAEFCEBC9UL, 0xAAAD5968UL, 0x9D12B232UL, 0x176024A7UL, 0x0267882DUL },
+      { 0x732EA378UL, 0x5360A119UL, 0xDF8DD471UL, 0x2437E6B1UL, 0x91A7E533UL, 0xA2EF37F8UL, 0xAA097863UL, 0x497BA6FDUL } },
+    { { 0x13CFEAA0UL, 0x24CECC03UL, 0x189C246DUL, 0x8648C28DUL, 0xC1F2D4D0UL, 0x2DBDBDFAUL, 0xF12DE72BUL, 0x61E22917UL },
+      { 0x468CCF0BUL, 0x040BCD86UL, 0x2A9910D6UL, 0xD3829BA4UL, 0x07B25192UL, 0x75083008UL, 0x18D05EBFUL, 0x43B5CD42UL },
+      { 0x9BD0B516UL, 0x5D9A762FUL, 0x373FDEEEUL, 0xEB38AF4EUL, 0x93D64270UL, 0x032E5A7DUL, 0x0AE4D842UL, 0x511D6121UL } }
+};
+
+/* ------------------------------------------------------------------------ */
+/* 域运算                                                                   */
+/* ------------------------------------------------------------------------ */
+
+static void Fe_Set(Ed_Fe r, uint32_t v)
+{
+    r[0] = v;
+    for (uint32_t i = 1; i < 8U; i++)
+    {
+        r[i] = 0;
+    }
+}
+
+static void Fe_Copy(Ed_Fe r, const Ed_Fe a)
+{
+    for (uint32_t i = 0; i < 8U; i++)
+    {
+        r[i] = a[i];
+    }
+}
+
+/**
+ * @brief  把溢出到 2^256 的进位按 2^256 = 38 加回 (可能再次溢出，循环至无进位)
+ */
+static void Fe_Fold(Ed_Fe r, uint32_t carry)
+{
+    uint64_t c;
+
+    while (carry != 0)
+    {
+        c = (uint64_t)carry * 38U;
+        for (uint32_t i = 0; i < 8U && c != 0; i++)
+        {
+            c += r[i];
+            r[i] = (uint32_t)c;
+            c >>= 32;
+        }
+        carry = (uint32_t)c;
+    }
+}
+
+static void Fe_Add(Ed_Fe r, const Ed_Fe a, const Ed_Fe b)
+{
+    uint64_t c = 0;
+
+    for (uint32_t i = 0; i < 8U; i++)
+    {
+        c += (uint64_t)a[i] + b[i];
+        r[i] = (uint32_t)c;
+        c >>= 32;
+    }
+    Fe_Fold(r, (uint32_t)c);
+}
+
+static void Fe_Sub(Ed_Fe r, const Ed_Fe a, const Ed_Fe b)
+{
+    uint64_t c;
+    uint32_t borrow = 0;
+
+    for (uint32_t i = 0; i < 8U; i++)
+    {
+        c = (uint64_t)a[i] - b[i] - borrow;
+        r[i] = (uint32_t)c;
+        borrow = (uint32_t)(c >> 32) & 1U;
+    }
+    // 借位相当于加了 2^256 = 38 (mod p)，再减去 38
+    while (borrow != 0)
+    {
+        c = (uint64_t)r[0] - 38U;
+        r[0] = (uint32_t)c;
+        borrow = (uint32_t)(c >> 32) & 1U;
+        for (uint32_t i = 1; i < 8U && borrow != 0; i++)
+        {
+            borrow = (r[i] == 0) ? 1U : 0U;
+            r[i]--;
+        }
+    }
+}
+
+/**
+ * @brief  512 位乘积约简到 256 位: lo + 38 * hi
+ */
+static void Fe_Reduce(Ed_Fe r, const uint32_t t[16])
+{
+    uint64_t c = 0;
+
+    for (uint32_t i = 0; i < 8U; i++)
+    {
+        c += (uint64_t)t[i + 8U] * 38U + t[i];
+        r[i] = (uint32_t)c;
+        c >>= 32;
+    }
+    Fe_Fold(r, (uint32_t)c);
+}
+
+static void Fe_Mul(Ed_Fe r, const Ed_Fe a, const Ed_Fe b)
+{
+    uint32_t t[16];
+    uint64_t c;
+    uint32_t ai;
+
+    c = 0;
+    ai = a[0];
+    for (uint32_t j = 0; j < 8U; j++)
+    {
+        c += (uint64_t)ai * b[j];
+        t[j] = (uint32_t)c;
+        c >>= 32;
+    }
+    t[8] = (uint32_t)c;
+    for (uint32_t i = 1; i < 8U; i++)
+    {
+        c = 0;
+        ai = a[i];
+        for (uint32_t j = 0; j < 8U; j++)
+        {
+            c += (uint64_t)ai * b[j] + t[i + j];
+            t[i + j] = (uint32_t)c;
+            c >>= 32;
+        }
+        t[i + 8U] = (uint32_t)c;
+    }
+    Fe_Reduce(r, t);
+}
+
+/**
+ * @brief  平方: 交叉项只算一次再整体左移一位，乘法次数为 36 次 (乘法为 64 次)
+ */
+static void Fe_Sq(Ed_Fe r, const Ed_Fe a)
+{
+    uint32_t t[16];
+    uint64_t c;
+    uint32_t ai;
+    uint32_t hi = 0;
+    uint32_t next;
+
+    t[0] = 0;
+    t[15] = 0;
+    c = 0;
+    ai = a[0];
+    for (uint32_t j = 1; j < 8U; j++)
+    {
+        c += (uint64_t)ai * a[j];
+        t[j] = (uint32_t)c;
+        c >>= 32;
+    }
+    t[8] = (uint32_t)c;
+    for (uint32_t i = 1; i < 7U; i++)
+    {
+        c = 0;
+        ai = a[i];
+        for (uint32_t j = i + 1U; j < 8U; j++)
+        {
+            c += (uint64_t)ai * a[j] + t[i + j];
+            t[i + j] = (uint32_t)c;
+            c >>= 32;
+        }
+        t[i + 8U] = (uint32_t)c;
+    }
+
+    for (uint32_t i = 0; i < 16U; i++)
+    {
+        next = t[i] >> 31;
+        t[i] = (t[i] << 1) | hi;
+        hi = next;
+    }
+
+    c = 0;
+    for (uint32_t i = 0; i < 8U; i++)
+    {
+        c += (uint64_t)a[i] * a[i] + t[2U * i];
+        t[2U * i] = (uint32_t)c;
+        c >>= 32;
+        c += t[2U * i + 1U];
+        t[2U * i + 1U] = (uint32_t)c;
+        c >>= 32;
+    }
+    Fe_Reduce(r, t);
+}
+
+/** 连续平方 n 次 */
+static void Fe_SqN(Ed_Fe r, const Ed_Fe a, uint32_t n)
+{
+    Fe_Sq(r, a);
+    while (--n > 0)
+    {
+        Fe_Sq(r, r);
+    }
+}
+
+/**
+ * @brief  完全约简到 [0, p)
+ */
+static void Fe_Freeze(Ed_Fe r)
+{
+    uint64_t c;
+    uint32_t top;
+
+    // 两次折叠第 255 位 (2^255 = 19)，结果小于 2^255
+    for (uint32_t k = 0; k < 2U; k++)
+    {
+        top = r[7] >> 31;
+        r[7] &= 0x7FFFFFFFUL;
+        c = (uint64_t)top * 19U;
+        for (uint32_t i = 0; i < 8U && c != 0; i++)
+        {
+            c += r[i];
+            r[i] = (uint32_t)c;
+            c >>= 32;
+        }
+    }
+    // r >= p 即 r + 19 >= 2^255
+    c = 19;
+    for (uint32_t i = 0; i < 7U; i++)
+    {
+        c = (c + r[i]) >> 32;
+    }
+    if (((c + r[7]) >> 31) != 0)
+    {
+        c = 19;
+        for (uint32_t i = 0; i < 8U; i++)
+        {
+            c += r[i];
+            r[i] = (uint32_t)c;
+            c >>= 32;
+        }
+        r[7] &= 0x7FFFFFFFUL;
+    }
+}
+
+static OTA_BOOL Fe_Equal(const Ed_Fe a, const Ed_Fe b)
+{
+    Ed_Fe x;
+    Ed_Fe y;
+
+    Fe_Copy(x, a);
+    Fe_Copy(y, b);
+    Fe_Freeze(x);
+    Fe_Freeze(y);
+    for (uint32_t i = 0; i < 8U; i++)
+    {
+        if (x[i] != y[i])
+        {
+            return OTA_FALSE;
+        }
+    }
+    return OTA_TRUE;
+}
+
+/** 完全约简后的最低位 (x 的符号) */
+static uint32_t Fe_IsOdd(const Ed_Fe a)
+{
+    Ed_Fe x;
+
+    Fe_Copy(x, a);
+    Fe_Freeze(x);
+    return x[0] & 1U;
+}
+
+/**
+ * @brief  求 z^(2^250 - 1) 与 z^11，求逆与开方共用这段加法链
+ */
+static void Fe_Pow250(Ed_Fe r, Ed_Fe z11, const Ed_Fe z)
+{
+    Ed_Fe t0;
+    Ed_Fe t1;
+    Ed_Fe t2;
+
+    Fe_Sq(t0, z);               // z^2
+    Fe_SqN(t1, t0, 2);          // z^8
+    Fe_Mul(t1, z, t1);          // z^9
+    Fe_Mul(z11, t0, t1);        // z^11
+    Fe_Sq(t0, z11);             // z^22
+    Fe_Mul(t1, t1, t0);         // z^(2^5 - 1)
+    Fe_SqN(t0, t1, 5);
+    Fe_Mul(t1, t0, t1);         // z^(2^10 - 1)
+    Fe_SqN(t0, t1, 10);
+    Fe_Mul(t2, t0, t1);         // z^(2^20 - 1)
+    Fe_SqN(t0, t2, 20);
+    Fe_Mul(t0, t0, t2);         // z^(2^40 - 1)
+    Fe_SqN(t0, t0, 10);
+    Fe_Mul(t1, t0, t1);         // z^(2^50 - 1)
+    Fe_SqN(t0, t1, 50);
+    Fe_Mul(t2, t0, t1);         // z^(2^100 - 1)
+    Fe_SqN(t0, t2, 100);
+    Fe_Mul(t0, t0, t2);         // z^(2^200 - 1)
+    Fe_SqN(t0, t0, 50);
+    Fe_Mul(r, t0, t1);          // z^(2^250 - 1)
+}
+
+/** r = z^(p - 2) = 1/z */
+static void Fe_Invert(Ed_Fe r, const Ed_Fe z)
+{
+    Ed_Fe t;
+    Ed_Fe z11;
+
+    Fe_Pow250(t, z11, z);
+    Fe_SqN(t, t, 5);
+    Fe_Mul(r, t, z11);
+}
+
+/** r = z^((p - 5) / 8)，用于开平方 */
+static void Fe_Pow2523(Ed_Fe r, const Ed_Fe z)
+{
+    Ed_Fe t;
+    Ed_Fe z11;
+
+    Fe_Pow250(t, z11, z);
+    Fe_SqN(t, t, 2);
+    Fe_Mul(r, t, z);
+}
+
+/* ------------------------------------------------------------------------ */
+/* 点运算 (a = -1 的扭曲爱德华兹曲线，扩展坐标)                             */
+/* ------------------------------------------------------------------------ */
+
+/**
+ * @brief  r = p + q (neg 为 1 时 r = p - q)
+ * @param  z2: q 的 2Z，q 为仿射点时传 NULL
+ */
+static void Ed_Add(Ed_Point *r, const Ed_Point *p, const Ed_Niels *q, const uint32_t *z2, int neg)
+{
+    Ed_Fe a;
+    Ed_Fe b;
+    Ed_Fe c;
+    Ed_Fe d;
+    Ed_Fe e;
+
+    // -q 即交换 Y+X 与 Y-X 并对 2dT 取负
+    Fe_Sub(a, p->Y, p->X);
+    Fe_Mul(a, a, neg ? q->YpX : q->YmX);        // A = (Y1-X1)(Y2-X2)
+    Fe_Add(b, p->Y, p->X);
+    Fe_Mul(b, b, neg ? q->YmX : q->YpX);        // B = (Y1+X1)(Y2+X2)
+    Fe_Mul(c, p->T, q->T2d);                    // C = 2d T1 T2
+    if (z2 != 0)
+    {
+        Fe_Mul(d, p->Z, z2);                    // D = 2 Z1 Z2
+    }
+    else
+    {
+        Fe_Add(d, p->Z, p->Z);
+    }
+    Fe_Sub(e, b, a);                            // E = B - A
+    Fe_Add(b, b, a);                            // H = B + A
+    if (neg)
+    {
+        Fe_Add(a, d, c);                        // F = D - (-C)
+        Fe_Sub(d, d, c);                        // G = D + (-C)
+    }
+    else
+    {
+        Fe_Sub(a, d, c);                        // F = D - C
+        Fe_Add(d, d, c);                        // G = D + C
+    }
+    Fe_Mul(r->X, e, a);
+    Fe_Mul(r->Y, d, b);
+    Fe_Mul(r->Z, a, d);
+    Fe_Mul(r->T, e, b);
+}
+
+/**
+ * @brief  r = 2p (4M + 4S)，紧接着仍是倍点时不需要 T，省去一次乘法
+ *         各坐标整体取负 (射影坐标不变) 以省去对 H、F 的取负
+ */
+static void Ed_Double(Ed_Point *r, const Ed_Point *p, OTA_BOOL need_t)
+{
+    Ed_Fe a;
+    Ed_Fe b;
+    Ed_Fe c;
+    Ed_Fe e;
+
+    Fe_Sq(a, p->X);                             // A = X^2
+    Fe_Sq(b, p->Y);                             // B = Y^2
+    Fe_Sq(c, p->Z);
+    Fe_Add(c, c, c);                            // C = 2Z^2
+    Fe_Add(e, p->X, p->Y);
+    Fe_Sq(e, e);
+    Fe_Add(a, a, b);                            // H' = A + B
+    Fe_Sub(b, b, a);
+    Fe_Add(b, b, b);
+    Fe_Add(b, b, a);                            // G = B - A = 2B - H'
+    Fe_Sub(e, e, a);                            // E = (X+Y)^2 - H'
+    Fe_Sub(c, c, b);                            // F' = C - G
+    Fe_Mul(r->X, e, c);
+    Fe_Mul(r->Y, b, a);
+    Fe_Mul(r->Z, c, b);
+    if (need_t == OTA_TRUE)
+    {
+        Fe_Mul(r->T, e, a);
+    }
+}
+
+static void Ed_ToCached(Ed_Cached *r, const Ed_Point *p)
+{
+    Fe_Add(r->n.YpX, p->Y, p->X);
+    Fe_Sub(r->n.YmX, p->Y, p->X);
+    Fe_Mul(r->n.T2d, p->T, ed_d2);
+    Fe_Add(r->Z2, p->Z, p->Z);
+}
+
+/**
+ * @brief  解码点 (RFC 8032 5.1.3)
+ * @return 0: 成功, 1: 编码无效或不在曲线上
+ */
+static int Ed_Decode(Ed_Point *p, const uint8_t s[32])
+{
+    Ed_Fe u;
+    Ed_Fe v;
+    Ed_Fe v3;
+    Ed_Fe t;
+    uint32_t sign = s[31] >> 7;
+
+    for (uint32_t i = 0; i < 8U; i++)
+    {
+        p->Y[i] = (uint32_t)s[4U * i] | ((uint32_t)s[4U * i + 1U] << 8) |
+                  ((uint32_t)s[4U * i + 2U] << 16) | ((uint32_t)s[4U * i + 3U] << 24);
+    }
+    p->Y[7] &= 0x7FFFFFFFUL;
+    // y 须小于 p
+    Fe_Copy(t, p->Y);
+    Fe_Freeze(t);
+    for (uint32_t i = 0; i < 8U; i++)
+    {
+        if (t[i] != p->Y[i])
+        {
+            return 1;
+        }
+    }
+
+    Fe_Set(p->Z, 1);
+    Fe_Sq(u, p->Y);
+    Fe_Mul(v, u, ed_d);
+    Fe_Sub(u, u, p->Z);                         // u = y^2 - 1
+    Fe_Add(v, v, p->Z);                         // v = d y^2 + 1
+
+    // x = u v^3 (u v^7)^((p-5)/8)
+    Fe_Sq(v3, v);
+    Fe_Mul(v3, v3, v);
+    Fe_Sq(t, v3);
+    Fe_Mul(t, t, v);
+    Fe_Mul(t, t, u);
+    Fe_Pow2523(t, t);
+    Fe_Mul(t, t, v3);
+    Fe_Mul(p->X, t, u);
+
+    Fe_Sq(t, p->X);
+    Fe_Mul(t, t, v);
+    if (Fe_Equal(t, u) != OTA_TRUE)
+    {
+        Fe_Set(v3, 0);
+        Fe_Sub(u, v3, u);
+        if (Fe_Equal(t, u) != OTA_TRUE)
+        {
+            return 1;
+        }
+        Fe_Mul(p->X, p->X, ed_sqrtm1);
+    }
+
+    if (Fe_IsOdd(p->X) != sign)
+    {
+        Fe_Set(t, 0);
+        if (Fe_Equal(p->X, t) == OTA_TRUE)
+        {
+            return 1;
+        }
+        Fe_Sub(p->X, t, p->X);
+    }
+    Fe_Mul(p->T, p->X, p->Y);
+    return 0;
+}
+
+/**
+ * @brief  编码点 (仿射 y，最高位为 x 的符号)
+ */
+static void Ed_Encode(uint8_t s[32], const Ed_Point *p)
+{
+    Ed_Fe zi;
+    Ed_Fe x;
+    Ed_Fe y;
+
+    Fe_Invert(zi, p->Z);
+    Fe_Mul(x, p->X, zi);
+    Fe_Mul(y, p->Y, zi);
+    Fe_Freeze(y);
+    y[7] |= Fe_IsOdd(x) << 31;
+    for (uint32_t i = 0; i < 8U; i++)
+    {
+        s[4U * i]      = (uint8_t)y[i];
+        s[4U * i + 1U] = (uint8_t)(y[i] >> 8);
+        s[4U * i + 2U] = (uint8_t)(y[i] >> 16);
+        s[4U * i + 3U] = (uint8_t)(y[i] >> 24);
+    }
+}
+
+/* ------------------------------------------------------------------------ */
+/* 标量                                                                     */
+/* ------------------------------------------------------------------------ */
+
+/**
+ * @brief  小端 32 字节标量的滑动窗口表示: 非零位为 ±1, ±3, ..., ±15，之间至少隔 4 个零
+ */
+static void Sc_Slide(int8_t r[256], const uint8_t a[32])
+{
+    int32_t i;
+    int32_t b;
+    int32_t k;
+
+    for (i = 0; i < 256; i++)
+    {
+        r[i] = (int8_t)(1 & (a[i >> 3] >> (i & 7)));
+    }
+    for (i = 0; i < 256; i++)
+    {
+        if (r[i] == 0)
+        {
+            continue;
+        }
+        for (b = 1; b <= 6 && i + b < 256; b++)
+        {
+            if (r[i + b] == 0)
+            {
+                continue;
+            }
+            if (r[i] + (r[i + b] << b) <= 15)
+            {
+                r[i] = (int8_t)(r[i] + (r[i + b] << b));
+                r[i + b] = 0;
+            }
+            else if (r[i] - (r[i + b] << b) >= -15)
+            {
+                r[i] = (int8_t)(r[i] - (r[i + b] << b));
+                for (k = i + b; k < 256; k++)
+                {
+                    if (r[k] == 0)
+                    {
+                        r[k] = 1;
+                        break;
+                    }
+                    r[k] = 0;
+                }
+            }
+            else
+            {
+                break;
+            }
+        }
+    }
+}
+
+/** 比较小端字序的 256 位数 a >= L */
+static OTA_BOOL Sc_GeL(const uint32_t a[8])
+{
+    for (int32_t i = 7; i >= 0; i--)
+    {
+        if (a[i] != ed_l[i])
+        {
+            return (a[i] > ed_l[i]) ? OTA_TRUE : OTA_FALSE;
+        }
+    }
+    return OTA_TRUE;
+}
+
+static void Sc_SubL(uint32_t a[8])
+{
+    uint64_t c;
+    uint32_t borrow = 0;
+
+    for (uint32_t i = 0; i < 8U; i++)
+    {
+        c = (uint64_t)a[i] - ed_l[i] - borrow;
+        a[i] = (uint32_t)c;
+        borrow = (uint32_t)(c >> 32) & 1U;
+    }
+}
+
+/**
+ * @brief  64 字节小端数模 L (逐位移入并减去 L，只在验证时调用一次)
+ */
+static void Sc_Reduce(uint8_t out[32], const uint8_t in[64])
+{
+    uint32_t r[8] = { 0 };
+    uint32_t bit;
+
+    for (int32_t n = 511; n >= 0; n--)
+    {
+        // r < L < 2^253，2r + 1 不会溢出
+        bit = (in[n >> 3] >> (n & 7)) & 1U;
+        for (uint32_t i = 7; i > 0; i--)
+        {
+            r[i] = (r[i] << 1) | (r[i - 1U] >> 31);
+        }
+        r[0] = (r[0] << 1) | bit;
+        if (Sc_GeL(r) == OTA_TRUE)
+        {
+            Sc_SubL(r);
+        }
+    }
+    for (uint32_t i = 0; i < 8U; i++)
+    {
+        out[4U * i]      = (uint8_t)r[i];
+        out[4U * i + 1U] = (uint8_t)(r[i] >> 8);
+        out[4U * i + 2U] = (uint8_t)(r[i] >> 16);
+        out[4U * i + 3U] = (uint8_t)(r[i] >> 24);
+    }
+}
+
+/* ------------------------------------------------------------------------ */
+/* SHA-512 (只用于计算 H(R || A || M))                                      */
+/* ------------------------------------------------------------------------ */
+
+static const uint64_t sha512_k[80] =
+{
+    0x428A2F98D728AE22ULL, 0x7137449123EF65CDULL, 0xB5C0FBCFEC4D3B2FULL, 0xE9B5DBA58189DBBCULL,
+    0x3956C25BF348B538ULL, 0x59F111F1B605D019ULL, 0x923F82A4AF194F9BULL, 0xAB1C5ED5DA6D8118ULL,
+    0xD807AA98A3030242ULL, 0x12835B0145706FBEULL, 0x243185BE4EE4B28CULL, 0x550C7DC3D5FFB4E2ULL,
+    0x72BE5D74F27B896FULL, 0x80DEB1FE3B1696B1ULL, 0x9BDC06A725C71235ULL, 0xC19BF174CF692694ULL,
+    0xE49B69C19EF14AD2ULL, 0xEFBE4786384F25E3ULL, 0x0FC19DC68B8CD5B5ULL, 0x240CA1CC77AC9C65ULL,
+    0x2DE92C6F592B0275ULL, 0x4A7484AA6EA6E483ULL, 0x5CB0A9DCBD41FBD4ULL, 0x76F988DA831153B5ULL,
+    0x983E5152EE66DFABULL, 0xA831C66D2DB43210ULL, 0xB00327C898FB213FULL, 0xBF597FC7BEEF0EE4ULL,
+    0xC6E00BF33DA88FC2ULL, 0xD5A79147930AA725ULL, 0x06CA6351E003826FULL, 0x142929670A0E6E70ULL,
+    0x27B70A8546D22FFCULL, 0x2E1B21385C26C926ULL, 0x4D2C6DFC5AC42AEDULL, 0x53380D139D95B3DFULL,
+    0x650A73548BAF63DEULL, 0x766A0ABB3C77B2A8ULL, 0x81C2C92E47EDAEE6ULL, 0x92722C851482353BULL,
+    0xA2BFE8A14CF10364ULL, 0xA81A664BBC423001ULL, 0xC24B8B70D0F89791ULL, 0xC76C51A30654BE30ULL,
+    0xD192E819D6EF5218ULL, 0xD69906245565A910ULL, 0xF40E35855771202AULL, 0x106AA07032BBD1B8ULL,
+    0x19A4C116B8D2D0C8ULL, 0x1E376C085141AB53ULL, 0x2748774CDF8EEB99ULL, 0x34B0BCB5E19B48A8ULL,
+    0x391C0CB3C5C95A63ULL, 0x4ED8AA4AE3418ACBULL, 0x5B9CCA4F7763E373ULL, 0x682E6FF3D6B2B8A3ULL,
+    0x748F82EE5DEFB2FCULL, 0x78A5636F43172F60ULL, 0x84C87814A1F0AB72ULL, 0x8CC702081A6439ECULL,
+    0x90BEFFFA23631E28ULL, 0xA4506CEBDE82BDE9ULL, 0xBEF9A3F7B2C67915ULL, 0xC67178F2E372532BULL,
+    0xCA273ECEEA26619CULL, 0xD186B8C721C0C207ULL, 0xEADA7DD6CDE0EB1EULL, 0xF57D4F7FEE6ED178ULL,
+    0x06F067AA72176FBAULL, 0x0A637DC5A2C898A6ULL, 0x113F9804BEF90DAEULL, 0x1B710B35131C471BULL,
+    0x28DB77F523047D84ULL, 0x32CAAB7B40C72493ULL, 0x3C9EBE0A15C9BEBCULL, 0x431D67C49C100D4CULL,
+    0x4CC5D4BECB3E42B6ULL, 0x597F299CFC657E2AULL, 0x5FCB6FAB3AD6FAECULL, 0x6C44198C4A475817ULL,
+};
+
+/**
+ * @brief SHA-512 计算上下文
+ */
+typedef struct
+{
+    uint64_t state[8];
+    uint32_t total;         /**< 已输入的字节数 */
+    uint32_t buf_len;
+    uint8_t  buf[128];
+} Ed_Sha512;
+
+#define SHA512_ROR(x, n)    (((x) >> (n)) | ((x) << (64U - (n))))
+
+static void Sha512_Block(uint64_t state[8], const uint8_t *block)
+{
+    uint64_t w[16];
+    uint64_t v[8];
+    uint64_t t1;
+    uint64_t t2;
+    uint64_t s0;
+    uint64_t s1;
+    uint32_t i;
+
+    for (i = 0; i < 16U; i++)
+    {
+        w[i] = 0;
+        for (uint32_t j = 0; j < 8U; j++)
+        {
+            w[i] = (w[i] << 8) | block[8U * i + j];
+        }
+    }
+    for (i = 0; i < 8U; i++)
+    {
+        v[i] = state[i];
+    }
+    for (i = 0; i < 80U; i++)
+    {
+        if (i >= 16U)
+        {
+            s0 = w[(i - 15U) & 15U];
+            s1 = w[(i - 2U) & 15U];
+            w[i & 15U] += (SHA512_ROR(s1, 19U) ^ SHA512_ROR(s1, 61U) ^ (s1 >> 6)) + w[(i - 7U) & 15U] +
+                          (SHA512_ROR(s0, 1U) ^ SHA512_ROR(s0, 8U) ^ (s0 >> 7));
+        }
+        t1 = v[7] + (SHA512_ROR(v[4], 14U) ^ SHA512_ROR(v[4], 18U) ^ SHA512_ROR(v[4], 41U)) +
+             (v[6] ^ (v[4] & (v[5] ^ v[6]))) + sha512_k[i] + w[i & 15U];
+        t2 = (SHA512_ROR(v[0], 28U) ^ SHA512_ROR(v[0], 34U) ^ SHA512_ROR(v[0], 39U)) +
+             ((v[0] & v[1]) | (v[2] & (v[0] | v[1])));
+        v[7] = v[6];
+        v[6] = v[5];
+        v[5] = v[4];
+        v[4] = v[3] + t1;
+        v[3] = v[2];
+        v[2] = v[1];
+        v[1] = v[0];
+        v[0] = t1 + t2;
+    }
+    for (i = 0; i < 8U; i++)
+    {
+        state[i] += v[i];
+    }
+}
+
+static void Sha512_Init(Ed_Sha512 *pCtx)
+{
+    static const uint64_t iv[8] =
+    {
+        0x6A09E667F3BCC908ULL, 0xBB67AE8584CAA73BULL, 0x3C6EF372FE94F82BULL, 0xA54FF53A5F1D36F1ULL,
+        0x510E527FADE682D1ULL, 0x9B05688C2B3E6C1FULL, 0x1F83D9ABFB41BD6BULL, 0x5BE0CD19137E2179ULL,
+    };
+
+    for (uint32_t i = 0; i < 8U; i++)
+    {
+        pCtx->state[i] = iv[i];
+    }
+    pCtx->total   = 0;
+    pCtx->buf_len = 0;
+}
+
+static void Sha512_Update(Ed_Sha512 *pCtx, const uint8_t *data, uint32_t len)
+{
+    pCtx->total += len;
+    while (len-- > 0)
+    {
+        pCtx->buf[pCtx->buf_len++] = *data++;
+        if (pCtx->buf_len == sizeof(pCtx->buf))
+        {
+            Sha512_Block(pCtx->state, pCtx->buf);
+            pCtx->buf_len = 0;
+        }
+    }
+}
+
+static void Sha512_Final(Ed_Sha512 *pCtx, uint8_t digest[64])
+{
+    pCtx->buf[pCtx->buf_len++] = 0x80;
+    if (pCtx->buf_len > sizeof(pCtx->buf) - 16U)
+    {
+        OTA_MemSet(&pCtx->buf[pCtx->buf_len], 0, sizeof(pCtx->buf) - pCtx->buf_len);
+        Sha512_Block(pCtx->state, pCtx->buf);
+        pCtx->buf_len = 0;
+    }
+    OTA_MemSet(&pCtx->buf[pCtx->buf_len], 0, sizeof(pCtx->buf) - 4U - pCtx->buf_len);
+    pCtx->buf[124] = (uint8_t)(pCtx->total >> 21);
+    pCtx->buf[125] = (uint8_t)(pCtx->total >> 13);
+    pCtx->buf[126] = (uint8_t)(pCtx->total >> 5);
+    pCtx->buf[127] = (uint8_t)(pCtx->total << 3);
+    Sha512_Block(pCtx->state, pCtx->buf);
+
+    for (uint32_t i = 0; i < 64U; i++)
+    {
+        digest[i] = (uint8_t)(pCtx->state[i >> 3] >> (56U - 8U * (i & 7U)));
+    }
+}
+
+/* ------------------------------------------------------------------------ */
+/* 验证                                                                     */
+/* ------------------------------------------------------------------------ */
+
+/**
+ * @brief  验证 Ed25519 签名: 检查 [S]B - [h]A 的编码等于 R
+ * @param  sig: 64 字节签名
+ * @param  pub: 32 字节公钥
+ * @param  msg: 被签名的消息
+ * @param  len: 消息长度
+ * @return 0: 签名有效, 1: 无效
+ */
+int OTA_Ed25519Verify(const uint8_t sig[OTA_ED25519_SIG_SIZE], const uint8_t pub[OTA_ED25519_KEY_SIZE],
+                      const uint8_t *msg, uint32_t len)
+{
+    Ed_Sha512 sha;
+    Ed_Point  a;
+    Ed_Point  r;
+    Ed_Cached a2;
+    uint32_t  s[8];
+    uint8_t   h[64];
+    uint8_t   check[32];
+    int32_t   i;
+    int       ret = 1;
+
+    OTA_PROF_BEGIN(OTA_PROF_SIG_VERIFY);
+    // S < L，拒绝可延展的签名
+    for (uint32_t k = 0; k < 8U; k++)
+    {
+        s[k] = (uint32_t)sig[32U + 4U * k] | ((uint32_t)sig[33U + 4U * k] << 8) |
+               ((uint32_t)sig[34U + 4U * k] << 16) | ((uint32_t)sig[35U + 4U * k] << 24);
+    }
+    if (Sc_GeL(s) == OTA_TRUE || Ed_Decode(&a, pub) != 0)
+    {
+        goto out;
+    }
+
+    Sha512_Init(&sha);
+    Sha512_Update(&sha, sig, 32);
+    Sha512_Update(&sha, pub, OTA_ED25519_KEY_SIZE);
+    Sha512_Update(&sha, msg, len);
+    Sha512_Final(&sha, h);
+    Sc_Reduce(h, h);
+
+    // -A 与其奇数倍: -A, -3A, ..., -15A
+    Fe_Set(r.X, 0);
+    Fe_Sub(a.X, r.X, a.X);
+    Fe_Sub(a.T, r.X, a.T);
+    Ed_ToCached(&ed_work.a_odd[0], &a);
+    Ed_Double(&r, &a, OTA_TRUE);
+    Ed_ToCached(&a2, &r);
+    for (i = 1; i < 8; i++)
+    {
+        Ed_Add(&r, &a, &a2.n, a2.Z2, 0);
+        Ed_ToCached(&ed_work.a_odd[i], &r);
+        a = r;
+    }
+
+    Sc_Slide(ed_work.h_naf, h);
+    Sc_Slide(ed_work.s_naf, &sig[32]);
+
+    Fe_Set(r.X, 0);
+    Fe_Set(r.Y, 1);
+    Fe_Set(r.Z, 1);
+    Fe_Set(r.T, 0);
+    for (i = 255; i >= 0 && ed_work.h_naf[i] == 0 && ed_work.s_naf[i] == 0; i--)
+    {
+    }
+    for (; i >= 0; i--)
+    {
+        int8_t hd = ed_work.h_naf[i];
+        int8_t sd = ed_work.s_naf[i];
+
+        Ed_Double(&r, &r, (hd != 0 || sd != 0) ? OTA_TRUE : OTA_FALSE);
+        if (hd != 0)
+        {
+            const Ed_Cached *q = &ed_work.a_odd[((hd > 0) ? hd : -hd) / 2];
+            Ed_Add(&r, &r, &q->n, q->Z2, hd < 0);
+        }
+        if (sd != 0)
+        {
+            Ed_Add(&r, &r, &ed_base_odd[((sd > 0) ? sd : -sd) / 2], 0, sd < 0);
+        }
+    }
+
+    Ed_Encode(check, &r);
+    ret = 0;
+    for (uint32_t k = 0; k < 32U; k++)
+    {
+        if (check[k] != sig[k])
+        {
+            ret = 1;
+        }
+    }
+
+out:
+    OTA_PROF_END(OTA_PROF_SIG_VERIFY);
+    return ret;
+}
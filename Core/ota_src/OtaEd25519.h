@@ -0,0 +1,37 @@
+/**
+ ******************************************************************************
+ * @file    OtaEd25519.h
+ * @author  MiniOTA Team
+ * @brief   Ed25519 签名验证头文件 (RFC 8032)
+ *          只做验证: 输入全部为公开数据，实现按可变时间优化
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 MiniOTA.
+ * All rights reserved.
+ *
+ ******************************************************************************
+ */
+
+#ifndef OTAED25519_H
+#define OTAED25519_H
+
+#include "OtaInterface.h"
+#include "OtaUtils.h"
+
+#define OTA_ED25519_KEY_SIZE    32U     /**< 公钥长度 (字节) */
+#define OTA_ED25519_SIG_SIZE    64U     /**< 签名长度 (字节): R(32) + S(32) */
+
+/**
+ * @brief  验证 Ed25519 签名
+ *         拒绝不规范的编码: S >= L、公钥 y >= p、公钥不在曲线上
+ * @param  sig: 64 字节签名
+ * @param  pub: 32 字节公钥
+ * @param  msg: 被签名的消息
+ * @param  len: 消息长度
+ * @return 0: 签名有效, 1: 无效
+ */
+int OTA_Ed25519Verify(const uint8_t sig[OTA_ED25519_SIG_SIZE], const uint8_t pub[OTA_ED25519_KEY_SIZE],
+                      const uint8_t *msg, uint32_t len);
+
+#endif
@@ -17,10 +17,21 @@
 #include "OtaFlash.h"
 #include "OtaPort.h"
 #include "OtaUtils.h"
+#include "OtaLog.h"
+#include "OtaProf.h"
+#include "OtaBdev.h"
+#if OTA_EXT_STAGING
+#include "OtaSpiNor.h"
+#endif
 
 /** Flash 句柄，全局唯一 */
 static OTA_FLASH_HANDLE flash;
 
+#if OTA_EXT_STAGING && OTA_REPAIR_ENABLE && (OTA_SPI_NOR_SECTOR_SIZE > OTA_FLASH_PAGE_SIZE)
+/** 修复时按扇区读-改-写外部 SPI NOR: 暂存扇区中页镜像以外的数据 */
+static uint8_t sector_keep[OTA_SPI_NOR_SECTOR_SIZE - OTA_FLASH_PAGE_SIZE];
+#endif
+
 /**
  * @brief  获取当前 Flash 操作地址
  * @return 当前地址
@@ -82,51 +93,197 @@ void OTA_FlashSetMirr(const uint8_t *mirr, uint16_t length)
  */
 void OTA_FlashHandleInit(uint32_t addr)
 {
+    OTA_FlashWaitIdle();
     flash.curr_addr   = addr;
     flash.page_offset = 0;
+    flash.erased_addr = U32_ERASED_NONE;
+    flash.blank_start = 0;
+    flash.blank_end   = 0;
+    flash.seq_addr    = U32_ERASED_NONE;
+    flash.patching    = 0;
     // 预读取当前页内容，以便进行 Read-Modify-Write 操作
-    OTA_DrvRead(addr, flash.page_buf, OTA_FLASH_PAGE_SIZE);
+    OTA_BdevRead(addr, flash.page_buf, OTA_FLASH_PAGE_SIZE);
+}
+
+/**
+ * @brief  页镜像能否直接编程到当前页 (只需把 1 写成 0)
+ * @return OTA_TRUE: 无需擦除
+ */
+static OTA_BOOL Flash_BdevProgrammable(void)
+{
+    uint8_t buf[64];
+
+    for (uint32_t i = 0; i < OTA_FLASH_PAGE_SIZE; i += sizeof(buf))
+    {
+        OTA_BdevRead(flash.curr_addr + i, buf, sizeof(buf));
+        for (uint32_t j = 0; j < sizeof(buf); j++)
+        {
+            if ((buf[j] & flash.page_buf[i + j]) != flash.page_buf[i + j])
+            {
+                return OTA_FALSE;
+            }
+        }
+    }
+    return OTA_TRUE;
+}
+
+/**
+ * @brief  擦除当前页所在的擦除单元 (大于页)，保留单元中页镜像以外的数据
+ * @param  unit: 擦除单元大小
+ * @return 0: 成功, 1: 失败 (含未开启暂存缓冲区的配置)
+ */
+static int Flash_BdevEraseKeep(uint32_t unit)
+{
+#if OTA_EXT_STAGING && OTA_REPAIR_ENABLE && (OTA_SPI_NOR_SECTOR_SIZE > OTA_FLASH_PAGE_SIZE)
+    uint32_t start = flash.curr_addr - flash.curr_addr % unit;
+    uint32_t head  = flash.curr_addr - start;
+    uint32_t tail  = unit - head - OTA_FLASH_PAGE_SIZE;
+
+    if (unit - OTA_FLASH_PAGE_SIZE > sizeof(sector_keep))
+    {
+        return 1;
+    }
+    OTA_BdevRead(start, sector_keep, head);
+    OTA_BdevRead(flash.curr_addr + OTA_FLASH_PAGE_SIZE, &sector_keep[head], tail);
+    if (OTA_BdevErase(start) != 0 ||
+        (head > 0 && OTA_BdevProgram(start, sector_keep, head) != 0) ||
+        (tail > 0 && OTA_BdevProgram(flash.curr_addr + OTA_FLASH_PAGE_SIZE, &sector_keep[head], tail) != 0))
+    {
+        return 1;
+    }
+    return 0;
+#else
+    (void)unit;
+    return 1;
+#endif
+}
+
+/**
+ * @brief  将页缓冲区写入内部 Flash 以外的块设备 (外部 SPI NOR、RAM)
+ *         顺序写入时页内每个擦除单元的起始处先擦除，单元中之后的页随后写入，无需保留;
+ *         擦除单元大于页且当前页由 OTA_FlashPatch 随机载入 (修复) 时，能直接编程则不擦除，
+ *         否则按擦除单元读-改-写，保留单元中的其他数据; 已知空白区域不擦除。编程后分块读回校验
+ * @return 0: 成功, 1: 失败
+ */
+static int Flash_WriteBdev(void)
+{
+    uint32_t unit = OTA_BdevEraseSize(flash.curr_addr);
+    uint32_t addr = (flash.curr_addr + unit - 1U) / unit * unit;
+    uint8_t  buf[64];
+
+    if (flash.curr_addr < flash.blank_start || flash.curr_addr >= flash.blank_end)
+    {
+        OTA_PROF_BEGIN(OTA_PROF_FLASH_ERASE);
+        if (unit <= OTA_FLASH_PAGE_SIZE || (flash.patching == 0 && flash.curr_addr % unit == 0))
+        {
+            for (; addr < flash.curr_addr + OTA_FLASH_PAGE_SIZE; addr += unit)
+            {
+                if (OTA_BdevErase(addr) != 0)
+                {
+                    OTA_LOGE(FLASH_ERASE);
+                    return 1;
+                }
+            }
+        }
+        else if (Flash_BdevProgrammable() != OTA_TRUE && Flash_BdevEraseKeep(unit) != 0)
+        {
+            OTA_LOGE(FLASH_ERASE);
+            return 1;
+        }
+        OTA_PROF_END(OTA_PROF_FLASH_ERASE);
+    }
+
+    OTA_PROF_BEGIN(OTA_PROF_FLASH_PROGRAM);
+    if (OTA_BdevProgram(flash.curr_addr, flash.page_buf, OTA_FLASH_PAGE_SIZE) != 0)
+    {
+        flash.blank_end = flash.blank_start;
+        return 1;
+    }
+    OTA_PROF_END(OTA_PROF_FLASH_PROGRAM);
+
+    OTA_PROF_BEGIN(OTA_PROF_FLASH_VERIFY);
+    for (uint32_t i = 0; i < OTA_FLASH_PAGE_SIZE; i += sizeof(buf))
+    {
+        OTA_BdevRead(flash.curr_addr + i, buf, sizeof(buf));
+        for (uint32_t j = 0; j < sizeof(buf); j++)
+        {
+            if (buf[j] != flash.page_buf[i + j])
+            {
+                OTA_LOGE(FLASH_VERIFY);
+                flash.blank_end = flash.blank_start;
+                return 1;
+            }
+        }
+    }
+    OTA_PROF_END(OTA_PROF_FLASH_VERIFY);
+
+    flash.page_offset = 0;
+    flash.curr_addr += OTA_FLASH_PAGE_SIZE;
+    // 随机载入的页写回后不构成顺序写入，下一页仍按读-改-写处理
+    flash.seq_addr = (flash.patching == 0) ? flash.curr_addr : U32_ERASED_NONE;
+    return 0;
 }
 
 /**
  * @brief  将页缓冲区写入 Flash，包含擦除、编程、校验全流程
+ *         OTA_RAMFUNC_ENABLE 时在 SRAM 中运行，Flash 忙期间接收中断不被阻塞;
+ *         其中调用的 Flash 中的函数 (块设备查找、日志) 均在 Flash 空闲时执行
  * @return 0: 成功, 1: 失败
  */
-int OTA_FlashWrite(void)
+OTA_RAMFUNC int OTA_FlashWrite(void)
 {
+    /* 等待后台擦除收尾 (收尾时会上锁，须在解锁前完成; 之后才能调用 Flash 中的块设备查找) */
+    OTA_FlashWaitIdle();
+
+    if (OTA_BdevIsInternal(flash.curr_addr) != OTA_TRUE)
+    {
+        return Flash_WriteBdev();
+    }
+
     /* 打开 Flash（解锁） */
     if (OTA_FlashUnlock() != 0)
 	{
-		OTA_DebugSend("[OTA][Error]:Flash UnLock Faild\r\n");
+		OTA_LOGE(FLASH_UNLOCK);
 		return 1;
 	}
 
-    /* 擦当前页 */
-    if (OTA_ErasePage(flash.curr_addr) != 0)
+    /* 擦当前页 (已在后台预擦除或位于已知空白区域时跳过) */
+    if (flash.erased_addr != flash.curr_addr &&
+        (flash.curr_addr < flash.blank_start || flash.curr_addr >= flash.blank_end))
     {
-		OTA_DebugSend("[OTA][Error]:Flash Erase Faild\r\n");
-        if(OTA_FlashLock() != 0)
-		{
-			OTA_DebugSend("[OTA][Error]:Flash Lock Faild\r\n");
-		}
-        return 1;
+        OTA_PROF_BEGIN(OTA_PROF_FLASH_ERASE);
+        if (OTA_ErasePage(flash.curr_addr) != 0)
+        {
+            OTA_LOGE(FLASH_ERASE);
+            if(OTA_FlashLock() != 0)
+            {
+                OTA_LOGE(FLASH_LOCK);
+            }
+            return 1;
+        }
+        OTA_PROF_END(OTA_PROF_FLASH_ERASE);
     }
+    flash.erased_addr = U32_ERASED_NONE;
 
-    /* 写整页（按半字编程） */
+    /* 写整页（按半字编程，擦除后即为 0xFFFF 的半字跳过，分段固件的空隙页只需擦除） */
+    OTA_PROF_BEGIN(OTA_PROF_FLASH_PROGRAM);
     for (int i = 0; i < OTA_FLASH_PAGE_SIZE; i += 2)
     {
         uint16_t hw = flash.page_buf[i] | (flash.page_buf[i + 1] << 8);
-        if (OTA_DrvProgramHalfword(flash.curr_addr + i, hw) != 0)
+        if (hw != 0xFFFF && OTA_DrvProgramHalfword(flash.curr_addr + i, hw) != 0)
         {
+            flash.blank_end = flash.blank_start;
             if(OTA_FlashLock() != 0)
 			{
-				OTA_DebugSend("[OTA][Error]:Flash Lock Faild\r\n");
+				OTA_LOGE(FLASH_LOCK);
 			}
             return 1;
         }
     }
+    OTA_PROF_END(OTA_PROF_FLASH_PROGRAM);
 
 	/* 写后读回校验（逐字节对比） */
+    OTA_PROF_BEGIN(OTA_PROF_FLASH_VERIFY);
     for (int i = 0; i < OTA_FLASH_PAGE_SIZE; i++)
     {
         uint8_t flash_byte = *(volatile uint8_t *)(flash.curr_addr + i);
@@ -134,12 +291,13 @@ int OTA_FlashWrite(void)
         if (flash_byte != flash.page_buf[i])
         {
             /* Flash 中的内容与接收到的镜像不一致 */
-			OTA_DebugSend("[OTA][Error]:Flash Verify Error ,Data Mismatch\r\n");
+			OTA_LOGE(FLASH_VERIFY);
+            flash.blank_end = flash.blank_start;
             return 1;
         }
     }
+    OTA_PROF_END(OTA_PROF_FLASH_VERIFY);
 
-	
     OTA_FlashLock();
     
     // 更新镜像内容
@@ -147,3 +305,130 @@ int OTA_FlashWrite(void)
     flash.curr_addr += OTA_FLASH_PAGE_SIZE;
     return 0;
 }
+
+/**
+ * @brief  把数据写入任意地址 (按页读-改-写，擦除单元大于页的设备写回时按擦除单元读-改-写)
+ *         page_offset 记录页镜像中已改动的范围，为 0 时页镜像未载入或已写回
+ * @param  addr: 目标地址
+ * @param  data: 数据
+ * @param  len: 数据长度
+ * @return 0: 成功, 1: 写回失败
+ */
+int OTA_FlashPatch(uint32_t addr, const uint8_t *data, uint32_t len)
+{
+    uint32_t page;
+    uint32_t n;
+
+    while (len > 0)
+    {
+        page = addr - addr % OTA_FLASH_PAGE_SIZE;
+        if (page != flash.curr_addr || flash.page_offset == 0)
+        {
+            if (OTA_FlashFlush() != 0)
+            {
+                return 1;
+            }
+            // 紧接着顺序写入的下一页仍属顺序写入，其余为随机载入
+            flash.patching  = (page != flash.seq_addr) ? 1 : 0;
+            flash.curr_addr = page;
+            OTA_BdevRead(page, flash.page_buf, OTA_FLASH_PAGE_SIZE);
+        }
+
+        n = page + OTA_FLASH_PAGE_SIZE - addr;
+        if (n > len)
+        {
+            n = len;
+        }
+        OTA_MemCopy(&flash.page_buf[addr - page], data, n);
+        if (addr - page + n > flash.page_offset)
+        {
+            flash.page_offset = (uint16_t)(addr - page + n);
+        }
+        addr += n;
+        data += n;
+        len  -= n;
+    }
+    return 0;
+}
+
+/**
+ * @brief  写回页镜像中尚未写入的数据
+ * @return 0: 成功, 1: 失败
+ */
+int OTA_FlashFlush(void)
+{
+    if (flash.page_offset == 0)
+    {
+        return 0;
+    }
+    return OTA_FlashWrite();
+}
+
+/**
+ * @brief  声明一段区域已处于擦除状态，写入其中的页时跳过擦除
+ *         写入失败时该声明作废，重试时恢复正常擦除
+ * @param  addr: 起始地址 (页对齐)
+ * @param  size: 区域大小
+ */
+void OTA_FlashSetErased(uint32_t addr, uint32_t size)
+{
+    flash.blank_start = addr;
+    flash.blank_end   = addr + size;
+}
+
+/**
+ * @brief  推进后台预擦除
+ *         擦除完成时收尾并上锁；当前页镜像已开始接收数据且该页尚未擦除时启动擦除。
+ *         只在应答发出后的主循环中调用，擦除与后续数据包的接收重叠
+ */
+OTA_RAMFUNC void OTA_FlashPoll(void)
+{
+#if OTA_FLASH_ERASE_AHEAD
+    if (flash.erase_busy)
+    {
+        if (OTA_FlashIsBusy(flash.erased_addr))
+        {
+            return;
+        }
+        if (OTA_EraseComplete(flash.erased_addr) != 0)
+        {
+            // 失败时由提交流程重新同步擦除
+            flash.erased_addr = U32_ERASED_NONE;
+        }
+        else
+        {
+            OTA_PROF_END(OTA_PROF_FLASH_ERASE);
+        }
+        flash.erase_busy = 0;
+        OTA_FlashLock();
+    }
+    else if (flash.page_offset > 0 && flash.erased_addr != flash.curr_addr &&
+             OTA_BdevIsInternal(flash.curr_addr) &&
+             (flash.curr_addr < flash.blank_start || flash.curr_addr >= flash.blank_end))
+    {
+        if (OTA_FlashUnlock() != 0)
+        {
+            return;
+        }
+        OTA_PROF_BEGIN(OTA_PROF_FLASH_ERASE);
+        if (OTA_EraseStart(flash.curr_addr) != 0)
+        {
+            OTA_FlashLock();
+            return;
+        }
+        flash.erased_addr = flash.curr_addr;
+        flash.erase_busy  = 1;
+    }
+#endif
+}
+
+/**
+ * @brief  等待后台擦除结束 (退出 IAP 前调用)
+ */
+OTA_RAMFUNC void OTA_FlashWaitIdle(void)
+{
+    while (flash.erase_busy)
+    {
+        OTA_FlashPoll();
+    }
+}
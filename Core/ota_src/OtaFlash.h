@@ -18,6 +18,9 @@
 
 #include "OtaInterface.h"
 
+/** 无预擦除页 */
+#define U32_ERASED_NONE     0xFFFFFFFFUL
+
 /** @defgroup OTA_Flash_Handle
  * @{
  */
@@ -28,6 +31,12 @@ typedef struct __OTA_FLASH_HANDLE
 {
     uint32_t curr_addr;          /**< 当前操作的 Flash 地址 */
     uint16_t page_offset;        /**< 当前页内的偏移量 */
+    uint32_t erased_addr;        /**< 已预擦除(或正在擦除)的页地址，U32_ERASED_NONE 表示无 */
+    uint8_t  erase_busy;         /**< 后台擦除进行中 */
+    uint32_t blank_start;        /**< 已知为空白(无需擦除)区域起始地址 */
+    uint32_t blank_end;          /**< 已知为空白区域结束地址 (不含) */
+    uint32_t seq_addr;           /**< 顺序写入时下一页的地址，U32_ERASED_NONE 表示无 */
+    uint8_t  patching;           /**< 当前页由 OTA_FlashPatch 随机载入 (擦除单元大于页时须保留同一单元中的其他数据) */
     uint8_t  page_buf[OTA_FLASH_PAGE_SIZE];  /**< 页缓冲区，大小为 Flash 页大小 */
 } OTA_FLASH_HANDLE;
 /**
@@ -83,4 +92,40 @@ void OTA_FlashHandleInit(uint32_t addr);
  */
 int OTA_FlashWrite(void);
 
+/**
+ * @brief  把数据写入任意地址 (按页读-改-写): 数据先合入页镜像，写到其他页时才写回当前页
+ *         与顺序写入的 OTA_FlashWrite 共用页镜像，写回后须调用 OTA_FlashFlush;
+ *         擦除单元大于页的设备 (SPI NOR) 上，随机载入的页写回时保留同一擦除单元中的其他数据
+ * @param  addr: 目标地址
+ * @param  data: 数据
+ * @param  len: 数据长度
+ * @return 0: 成功, 1: 写回失败
+ */
+int OTA_FlashPatch(uint32_t addr, const uint8_t *data, uint32_t len);
+
+/**
+ * @brief  写回页镜像中尚未写入的数据 (无数据时直接返回)
+ * @return 0: 成功, 1: 失败
+ */
+int OTA_FlashFlush(void);
+
+/**
+ * @brief  声明一段区域已处于擦除状态，写入其中的页时跳过擦除
+ *         写入失败时该声明作废，重试时恢复正常擦除
+ * @param  addr: 起始地址 (页对齐)
+ * @param  size: 区域大小
+ */
+void OTA_FlashSetErased(uint32_t addr, uint32_t size);
+
+/**
+ * @brief  推进后台预擦除 (OTA_FLASH_ERASE_AHEAD 为 0 时为空操作)
+ *         擦除完成时收尾；当前页镜像已开始接收数据且该页尚未擦除时启动擦除
+ */
+void OTA_FlashPoll(void);
+
+/**
+ * @brief  等待后台擦除结束 (退出 IAP 前调用)
+ */
+void OTA_FlashWaitIdle(void);
+
 #endif
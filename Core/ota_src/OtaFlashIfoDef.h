@@ -29,6 +29,7 @@ typedef struct {
     OTA_BOOL  is_uniform;    // 是否均匀分布
     uint32_t group_count;   // 扇区组数量
     const MiniOTA_SectorGroup *groups;
+    uint32_t bank2_addr;    // 第二个 Bank 起始地址，0 表示单 Bank
 } MiniOTA_FlashLayout;
 
 // 所有模板必须实现这个函数
@@ -0,0 +1,813 @@
+/**
+ ******************************************************************************
+ * @file    OtaImage.c
+ * @author  MiniOTA Team
+ * @brief   固件头解析实现
+ *          同一套解析逻辑既读取插槽中的固件头 (经块设备)，也解析接收过程中缓存的固件头;
+ *          不认识的 TLV 忽略，最高位为 1 的 TLV 不认识时按不支持的特性拒绝;
+ *          接收的数据也经本模块写入: 完整固件顺序写入页镜像，修复流按分块、分段固件按段写入插槽中的对应位置，
+ *          分段固件段之间的空隙按地址顺序填充 0xFF，插槽中的固件体与连续传输时一致;
+ *          固件体按地址顺序写入的同时更新 SHA-256 (OTA_SHA256_ENABLE)，传输结束时与固件头中的摘要比对，
+ *          OTA_SIG_ENABLE 时再验证固件头的签名;
+ *          加密固件 (OTA_AES_ENABLE) 在写入页镜像的同时解密，摘要与写入插槽的都是明文
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 MiniOTA.
+ * All rights reserved.
+ *
+ ******************************************************************************
+ */
+
+#include "OtaInterface.h"
+#include "OtaUtils.h"
+#include "OtaBdev.h"
+#include "OtaFlash.h"
+#include "OtaMeta.h"
+#include "OtaLog.h"
+#include "OtaImage.h"
+#if OTA_SHA256_ENABLE
+#include "OtaSha256.h"
+#endif
+#if OTA_SIG_ENABLE
+#include "OtaSig.h"
+#endif
+#if OTA_AES_ENABLE
+#include "OtaAes.h"
+#endif
+
+/** 固件头中出现了不认识的必须理解的 TLV (只在解析结果中使用) */
+#define IMG_FLAG_UNKNOWN        0x80000000UL
+
+/** 读取固件头中偏移 off 处的数据 */
+typedef void (*Image_ReadFn)(uint32_t off, uint8_t *buf, uint32_t len);
+
+/**
+ * @brief 流式解析状态
+ */
+typedef struct
+{
+    uint8_t  buf[OTA_IMG_HDR_MAX];  /**< 已收到的固件头 */
+    uint32_t got;                   /**< 已缓存的字节数 */
+    uint32_t slot_addr;             /**< 目标插槽起始地址 */
+    uint32_t slot_size;             /**< 目标插槽大小 */
+    uint32_t run_slot_addr;         /**< 固件运行插槽的起始地址 */
+    OTA_BOOL done;                  /**< 固件头已解析完毕 */
+    OTA_BOOL mapped;                /**< 数据按映射写入 (修复流、分段固件) */
+    uint32_t run_idx;               /**< 下一个映射区间的序号 */
+    uint32_t run_addr;              /**< 当前映射区间的写入地址 */
+    uint32_t run_left;              /**< 当前映射区间剩余的字节数 */
+    uint32_t fill_addr;             /**< 分段固件: 已写入到的地址，之后到下一段之前填充 0xFF; 0 表示不填充 */
+    uint32_t body_addr;             /**< 映射写入: 插槽中固件体的起始地址 */
+    OTA_IMG_INFO_E info;            /**< 解析结果 */
+#if OTA_REPAIR_ENABLE
+    OTA_IMG_INFO_E slot_info;       /**< 修复流: 插槽中固件的固件头信息 */
+#endif
+#if OTA_SHA256_ENABLE
+    OTA_BOOL hashing;               /**< 固件头带摘要，正在计算固件体的 SHA-256 */
+    uint32_t hashed;                /**< 已计算的固件体字节数 */
+    OTA_SHA256_CTX_E sha;           /**< SHA-256 计算上下文 */
+#endif
+    OTA_BOOL sig_ok;                /**< 传输结束时签名验证通过 */
+#if OTA_AES_ENABLE
+    OTA_BOOL decrypting;            /**< 固件体为密文，写入前解密 */
+    uint32_t dec_off;               /**< 顺序写入: 已解密的固件体字节数 */
+    OTA_AES_CTR_CTX_E aes;          /**< AES-128-CTR 解密上下文 */
+#endif
+} OTA_IMG_STREAM;
+
+static OTA_IMG_STREAM img_stream;
+
+#if OTA_AES_ENABLE
+static const uint8_t img_aes_key[OTA_AES_KEY_SIZE] = OTA_AES_KEY;
+#endif
+
+/** OTA_ImageLoad 读取的插槽起始地址 */
+static uint32_t img_read_base;
+
+static void Image_ReadBdev(uint32_t off, uint8_t *buf, uint32_t len)
+{
+    OTA_BdevRead(img_read_base + off, buf, len);
+}
+
+static void Image_ReadStream(uint32_t off, uint8_t *buf, uint32_t len)
+{
+    OTA_MemCopy(buf, &img_stream.buf[off], len);
+}
+
+/**
+ * @brief  解析 16 字节的基本字段
+ * @param  pHeader: 基本字段
+ * @param  pInfo: 输出的固件头信息
+ * @return OTA_TRUE: 魔数与固件头长度有效
+ */
+static OTA_BOOL Image_ParseBase(const OTA_APP_IMG_HEADER_E *pHeader, OTA_IMG_INFO_E *pInfo)
+{
+    OTA_MemSet((uint8_t *)pInfo, 0, sizeof(OTA_IMG_INFO_E));
+    pInfo->img_size  = pHeader->img_size;
+    pInfo->version   = pHeader->version;
+    pInfo->img_crc16 = pHeader->img_crc16;
+
+    if (pHeader->magic == APP_MAGIC_NUM)
+    {
+        pInfo->hdr_ver = 1;
+        pInfo->hdr_len = sizeof(OTA_APP_IMG_HEADER_E);
+        return OTA_TRUE;
+    }
+    if (pHeader->magic == APP_MAGIC_NUM_V2 && pHeader->hdr_len >= sizeof(OTA_APP_IMG_HEADER_E) &&
+        pHeader->hdr_len <= OTA_IMG_HDR_MAX && (pHeader->hdr_len & 3U) == 0)
+    {
+        pInfo->hdr_ver = 2;
+        pInfo->hdr_len = pHeader->hdr_len;
+        return OTA_TRUE;
+    }
+    return OTA_FALSE;
+}
+
+/**
+ * @brief  解析 v2 固件头的 TLV 扩展区
+ * @param  pInfo: 固件头信息 (基本字段已解析)
+ * @param  read: 读取固件头的方法
+ * @return OTA_TRUE: 扩展区格式有效
+ */
+static OTA_BOOL Image_ParseTlv(OTA_IMG_INFO_E *pInfo, Image_ReadFn read)
+{
+    OTA_IMG_TLV_E tlv;
+    uint32_t off = sizeof(OTA_APP_IMG_HEADER_E);
+
+    while (off + sizeof(tlv) <= pInfo->hdr_len)
+    {
+        read(off, (uint8_t *)&tlv, sizeof(tlv));
+        off += sizeof(tlv);
+        if (tlv.len > pInfo->hdr_len - off)
+        {
+            return OTA_FALSE;
+        }
+
+        switch (tlv.type)
+        {
+        case OTA_TLV_PAD:
+            break;
+        case OTA_TLV_LOAD_ADDR:
+        case OTA_TLV_ENTRY:
+        case OTA_TLV_FLAGS:
+            if (tlv.len != sizeof(uint32_t))
+            {
+                return OTA_FALSE;
+            }
+            if (tlv.type == OTA_TLV_LOAD_ADDR)
+            {
+                read(off, (uint8_t *)&pInfo->load_addr, sizeof(uint32_t));
+                pInfo->has_load_addr = 1;
+            }
+            else
+            {
+                read(off, (uint8_t *)((tlv.type == OTA_TLV_ENTRY) ? &pInfo->entry : &pInfo->flags), sizeof(uint32_t));
+            }
+            break;
+        case OTA_TLV_HASH:
+            if (tlv.len != 32U)
+            {
+                return OTA_FALSE;
+            }
+            pInfo->hash_off = (uint16_t)off;
+            break;
+        case OTA_TLV_SIGNATURE:
+            if (tlv.len != 64U)
+            {
+                return OTA_FALSE;
+            }
+            pInfo->sig_off = (uint16_t)off;
+            break;
+        case OTA_TLV_IV:
+            if (tlv.len != 16U)
+            {
+                return OTA_FALSE;
+            }
+            pInfo->iv_off = (uint16_t)off;
+            break;
+        case OTA_TLV_CHUNKS:
+            if (tlv.len < sizeof(uint32_t) || ((tlv.len - sizeof(uint32_t)) & 1U) != 0)
+            {
+                return OTA_FALSE;
+            }
+            read(off, (uint8_t *)&pInfo->chunk_size, sizeof(uint32_t));
+            pInfo->chunk_off = (uint16_t)(off + sizeof(uint32_t));
+            pInfo->chunk_num = (tlv.len - sizeof(uint32_t)) / 2U;
+            break;
+#if OTA_REPAIR_ENABLE
+        case OTA_TLV_REPAIR:
+            if (tlv.len == 0 || (tlv.len & 1U) != 0)
+            {
+                return OTA_FALSE;
+            }
+            pInfo->repair_off = (uint16_t)off;
+            pInfo->repair_num = tlv.len / 2U;
+            break;
+#endif
+        case OTA_TLV_SEGMENTS:
+            if (tlv.len == 0 || (tlv.len & 7U) != 0)
+            {
+                return OTA_FALSE;
+            }
+            pInfo->seg_off = (uint16_t)off;
+            pInfo->seg_num = tlv.len / 8U;
+            break;
+        default:
+            if (tlv.type & OTA_TLV_CRITICAL)
+            {
+                pInfo->flags |= IMG_FLAG_UNKNOWN;
+            }
+            break;
+        }
+        off += (tlv.len + 3U) & ~3U;
+    }
+    return OTA_TRUE;
+}
+
+/**
+ * @brief  读取并解析插槽中的固件头 (v1/v2)
+ * @param  slot_addr: 插槽起始地址
+ * @param  pInfo: 输出的固件头信息
+ * @return OTA_TRUE: 固件头格式有效
+ */
+OTA_BOOL OTA_ImageLoad(uint32_t slot_addr, OTA_IMG_INFO_E *pInfo)
+{
+    OTA_APP_IMG_HEADER_E header;
+
+    OTA_BdevRead(slot_addr, (uint8_t *)&header, sizeof(header));
+    if (Image_ParseBase(&header, pInfo) != OTA_TRUE)
+    {
+        return OTA_FALSE;
+    }
+    img_read_base = slot_addr;
+    return Image_ParseTlv(pInfo, Image_ReadBdev);
+}
+
+/**
+ * @brief  获取插槽中固件的运行插槽地址
+ * @param  slot: 固件所在插槽
+ * @return 运行插槽的起始地址
+ */
+uint32_t OTA_ImageRunSlotAddr(OTA_ACIVE_SLOT_E slot)
+{
+#if OTA_EXT_STAGING || OTA_BACKUP_COMPRESSED || OTA_SWAP_INSTALL
+    slot = SLOT_A;
+#endif
+    return OTA_MetaSlotAddr(slot);
+}
+
+/**
+ * @brief  获取固件的向量表地址
+ * @param  slot_addr: 插槽起始地址
+ * @return 向量表地址
+ */
+uint32_t OTA_ImageEntryAddr(uint32_t slot_addr)
+{
+    OTA_IMG_INFO_E info;
+
+    if (OTA_ImageLoad(slot_addr, &info) != OTA_TRUE)
+    {
+        return slot_addr + sizeof(OTA_APP_IMG_HEADER_E);
+    }
+    return slot_addr + info.hdr_len + info.entry;
+}
+
+/**
+ * @brief  检查固件头是否适合写入插槽
+ * @param  pInfo: 固件头信息
+ * @param  slot_size: 目标插槽大小
+ * @param  run_slot_addr: 固件运行插槽的起始地址
+ * @return 0: 通过, 1: 拒绝
+ */
+int OTA_ImageCheck(const OTA_IMG_INFO_E *pInfo, uint32_t slot_size, uint32_t run_slot_addr)
+{
+    if (pInfo->img_size == 0 || pInfo->hdr_len > slot_size || pInfo->img_size > slot_size - pInfo->hdr_len)
+    {
+        OTA_LOGE_HEX(IMG_TOO_LARGE, pInfo->hdr_len + pInfo->img_size);
+        return 1;
+    }
+    if (pInfo->flags & ~OTA_IMG_FLAGS_SUPPORTED)
+    {
+        OTA_LOGE_HEX(IMG_UNSUPPORTED, pInfo->flags);
+        return 1;
+    }
+    if ((pInfo->entry & 3U) != 0 || pInfo->entry >= pInfo->img_size ||
+        (pInfo->chunk_off != 0 &&
+         (pInfo->chunk_size == 0 || pInfo->chunk_num != (pInfo->img_size - 1U) / pInfo->chunk_size + 1U)) ||
+        ((pInfo->flags & OTA_IMG_FLAG_SEGMENTED) != 0) != (pInfo->seg_num != 0) ||
+        ((pInfo->flags & OTA_IMG_FLAG_ENCRYPTED) != 0 && pInfo->iv_off == 0))
+    {
+        OTA_LOGE(IMG_FORMAT);
+        return 1;
+    }
+    // 按固定地址链接的固件只能运行在其链接地址上
+    if (pInfo->has_load_addr && (pInfo->flags & OTA_IMG_FLAG_RELOC) == 0 &&
+        pInfo->load_addr != run_slot_addr + pInfo->hdr_len)
+    {
+        OTA_LOGE_HEX(IMG_LOAD_ADDR, pInfo->load_addr);
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief  开始接收一个固件: 复位流式解析状态
+ * @param  slot: 写入的目标插槽
+ */
+void OTA_ImageStreamInit(OTA_ACIVE_SLOT_E slot)
+{
+    img_stream.got           = 0;
+    img_stream.done          = OTA_FALSE;
+    img_stream.mapped        = OTA_FALSE;
+    img_stream.slot_addr     = OTA_MetaSlotAddr(slot);
+    img_stream.slot_size     = OTA_MetaSlotSize(slot);
+    img_stream.run_slot_addr = OTA_ImageRunSlotAddr(slot);
+    img_stream.sig_ok        = OTA_FALSE;
+#if OTA_SHA256_ENABLE
+    img_stream.hashing       = OTA_FALSE;
+#endif
+#if OTA_AES_ENABLE
+    img_stream.decrypting    = OTA_FALSE;
+#endif
+}
+
+/**
+ * @brief  把数据顺序写入页镜像 (调用者保证页镜像能容纳)
+ * @param  data: 数据
+ * @param  len: 数据长度
+ */
+static void Image_Store(const uint8_t *data, uint32_t len)
+{
+    OTA_U8ArryCopy(&(OTA_FlashGetMirr()[OTA_FlashGetPageOffset()]), data, len);
+    OTA_FlashSetPageOffset((uint16_t)(OTA_FlashGetPageOffset() + len));
+}
+
+/**
+ * @brief  按地址顺序计入固件体数据 (超出 img_size 的最后一包填充不计入)
+ * @param  data: 数据
+ * @param  len: 数据长度
+ */
+static void Image_Hash(const uint8_t *data, uint32_t len)
+{
+#if OTA_SHA256_ENABLE
+    if (img_stream.hashing == OTA_TRUE)
+    {
+        if (len > img_stream.info.img_size - img_stream.hashed)
+        {
+            len = img_stream.info.img_size - img_stream.hashed;
+        }
+        OTA_Sha256Update(&img_stream.sha, data, len);
+        img_stream.hashed += len;
+    }
+#else
+    (void)data;
+    (void)len;
+#endif
+}
+
+#if OTA_AES_ENABLE
+/**
+ * @brief  解密后顺序写入页镜像: 密文直接解密到页镜像中，再从页镜像计入摘要，不另设缓冲区
+ *         超出 img_size 的最后一包填充不是密文，原样保存
+ * @param  data: 密文
+ * @param  len: 数据长度 (调用者保证页镜像能容纳)
+ */
+static void Image_StoreDecrypt(const uint8_t *data, uint32_t len)
+{
+    uint8_t *pMirr = &(OTA_FlashGetMirr()[OTA_FlashGetPageOffset()]);
+    uint32_t n = img_stream.info.img_size - img_stream.dec_off;
+
+    n = (len < n) ? len : n;
+    OTA_AesCtrXor(&img_stream.aes, img_stream.dec_off, data, pMirr, n);
+    OTA_U8ArryCopy(pMirr + n, data + n, len - n);
+    img_stream.dec_off += n;
+    Image_Hash(pMirr, len);
+    OTA_FlashSetPageOffset((uint16_t)(OTA_FlashGetPageOffset() + len));
+}
+#endif
+
+/**
+ * @brief  把当前映射区间中的数据写入插槽 (加密固件按区间在固件体中的偏移分小块解密后写入)
+ * @param  data: 数据
+ * @param  len: 数据长度 (不超过区间剩余长度)
+ * @return 0: 成功, 1: 写入失败
+ */
+static int Image_Patch(const uint8_t *data, uint32_t len)
+{
+#if OTA_AES_ENABLE
+    uint8_t  plain[64];
+    uint32_t n;
+
+    if (img_stream.decrypting == OTA_TRUE)
+    {
+        while (len > 0)
+        {
+            n = (len < sizeof(plain)) ? len : sizeof(plain);
+            OTA_AesCtrXor(&img_stream.aes, img_stream.run_addr - img_stream.body_addr, data, plain, n);
+            if (OTA_FlashPatch(img_stream.run_addr, plain, n) != 0)
+            {
+                return 1;
+            }
+            Image_Hash(plain, n);
+            img_stream.run_addr += n;
+            data += n;
+            len  -= n;
+        }
+        return 0;
+    }
+#endif
+    if (OTA_FlashPatch(img_stream.run_addr, data, len) != 0)
+    {
+        return 1;
+    }
+    Image_Hash(data, len);
+    img_stream.run_addr += len;
+    return 0;
+}
+
+#if OTA_REPAIR_ENABLE
+/**
+ * @brief  读取修复流中第 idx 个分块序号
+ */
+static uint16_t Image_RepairIndex(uint32_t idx)
+{
+    uint16_t chunk;
+
+    Image_ReadStream(img_stream.info.repair_off + idx * 2U, (uint8_t *)&chunk, sizeof(chunk));
+    return chunk;
+}
+
+/**
+ * @brief  检查修复流与插槽中的固件是否一致: 基本字段相同、带分块 CRC 表、分块序号升序且有效
+ * @return 0: 通过, 1: 拒绝
+ */
+static int Image_RepairStart(void)
+{
+    OTA_IMG_INFO_E *pSlot = &img_stream.slot_info;
+    uint32_t chunk;
+    uint32_t prev = 0;
+
+    // 已重定位的固件与原始分块 CRC 不一致，不支持修复
+    if (OTA_ImageLoad(img_stream.slot_addr, pSlot) != OTA_TRUE ||
+        pSlot->img_size != img_stream.info.img_size || pSlot->version != img_stream.info.version ||
+        pSlot->img_crc16 != img_stream.info.img_crc16 || pSlot->chunk_num == 0 ||
+        (pSlot->flags & OTA_IMG_FLAG_RELOC) != 0)
+    {
+        OTA_LOGE(REPAIR_MISMATCH);
+        return 1;
+    }
+    for (uint32_t idx = 0; idx < img_stream.info.repair_num; idx++)
+    {
+        chunk = Image_RepairIndex(idx);
+        if (chunk >= pSlot->chunk_num || (idx > 0 && chunk <= prev))
+        {
+            OTA_LOGE(REPAIR_MISMATCH);
+            return 1;
+        }
+        prev = chunk;
+    }
+
+    img_stream.mapped    = OTA_TRUE;
+    img_stream.run_idx   = 0;
+    img_stream.run_left  = 0;
+    img_stream.fill_addr = 0;
+    img_stream.body_addr = img_stream.slot_addr + pSlot->hdr_len;
+    OTA_LOGI_HEX(REPAIR_START, img_stream.info.repair_num);
+    return 0;
+}
+#endif
+
+/**
+ * @brief  读取段表中第 idx 段
+ * @param  seg: 输出 {偏移, 长度}
+ */
+static void Image_Segment(uint32_t idx, uint32_t seg[2])
+{
+    Image_ReadStream(img_stream.info.seg_off + idx * 8U, (uint8_t *)seg, 8U);
+}
+
+/**
+ * @brief  检查段表: 各段非空、升序不重叠且位于固件体内
+ * @return 0: 通过, 1: 拒绝
+ */
+static int Image_SegmentStart(void)
+{
+    uint32_t seg[2];
+    uint32_t end = 0;
+    uint32_t total = 0;
+
+    for (uint32_t idx = 0; idx < img_stream.info.seg_num; idx++)
+    {
+        Image_Segment(idx, seg);
+        if (seg[1] == 0 || seg[0] < end || seg[0] > img_stream.info.img_size ||
+            seg[1] > img_stream.info.img_size - seg[0])
+        {
+            OTA_LOGE(IMG_FORMAT);
+            return 1;
+        }
+        end = seg[0] + seg[1];
+        total += seg[1];
+    }
+
+    img_stream.mapped    = OTA_TRUE;
+    img_stream.run_idx   = 0;
+    img_stream.run_left  = 0;
+    img_stream.fill_addr = img_stream.slot_addr + img_stream.info.hdr_len;
+    img_stream.body_addr = img_stream.fill_addr;
+    OTA_LOGI_HEX(IMG_SEGMENTS, img_stream.info.hdr_len + total);
+    return 0;
+}
+
+/**
+ * @brief  取下一个映射区间
+ * @return OTA_TRUE: 还有区间
+ */
+static OTA_BOOL Image_NextRun(void)
+{
+    uint32_t seg[2];
+#if OTA_REPAIR_ENABLE
+    OTA_IMG_INFO_E *pSlot = &img_stream.slot_info;
+    uint32_t off;
+
+    if (img_stream.info.repair_num > 0)
+    {
+        if (img_stream.run_idx >= img_stream.info.repair_num)
+        {
+            return OTA_FALSE;
+        }
+        off = Image_RepairIndex(img_stream.run_idx++) * pSlot->chunk_size;
+        img_stream.run_addr = img_stream.body_addr + off;
+        img_stream.run_left = (pSlot->img_size - off < pSlot->chunk_size) ? pSlot->img_size - off : pSlot->chunk_size;
+        return OTA_TRUE;
+    }
+#endif
+    if (img_stream.run_idx >= img_stream.info.seg_num)
+    {
+        return OTA_FALSE;
+    }
+    Image_Segment(img_stream.run_idx++, seg);
+    img_stream.run_addr = img_stream.body_addr + seg[0];
+    img_stream.run_left = seg[1];
+    return OTA_TRUE;
+}
+
+/**
+ * @brief  分段固件: 从已写入的位置到 end 之间填充 0xFF (不填充时直接返回)
+ * @param  end: 填充结束地址 (不含)
+ * @return 0: 成功, 1: 写入失败
+ */
+static int Image_Fill(uint32_t end)
+{
+    uint8_t  ff[64];
+    uint32_t n;
+
+    OTA_MemSet(ff, 0xFF, sizeof(ff));
+    while (img_stream.fill_addr != 0 && img_stream.fill_addr < end)
+    {
+        n = (end - img_stream.fill_addr < sizeof(ff)) ? end - img_stream.fill_addr : sizeof(ff);
+        if (OTA_FlashPatch(img_stream.fill_addr, ff, n) != 0)
+        {
+            return 1;
+        }
+        Image_Hash(ff, n);
+        img_stream.fill_addr += n;
+    }
+    return 0;
+}
+
+/**
+ * @brief  写入固件头之后的数据
+ * @param  data: 数据
+ * @param  len: 数据长度
+ * @return OTA_IMG_FEED_OK / OTA_IMG_FEED_REJECT
+ */
+static int Image_Write(const uint8_t *data, uint32_t len)
+{
+    uint32_t n;
+
+    if (img_stream.mapped != OTA_TRUE)
+    {
+#if OTA_AES_ENABLE
+        if (img_stream.decrypting == OTA_TRUE)
+        {
+            Image_StoreDecrypt(data, len);
+            return OTA_IMG_FEED_OK;
+        }
+#endif
+        Image_Hash(data, len);
+        Image_Store(data, len);
+        return OTA_IMG_FEED_OK;
+    }
+
+    while (len > 0)
+    {
+        if (img_stream.run_left == 0)
+        {
+            if (Image_NextRun() != OTA_TRUE)
+            {
+                // 区间之后为最后一包的填充
+                break;
+            }
+            if (Image_Fill(img_stream.run_addr) != 0)
+            {
+                return OTA_IMG_FEED_REJECT;
+            }
+        }
+        n = (img_stream.run_left < len) ? img_stream.run_left : len;
+        if (Image_Patch(data, n) != 0)
+        {
+            return OTA_IMG_FEED_REJECT;
+        }
+        img_stream.run_left -= n;
+        data += n;
+        len  -= n;
+        if (img_stream.fill_addr != 0)
+        {
+            img_stream.fill_addr = img_stream.run_addr;
+            // 最后一段之后直到固件体结束的空隙
+            if (img_stream.run_left == 0 && img_stream.run_idx == img_stream.info.seg_num &&
+                Image_Fill(img_stream.body_addr + img_stream.info.img_size) != 0)
+            {
+                return OTA_IMG_FEED_REJECT;
+            }
+        }
+    }
+    return OTA_IMG_FEED_OK;
+}
+
+/**
+ * @brief  固件头收齐: 检查并决定写入方式，完整固件的固件头写入页镜像
+ * @return OTA_IMG_FEED_OK / OTA_IMG_FEED_REJECT
+ */
+static int Image_StreamStart(void)
+{
+    if (OTA_ImageCheck(&img_stream.info, img_stream.slot_size, img_stream.run_slot_addr) != 0)
+    {
+        return OTA_IMG_FEED_REJECT;
+    }
+#if OTA_AES_ENABLE
+    // 修复流同样可以加密，分块按其在固件体中的偏移解密
+    if (img_stream.info.flags & OTA_IMG_FLAG_ENCRYPTED)
+    {
+        OTA_AesCtrInit(&img_stream.aes, img_aes_key, &img_stream.buf[img_stream.info.iv_off]);
+        img_stream.decrypting = OTA_TRUE;
+        img_stream.dec_off    = 0;
+        OTA_LOGI(IMG_DECRYPT);
+    }
+#endif
+#if OTA_REPAIR_ENABLE
+    if (img_stream.info.repair_num > 0)
+    {
+        // 修复流的固件头不写入，插槽中已有相同的固件头; 只含部分分块，不计算摘要
+        return (Image_RepairStart() == 0) ? OTA_IMG_FEED_OK : OTA_IMG_FEED_REJECT;
+    }
+#endif
+#if OTA_SIG_ENABLE
+    if (img_stream.info.hash_off == 0 || img_stream.info.sig_off == 0)
+    {
+        OTA_LOGE(IMG_UNSIGNED);
+        return OTA_IMG_FEED_REJECT;
+    }
+#endif
+#if OTA_SHA256_ENABLE
+    img_stream.hashing = (img_stream.info.hash_off != 0) ? OTA_TRUE : OTA_FALSE;
+    img_stream.hashed  = 0;
+    OTA_Sha256Init(&img_stream.sha);
+#endif
+    Image_Store(img_stream.buf, img_stream.info.hdr_len);
+    OTA_LOGI_HEX(IMG_HEADER, img_stream.info.hdr_len + img_stream.info.img_size);
+    // 分段固件的固件头已在页镜像中，各段从页镜像中的当前页开始按映射写入
+    if (img_stream.info.seg_num > 0)
+    {
+        return (Image_SegmentStart() == 0) ? OTA_IMG_FEED_OK : OTA_IMG_FEED_REJECT;
+    }
+    return OTA_IMG_FEED_OK;
+}
+
+/**
+ * @brief  按顺序送入接收到的固件数据，固件头收齐后立即检查
+ * @param  data: 数据
+ * @param  len: 数据长度
+ * @return OTA_IMG_FEED_OK / OTA_IMG_FEED_REJECT
+ */
+int OTA_ImageStreamFeed(const uint8_t *data, uint32_t len)
+{
+    OTA_APP_IMG_HEADER_E header;
+    uint32_t need;
+    uint32_t n;
+
+    // 固件头收齐之前只缓存 (最多跨两个 128 字节包)，页镜像保持为空
+    while (img_stream.done != OTA_TRUE)
+    {
+        if (len == 0)
+        {
+            return OTA_IMG_FEED_OK;
+        }
+        // 先收齐 16 字节基本字段，v2 再按 hdr_len 收齐扩展区
+        need = (img_stream.got < sizeof(header)) ? sizeof(header) : img_stream.info.hdr_len;
+        n = (need - img_stream.got < len) ? need - img_stream.got : len;
+        OTA_MemCopy(&img_stream.buf[img_stream.got], data, n);
+        img_stream.got += n;
+        data += n;
+        len  -= n;
+        if (img_stream.got < need)
+        {
+            return OTA_IMG_FEED_OK;
+        }
+
+        if (need == sizeof(header))
+        {
+            OTA_MemCopy((uint8_t *)&header, img_stream.buf, sizeof(header));
+            if (Image_ParseBase(&header, &img_stream.info) != OTA_TRUE)
+            {
+                OTA_LOGE(IMG_FORMAT);
+                return OTA_IMG_FEED_REJECT;
+            }
+            if (img_stream.info.hdr_len > sizeof(header))
+            {
+                continue;
+            }
+        }
+
+        if (Image_ParseTlv(&img_stream.info, Image_ReadStream) != OTA_TRUE)
+        {
+            OTA_LOGE(IMG_FORMAT);
+            return OTA_IMG_FEED_REJECT;
+        }
+        img_stream.done = OTA_TRUE;
+        if (Image_StreamStart() != OTA_IMG_FEED_OK)
+        {
+            return OTA_IMG_FEED_REJECT;
+        }
+    }
+    return Image_Write(data, len);
+}
+
+/**
+ * @brief  传输结束 (收到 EOT): 比对流式计算的摘要与固件头中的摘要，再验证签名
+ * @return OTA_IMG_FEED_OK / OTA_IMG_FEED_REJECT
+ */
+int OTA_ImageStreamEnd(void)
+{
+#if OTA_SHA256_ENABLE
+    uint8_t  digest[OTA_SHA256_DIGEST_SIZE];
+    uint8_t  diff = 0;
+
+    if (img_stream.done != OTA_TRUE || img_stream.hashing != OTA_TRUE)
+    {
+        return OTA_IMG_FEED_OK;
+    }
+    img_stream.hashing = OTA_FALSE;
+    OTA_Sha256Final(&img_stream.sha, digest);
+    for (uint32_t i = 0; i < OTA_SHA256_DIGEST_SIZE; i++)
+    {
+        diff |= digest[i] ^ img_stream.buf[img_stream.info.hash_off + i];
+    }
+    // 固件体未收全时已计算的字节数少于 img_size，摘要必然不符
+    if (diff != 0 || img_stream.hashed != img_stream.info.img_size)
+    {
+        OTA_LOGE_HEX(IMG_HASH, img_stream.hashed);
+        return OTA_IMG_FEED_REJECT;
+    }
+    OTA_LOGI(IMG_HASH_OK);
+#if OTA_SIG_ENABLE
+    // 摘要覆盖固件体，签名覆盖含摘要的固件头
+    if (OTA_SigVerifyHeader(img_stream.buf, &img_stream.info) != 0)
+    {
+        OTA_LOGE_HEX(SIG_BAD, img_stream.slot_addr);
+        return OTA_IMG_FEED_REJECT;
+    }
+    OTA_LOGI_HEX(SIG_OK, img_stream.slot_addr);
+    img_stream.sig_ok = OTA_TRUE;
+#endif
+#endif
+    return OTA_IMG_FEED_OK;
+}
+
+/**
+ * @brief  刚接收完的固件是否已通过签名验证
+ * @return OTA_TRUE: 已验证
+ */
+OTA_BOOL OTA_ImageStreamSigned(void)
+{
+    return img_stream.sig_ok;
+}
+
+/**
+ * @brief  当前接收的数据是否按映射写入
+ * @return OTA_TRUE: 按映射写入
+ */
+OTA_BOOL OTA_ImageStreamMapped(void)
+{
+    return img_stream.mapped;
+}
+
+/**
+ * @brief  获取流式解析得到的固件头信息
+ * @return 固件头信息，固件头尚未收齐时为 NULL
+ */
+const OTA_IMG_INFO_E *OTA_ImageStreamInfo(void)
+{
+    return (img_stream.done == OTA_TRUE) ? &img_stream.info : 0;
+}
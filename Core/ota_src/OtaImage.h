@@ -0,0 +1,198 @@
+/**
+ ******************************************************************************
+ * @file    OtaImage.h
+ * @author  MiniOTA Team
+ * @brief   固件头解析头文件
+ *          v1 固件头为 16 字节的 OTA_APP_IMG_HEADER_E; v2 固件头使用新的魔数，
+ *          基本字段不变，hdr_len 给出含 TLV 扩展区的总长度，固件体紧随其后。
+ *          接收时逐包解析，固件头收齐后即可检查大小、特性与链接地址，无需等待传输结束;
+ *          分段固件只传输各段的数据，段之间的空隙在插槽中写为 0xFF;
+ *          加密固件传输 AES-128-CTR 密文，写入前按固件体内的偏移解密
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 MiniOTA.
+ * All rights reserved.
+ *
+ ******************************************************************************
+ */
+
+#ifndef OTAIMAGE_H
+#define OTAIMAGE_H
+
+#include "OtaInterface.h"
+#include "OtaUtils.h"
+
+/** v2 固件头的最大长度 (字节)，接收时在 RAM 中缓存整个固件头; 须不大于 Flash 页大小 - 128 */
+#ifndef OTA_IMG_HDR_MAX
+#define OTA_IMG_HDR_MAX     256U
+#endif
+
+/**
+ * @brief TLV 项头部 (值紧随其后，下一项从 4 字节对齐处开始)
+ */
+typedef struct __OTA_IMG_TLV
+{
+    uint8_t  type;          /**< OTA_TLV_xxx，0 为填充; 最高位为 1 的类型不认识时拒绝固件 */
+    uint8_t  reserved;      /**< 保留字段 */
+    uint16_t len;           /**< 值的长度 (不含本结构) */
+} OTA_IMG_TLV_E;
+
+/** @defgroup OTA_Image_TLV_Types
+ * @{
+ */
+#define OTA_TLV_PAD         0x00U   /**< 填充，忽略 */
+#define OTA_TLV_LOAD_ADDR   0x01U   /**< uint32_t 固件体的链接地址 (带重定位表时为重定位基址) */
+#define OTA_TLV_ENTRY       0x02U   /**< uint32_t 向量表相对固件体起始的偏移 */
+#define OTA_TLV_HASH        0x03U   /**< 32 字节 SHA-256 摘要 (固件体，分段固件为含 0xFF 空隙的连续固件体) */
+#define OTA_TLV_CHUNKS      0x04U   /**< uint32_t 分块大小 + 每块一个 uint16_t CRC16 */
+#define OTA_TLV_SIGNATURE   0x05U   /**< 64 字节 Ed25519 签名 (固件头，img_crc16 与签名值按 0 计算) */
+#define OTA_TLV_IV          0x06U   /**< 16 字节 AES-128-CTR 初始计数块，置 OTA_IMG_FLAG_ENCRYPTED 时必须给出 */
+#define OTA_TLV_FLAGS       0x81U   /**< uint32_t OTA_IMG_FLAG_xxx，不认识时须拒绝 */
+#define OTA_TLV_REPAIR      0x82U   /**< 修复流: 升序的 uint16_t 分块序号，固件头之后依次为这些分块的数据 */
+#define OTA_TLV_SEGMENTS    0x83U   /**< 分段固件: {uint32_t 偏移, uint32_t 长度} 数组 (相对固件体起始，升序不重叠)，
+                                         固件头之后依次为各段的数据，须同时置 OTA_IMG_FLAG_SEGMENTED */
+#define OTA_TLV_CRITICAL    0x80U   /**< 类型最高位: 必须理解的 TLV */
+/**
+ * @}
+ */
+
+/** @defgroup OTA_Image_Flags
+ * @{
+ */
+#define OTA_IMG_FLAG_RELOC      0x00000001UL    /**< 固件尾部带重定位表 */
+#define OTA_IMG_FLAG_COMPRESSED 0x00000002UL    /**< 固件体经过压缩 */
+#define OTA_IMG_FLAG_DELTA      0x00000004UL    /**< 固件体为相对旧固件的差分 */
+#define OTA_IMG_FLAG_ENCRYPTED  0x00000008UL    /**< 传输的固件体经过 AES-128-CTR 加密 (插槽中保存明文) */
+#define OTA_IMG_FLAG_SEGMENTED  0x00000010UL    /**< 固件体由多个段组成 (OTA_TLV_SEGMENTS) */
+
+/** 当前配置支持的特性，固件带有其他特性时在收到固件头后即拒绝 */
+#if OTA_RELOC_ENABLE
+#define OTA_IMG_FLAGS_RELOC     OTA_IMG_FLAG_RELOC
+#else
+#define OTA_IMG_FLAGS_RELOC     0UL
+#endif
+#if OTA_AES_ENABLE
+#define OTA_IMG_FLAGS_AES       OTA_IMG_FLAG_ENCRYPTED
+#else
+#define OTA_IMG_FLAGS_AES       0UL
+#endif
+#define OTA_IMG_FLAGS_SUPPORTED (OTA_IMG_FLAGS_RELOC | OTA_IMG_FLAGS_AES | OTA_IMG_FLAG_SEGMENTED)
+/**
+ * @}
+ */
+
+/**
+ * @brief 解析后的固件头信息
+ */
+typedef struct __OTA_IMG_INFO
+{
+    uint32_t hdr_len;       /**< 固件头总长度，固件体从插槽起始 + hdr_len 处开始 */
+    uint32_t img_size;      /**< 固件体大小 */
+    uint32_t version;       /**< 版本号 */
+    uint16_t img_crc16;     /**< v1: 固件体的 CRC16; v2: TLV 扩展区 + 固件体的 CRC16 */
+    uint8_t  hdr_ver;       /**< 固件头版本 (1/2) */
+    uint8_t  has_load_addr; /**< 是否给出了 OTA_TLV_LOAD_ADDR */
+    uint32_t load_addr;     /**< 固件体的链接地址 */
+    uint32_t entry;         /**< 向量表相对固件体起始的偏移 (默认 0) */
+    uint32_t flags;         /**< OTA_IMG_FLAG_xxx */
+    uint16_t hash_off;      /**< SHA-256 摘要在固件头中的偏移，0 表示没有 */
+    uint16_t sig_off;       /**< 签名在固件头中的偏移，0 表示没有 */
+    uint16_t iv_off;        /**< 初始计数块在固件头中的偏移，0 表示没有 */
+    uint16_t chunk_off;     /**< 分块 CRC 表在固件头中的偏移，0 表示没有 */
+    uint32_t chunk_size;    /**< 分块大小 */
+    uint32_t chunk_num;     /**< 分块数 */
+    uint16_t repair_off;    /**< 修复流中分块序号表在固件头中的偏移 */
+    uint16_t repair_num;    /**< 修复流中的分块数，0 表示完整固件 */
+    uint16_t seg_off;       /**< 段表在固件头中的偏移 */
+    uint16_t seg_num;       /**< 段数，0 表示固件体连续传输 */
+} OTA_IMG_INFO_E;
+
+/** @defgroup OTA_Image_Feed_Result
+ * @{
+ */
+#define OTA_IMG_FEED_OK       0     /**< 数据已写入页镜像，继续接收 */
+#define OTA_IMG_FEED_REJECT   1     /**< 固件被拒绝或写入失败，应取消传输 */
+/**
+ * @}
+ */
+
+/**
+ * @brief  读取并解析插槽中的固件头 (v1/v2)
+ * @param  slot_addr: 插槽起始地址
+ * @param  pInfo: 输出的固件头信息
+ * @return OTA_TRUE: 固件头格式有效 (不检查大小与 CRC)
+ */
+OTA_BOOL OTA_ImageLoad(uint32_t slot_addr, OTA_IMG_INFO_E *pInfo);
+
+/**
+ * @brief  获取插槽中固件的运行插槽地址
+ *         外部暂存、压缩备份与交换安装时固件总是运行在 Slot A
+ * @param  slot: 固件所在插槽
+ * @return 运行插槽的起始地址
+ */
+uint32_t OTA_ImageRunSlotAddr(OTA_ACIVE_SLOT_E slot);
+
+/**
+ * @brief  获取固件的向量表地址 (插槽起始 + hdr_len + entry)
+ * @param  slot_addr: 插槽起始地址
+ * @return 向量表地址，固件头无效时按 v1 固件头计算
+ */
+uint32_t OTA_ImageEntryAddr(uint32_t slot_addr);
+
+/**
+ * @brief  检查固件头是否适合写入插槽: 大小、特性、链接地址
+ * @param  pInfo: 固件头信息
+ * @param  slot_size: 目标插槽大小
+ * @param  run_slot_addr: 固件运行插槽的起始地址
+ * @return 0: 通过, 1: 拒绝 (已输出错误日志)
+ */
+int OTA_ImageCheck(const OTA_IMG_INFO_E *pInfo, uint32_t slot_size, uint32_t run_slot_addr);
+
+/**
+ * @brief  开始接收一个固件: 复位流式解析状态
+ * @param  slot: 写入的目标插槽
+ */
+void OTA_ImageStreamInit(OTA_ACIVE_SLOT_E slot);
+
+/**
+ * @brief  按顺序送入接收到的固件数据 (每个新包一次)，固件头收齐后立即检查
+ *         固件头收齐之前数据只缓存; 之后完整固件顺序写入页镜像 (页满由调用者写回)，
+ *         修复流与分段固件按分块序号或段表经 OTA_FlashPatch 写入插槽中对应的位置;
+ *         加密固件在写入页镜像 (或 OTA_FlashPatch) 的同时解密，不另外读写 Flash
+ * @param  data: 数据
+ * @param  len: 数据长度
+ * @return OTA_IMG_FEED_OK / OTA_IMG_FEED_REJECT
+ */
+int OTA_ImageStreamFeed(const uint8_t *data, uint32_t len);
+
+/**
+ * @brief  传输结束 (收到 EOT) 时调用: OTA_SHA256_ENABLE 且固件头带摘要时比对接收过程中计算的摘要，
+ *         OTA_SIG_ENABLE 时摘要一致后再验证固件头的签名
+ *         修复流与不带摘要的固件直接通过 (OTA_SIG_ENABLE 时不带签名的完整固件在固件头收齐时已被拒绝)
+ * @return OTA_IMG_FEED_OK: 通过, OTA_IMG_FEED_REJECT: 摘要不符或签名无效 (已输出错误日志)，应取消传输
+ */
+int OTA_ImageStreamEnd(void);
+
+/**
+ * @brief  刚接收完的固件是否已在 OTA_ImageStreamEnd 中通过签名验证
+ *         为真时调用者可在 Meta 中把目标插槽记为已验证，启动时不必再从插槽读出固件体验证;
+ *         修复流只改写了部分分块，始终为假
+ * @return OTA_TRUE: 已验证
+ */
+OTA_BOOL OTA_ImageStreamSigned(void);
+
+/**
+ * @brief  当前接收的数据是否按映射写入 (不是从插槽起始顺序写入)
+ *         为真时页镜像由本模块写回，调用者不必在页满前提交
+ * @return OTA_TRUE: 按映射写入
+ */
+OTA_BOOL OTA_ImageStreamMapped(void);
+
+/**
+ * @brief  获取流式解析得到的固件头信息
+ * @return 固件头信息，固件头尚未收齐时为 NULL
+ */
+const OTA_IMG_INFO_E *OTA_ImageStreamInfo(void);
+
+#endif
@@ -16,6 +16,8 @@
 #include "OtaInterface.h"
 #include "OtaUtils.h"
 #include "OtaPort.h"
+#include "OtaLog.h"
+#include "OtaBdev.h"
 
 /**
  * @brief  检查应用向量表的 SP 和 PC 是否有效
@@ -25,6 +27,38 @@
  */
 OTA_APP_CHECK_RESULT_E OTA_IsAppValid(uint32_t app_sp, uint32_t app_pc);
 
+#if OTA_RAMFUNC_ENABLE
+/** IAP 期间使用的 SRAM 向量表 */
+static uint32_t ram_vectors[OTA_VECTOR_NUM] __attribute__((aligned(OTA_VECTOR_ALIGN)));
+#endif
+
+/**
+ * @brief  将当前向量表复制到 SRAM 并重定位 VTOR
+ *         IAP 开始前调用，Flash 擦写期间取中断向量不会被阻塞；
+ *         跳转 App 时 VTOR 会被重新设置为 App 的向量表
+ */
+void OTA_VectorToRam(void)
+{
+#if OTA_RAMFUNC_ENABLE
+	uint32_t primask;
+	const uint32_t *src = (const uint32_t *)SCB->VTOR;
+	
+	if (SCB->VTOR == (uint32_t)ram_vectors)
+	{
+		return;
+	}
+	
+	OTA_ENTER_CRITICAL(primask);
+	for (uint32_t i = 0; i < OTA_VECTOR_NUM; i++)
+	{
+		ram_vectors[i] = src[i];
+	}
+	SCB->VTOR = (uint32_t)ram_vectors;
+	__DSB();
+	OTA_EXIT_CRITICAL(primask);
+#endif
+}
+
 /**
  * @brief  跳转到目标应用
  * @param  des_addr: 目标应用起始地址（向量表地址）
@@ -35,6 +69,8 @@ void OTA_JumpToApp(uint32_t des_addr)
     uint32_t app_reset;
     pFunction app_entry;
 	
+	// 0. 等待缓冲区中的日志发送完毕
+	OTA_LogFlush();
 	// 1. 关中断
     __disable_irq();
 	// 2. 关闭外设
@@ -43,19 +79,21 @@ void OTA_JumpToApp(uint32_t des_addr)
     SysTick->CTRL = 0;
     SysTick->LOAD = 0;
     SysTick->VAL  = 0;
+	// 4. 恢复复位默认时钟，App 的 SystemInit 按冷启动方式重新配置
+	OTA_ClockRestore();
 	
-	// 4. 读取应用向量表的 SP 和 Reset_Handler
-    app_sp    = *(uint32_t *)des_addr;
-    app_reset = *(uint32_t *)(des_addr + 4);
+	// 5. 读取应用向量表的 SP 和 Reset_Handler
+    OTA_BdevRead(des_addr, (uint8_t *)&app_sp, sizeof(app_sp));
+    OTA_BdevRead(des_addr + 4, (uint8_t *)&app_reset, sizeof(app_reset));
 	
-	// 5. 检查应用的有效性（可选，用于调试）
+	// 6. 检查应用的有效性（可选，用于调试）
 	OTA_IsAppValid(app_sp, app_reset);
 	
-	// 6. 设置中断向量表到 App 区
+	// 7. 设置中断向量表到 App 区
     SCB->VTOR = des_addr;
-	// 7. 设置主栈指针
+	// 8. 设置主栈指针
     __set_MSP(app_sp);
-	// 8. 跳转到应用复位处理函数
+	// 9. 跳转到应用复位处理函数
     app_entry = (pFunction)app_reset;
     app_entry();
 }
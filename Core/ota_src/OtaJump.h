@@ -31,5 +31,11 @@ void OTA_JumpToApp(uint32_t des_addr);
  * @return 检查结果枚举
  */
 OTA_APP_CHECK_RESULT_E OTA_IsAppValid(uint32_t app_sp, uint32_t app_pc);
+
+/**
+ * @brief  将当前向量表复制到 SRAM 并重定位 VTOR (OTA_RAMFUNC_ENABLE 为 0 时为空操作)
+ *         IAP 开始前调用，Flash 擦写期间取中断向量不会被阻塞
+ */
+void OTA_VectorToRam(void);
 	
 #endif
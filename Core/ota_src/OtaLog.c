@@ -0,0 +1,311 @@
+/**
+ ******************************************************************************
+ * @file    OtaLog.c
+ * @author  MiniOTA Team
+ * @brief   调试日志模块实现
+ *          单生产者临界区写入 + 中断单消费者读出的环形缓冲区，
+ *          写日志只做内存拷贝，实际发送由调试串口 TXE 中断或 DMA 完成；
+ *          日志文本来自 OtaLogDict.h，令牌模式下只写入 ID 与参数
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 MiniOTA.
+ * All rights reserved.
+ *
+ ******************************************************************************
+ */
+
+#include "OtaInterface.h"
+#include "OtaPort.h"
+#include "OtaUtils.h"
+#include "OtaLog.h"
+
+#define LOG_MASK    (OTA_LOG_BUF_SIZE - 1U)
+
+/** 日志环形缓冲区 */
+static uint8_t log_buf[OTA_LOG_BUF_SIZE];
+
+/** 写指针 (仅在临界区内修改) */
+static volatile uint16_t log_head;
+
+/** 读指针 (仅由发送中断/DMA 完成回调修改) */
+static volatile uint16_t log_tail;
+
+/** 丢弃计数 */
+static volatile uint32_t log_drop;
+
+/**
+ * @brief  计算字符串长度
+ * @param  str: 字符串
+ * @return 长度
+ */
+static uint16_t Log_StrLen(const char *str)
+{
+    uint16_t len = 0;
+    while (str[len] != '\0')
+    {
+        len++;
+    }
+    return len;
+}
+
+/**
+ * @brief  获取缓冲区剩余空间 (保留一个字节区分空/满)
+ * @return 剩余字节数
+ */
+static uint16_t Log_Free(void)
+{
+    return (uint16_t)(LOG_MASK - ((log_head - log_tail) & LOG_MASK));
+}
+
+/**
+ * @brief  向缓冲区追加数据，调用者需保证处于临界区且空间足够
+ * @param  src: 源数据
+ * @param  len: 长度
+ */
+static void Log_Push(const uint8_t *src, uint16_t len)
+{
+    uint16_t head = log_head;
+    while (len--)
+    {
+        log_buf[head] = *src++;
+        head = (head + 1U) & LOG_MASK;
+    }
+    log_head = head;
+}
+
+/**
+ * @brief  写入一条字符串日志到环形缓冲区 (中断与主循环中均可调用)
+ * @param  str: 以 '\0' 结尾的字符串
+ * @return 1: 写入成功, 0: 缓冲区空间不足，整条日志被丢弃
+ */
+uint8_t OTA_LogWrite(const char *str)
+{
+    uint32_t primask;
+    uint16_t len;
+
+    if (str == 0) return 0;
+    len = Log_StrLen(str);
+
+    OTA_ENTER_CRITICAL(primask);
+    if (Log_Free() < len)
+    {
+        log_drop++;
+        OTA_EXIT_CRITICAL(primask);
+        return 0;
+    }
+    Log_Push((const uint8_t *)str, len);
+    OTA_EXIT_CRITICAL(primask);
+
+    OTA_DebugTxStart();
+    return 1;
+}
+
+#if !OTA_LOG_TOKENIZED
+#define LOG_DICT_TEXT(name, text)   text,
+#define LOG_DICT_NONE(name, text)   0,
+
+/** 日志文本表，按 ID 索引，被裁剪等级的文本不会链接进固件 */
+static const char *const log_text[OTA_LOG_ID_MAX] = {
+#if OTA_LOG_LEVEL >= OTA_LOG_LVL_ERROR
+    OTA_LOG_DICT_ERROR(LOG_DICT_TEXT)
+#else
+    OTA_LOG_DICT_ERROR(LOG_DICT_NONE)
+#endif
+#if OTA_LOG_LEVEL >= OTA_LOG_LVL_INFO
+    OTA_LOG_DICT_INFO(LOG_DICT_TEXT)
+#else
+    OTA_LOG_DICT_INFO(LOG_DICT_NONE)
+#endif
+#if OTA_LOG_LEVEL >= OTA_LOG_LVL_DEBUG
+    OTA_LOG_DICT_DEBUG(LOG_DICT_TEXT)
+#else
+    OTA_LOG_DICT_DEBUG(LOG_DICT_NONE)
+#endif
+};
+
+static const char log_prefix_err[]  = "[OTA][Error]:";
+static const char log_prefix_info[] = "[OTA]:";
+#endif
+
+/**
+ * @brief  按字典 ID 写入一条带多个参数的日志 (高于 OTA_LOG_LEVEL 的等级不输出)
+ * @param  level: 日志等级
+ * @param  id: 日志 ID
+ * @param  argc: 参数个数 (不超过 OTA_LOG_MAX_ARGS)
+ * @param  args: 32位参数数组
+ * @return 1: 写入成功, 0: 缓冲区空间不足、参数非法或等级被关闭
+ */
+uint8_t OTA_LogIdArgs(uint8_t level, OTA_LOG_ID_E id, uint8_t argc, const uint32_t *args)
+{
+    uint32_t primask;
+
+    if (level > OTA_LOG_LEVEL || id >= OTA_LOG_ID_MAX || argc > OTA_LOG_MAX_ARGS) return 0;
+
+#if OTA_LOG_TOKENIZED
+    /* SYNC + ID + 参数个数 + 小端参数 */
+    uint8_t frame[3 + 4 * OTA_LOG_MAX_ARGS];
+    uint16_t len = 3;
+
+    frame[0] = OTA_LOG_TOKEN_SYNC;
+    frame[1] = (uint8_t)id;
+    frame[2] = argc;
+    for (uint8_t i = 0; i < argc; i++)
+    {
+        frame[len++] = (uint8_t)(args[i]);
+        frame[len++] = (uint8_t)(args[i] >> 8);
+        frame[len++] = (uint8_t)(args[i] >> 16);
+        frame[len++] = (uint8_t)(args[i] >> 24);
+    }
+
+    OTA_ENTER_CRITICAL(primask);
+    if (Log_Free() < len)
+    {
+        log_drop++;
+        OTA_EXIT_CRITICAL(primask);
+        return 0;
+    }
+    Log_Push(frame, len);
+    OTA_EXIT_CRITICAL(primask);
+#else
+    /* 前缀 + 文本 + [0xXXXXXXXX[ 0xXXXXXXXX...]] + "\r\n" */
+    const char *text = log_text[id];
+    const char *prefix = (level == OTA_LOG_LVL_ERROR) ? log_prefix_err : log_prefix_info;
+    uint8_t tail[11 * OTA_LOG_MAX_ARGS + 2];
+    uint16_t tail_len = 0;
+    uint16_t prefix_len;
+    uint16_t text_len;
+
+    if (text == 0) return 0;
+    prefix_len = Log_StrLen(prefix);
+    text_len = Log_StrLen(text);
+
+    for (uint8_t a = 0; a < argc; a++)
+    {
+        if (a > 0)
+        {
+            tail[tail_len++] = ' ';
+        }
+        tail[tail_len++] = '0';
+        tail[tail_len++] = 'x';
+        for (int i = 0; i < 8; i++)
+        {
+            uint8_t nibble = (args[a] >> (28 - i * 4)) & 0xF;
+            tail[tail_len++] = (nibble < 10) ? ('0' + nibble) : ('A' + (nibble - 10));
+        }
+    }
+    tail[tail_len++] = '\r';
+    tail[tail_len++] = '\n';
+
+    OTA_ENTER_CRITICAL(primask);
+    if (Log_Free() < prefix_len + text_len + tail_len)
+    {
+        log_drop++;
+        OTA_EXIT_CRITICAL(primask);
+        return 0;
+    }
+    Log_Push((const uint8_t *)prefix, prefix_len);
+    Log_Push((const uint8_t *)text, text_len);
+    Log_Push(tail, tail_len);
+    OTA_EXIT_CRITICAL(primask);
+#endif
+
+    OTA_DebugTxStart();
+    return 1;
+}
+
+/**
+ * @brief  按字典 ID 写入一条日志 (通常通过 OTA_LOGx 宏调用)
+ * @param  level: 日志等级
+ * @param  id: 日志 ID
+ * @param  argc: 参数个数 (0 或 1)
+ * @param  arg: 32位参数
+ * @return 1: 写入成功, 0: 缓冲区空间不足
+ */
+uint8_t OTA_LogId(uint8_t level, OTA_LOG_ID_E id, uint8_t argc, uint32_t arg)
+{
+    return OTA_LogIdArgs(level, id, argc ? 1 : 0, &arg);
+}
+
+/**
+ * @brief  调试串口发送中断回调: 取出下一个待发送字节
+ * @param  byte: 输出的待发送字节
+ * @return 1: 取到字节, 0: 缓冲区已空 (此时应关闭 TXE 中断)
+ */
+uint8_t OTA_DebugTxTask(uint8_t *byte)
+{
+    uint16_t tail = log_tail;
+
+    if (tail == log_head)
+    {
+        return 0;
+    }
+    *byte = log_buf[tail];
+    log_tail = (tail + 1U) & LOG_MASK;
+    return 1;
+}
+
+/**
+ * @brief  获取一段连续的待发送数据 (用于 DMA 发送)
+ * @param  buf: 输出的数据起始指针
+ * @return 连续可发送的字节数, 0 表示缓冲区为空
+ */
+uint16_t OTA_DebugTxGetBlock(const uint8_t **buf)
+{
+    uint16_t head = log_head;
+    uint16_t tail = log_tail;
+
+    *buf = &log_buf[tail];
+    if (head >= tail)
+    {
+        return (uint16_t)(head - tail);
+    }
+    return (uint16_t)(OTA_LOG_BUF_SIZE - tail);
+}
+
+/**
+ * @brief  DMA 发送完成回调: 释放已发送的数据，仍有数据 (环形缓冲回绕或发送期间新写入的日志) 时续发
+ * @param  len: 本次发送的字节数 (即 OTA_DebugTxGetBlock 的返回值)
+ */
+void OTA_DebugTxBlockDone(uint16_t len)
+{
+    log_tail = (log_tail + len) & LOG_MASK;
+    if (log_head != log_tail)
+    {
+        OTA_DebugTxStart();
+    }
+}
+
+/**
+ * @brief  等待日志缓冲区发送完毕
+ *         跳转 App 前调用，避免关中断后丢失尾部日志;
+ *         循环中反复启动发送，不依赖调度器中的 OTA_LogPoll 续发
+ */
+void OTA_LogFlush(void)
+{
+    while (log_head != log_tail)
+    {
+        OTA_DebugTxStart();
+    }
+}
+
+/**
+ * @brief  日志发送任务: 缓冲区非空时重新启动发送
+ *         供调度器周期调用，用于 DMA 发送完成后续发剩余日志
+ */
+void OTA_LogPoll(void)
+{
+    if (log_head != log_tail)
+    {
+        OTA_DebugTxStart();
+    }
+}
+
+/**
+ * @brief  获取因缓冲区满而被丢弃的日志条数
+ * @return 丢弃条数
+ */
+uint32_t OTA_LogGetDropCount(void)
+{
+    return log_drop;
+}
@@ -0,0 +1,147 @@
+/**
+ ******************************************************************************
+ * @file    OtaLog.h
+ * @author  MiniOTA Team
+ * @brief   调试日志模块头文件
+ *          日志先写入环形缓冲区，由调试串口 TXE 中断(或 DMA)在后台发送，
+ *          高于 OTA_LOG_LEVEL 的日志在编译期被完全剔除，
+ *          OTA_LOG_TOKENIZED 为 1 时只输出日志 ID 与参数
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 MiniOTA.
+ * All rights reserved.
+ *
+ ******************************************************************************
+ */
+
+#ifndef OTALOG_H
+#define OTALOG_H
+
+#include "OtaInterface.h"
+#include "OtaLogDict.h"
+
+/** @defgroup OTA_Log_Level
+ * @{
+ */
+#define OTA_LOG_LVL_NONE    0   /**< 关闭全部日志 */
+#define OTA_LOG_LVL_ERROR   1   /**< 仅错误 */
+#define OTA_LOG_LVL_INFO    2   /**< 错误 + 流程信息 */
+#define OTA_LOG_LVL_DEBUG   3   /**< 全部日志，包含逐包的热路径信息 */
+
+#ifndef OTA_LOG_LEVEL
+#define OTA_LOG_LEVEL       OTA_LOG_LVL_INFO
+#endif
+
+#ifndef OTA_LOG_BUF_SIZE
+#define OTA_LOG_BUF_SIZE    512
+#endif
+
+#ifndef OTA_LOG_TOKENIZED
+#define OTA_LOG_TOKENIZED   0
+#endif
+
+/** 单条日志最多携带的参数个数 */
+#define OTA_LOG_MAX_ARGS    6
+
+/** 令牌化日志帧起始字节 (ASCII 文本中不会出现) */
+#define OTA_LOG_TOKEN_SYNC  0xA5
+
+#if (OTA_LOG_BUF_SIZE & (OTA_LOG_BUF_SIZE - 1)) != 0
+#error "OTA_LOG_BUF_SIZE must be a power of 2"
+#endif
+/**
+ * @}
+ */
+
+/** @defgroup OTA_Log_Macros
+ * @{
+ */
+/*
+ *  参数为 OtaLogDict.h 中的日志名称，例如 OTA_LOGE(FLASH_ERASE)
+ *  OTA_LOGx_ARGS(name, argc, args) 输出多个参数 (args 为 uint32_t 数组)
+ *  - 文本模式: 输出 "[OTA][Error]:" / "[OTA]:" 前缀 + 字典文本 + "\r\n"
+ *  - 令牌模式: 输出 OTA_LOG_TOKEN_SYNC + ID + 参数个数 + 参数(小端)，
+ *              固件中不包含任何日志文本
+ */
+#if OTA_LOG_LEVEL >= OTA_LOG_LVL_ERROR
+#define OTA_LOGE(name)                   OTA_LogId(OTA_LOG_LVL_ERROR, OTA_LOG_ID_##name, 0, 0)
+#define OTA_LOGE_HEX(name, val)          OTA_LogId(OTA_LOG_LVL_ERROR, OTA_LOG_ID_##name, 1, (val))
+#define OTA_LOGE_ARGS(name, argc, args)  OTA_LogIdArgs(OTA_LOG_LVL_ERROR, OTA_LOG_ID_##name, (argc), (args))
+#else
+#define OTA_LOGE(name)                   ((void)0)
+#define OTA_LOGE_HEX(name, val)          ((void)(val))
+#define OTA_LOGE_ARGS(name, argc, args)  ((void)(args))
+#endif
+
+#if OTA_LOG_LEVEL >= OTA_LOG_LVL_INFO
+#define OTA_LOGI(name)                   OTA_LogId(OTA_LOG_LVL_INFO, OTA_LOG_ID_##name, 0, 0)
+#define OTA_LOGI_HEX(name, val)          OTA_LogId(OTA_LOG_LVL_INFO, OTA_LOG_ID_##name, 1, (val))
+#define OTA_LOGI_ARGS(name, argc, args)  OTA_LogIdArgs(OTA_LOG_LVL_INFO, OTA_LOG_ID_##name, (argc), (args))
+#else
+#define OTA_LOGI(name)                   ((void)0)
+#define OTA_LOGI_HEX(name, val)          ((void)(val))
+#define OTA_LOGI_ARGS(name, argc, args)  ((void)(args))
+#endif
+
+#if OTA_LOG_LEVEL >= OTA_LOG_LVL_DEBUG
+#define OTA_LOGD(name)                   OTA_LogId(OTA_LOG_LVL_DEBUG, OTA_LOG_ID_##name, 0, 0)
+#define OTA_LOGD_HEX(name, val)          OTA_LogId(OTA_LOG_LVL_DEBUG, OTA_LOG_ID_##name, 1, (val))
+#define OTA_LOGD_ARGS(name, argc, args)  OTA_LogIdArgs(OTA_LOG_LVL_DEBUG, OTA_LOG_ID_##name, (argc), (args))
+#else
+#define OTA_LOGD(name)                   ((void)0)
+#define OTA_LOGD_HEX(name, val)          ((void)(val))
+#define OTA_LOGD_ARGS(name, argc, args)  ((void)(args))
+#endif
+/**
+ * @}
+ */
+
+/**
+ * @brief  写入一条原始字符串到日志缓冲区 (中断与主循环中均可调用)
+ *         令牌模式下原样输出，上位机解码工具会将其作为普通文本显示
+ * @param  str: 以 '\0' 结尾的字符串
+ * @return 1: 写入成功, 0: 缓冲区空间不足，整条日志被丢弃
+ */
+uint8_t OTA_LogWrite(const char *str);
+
+/**
+ * @brief  按字典 ID 写入一条日志 (通常通过 OTA_LOGx 宏调用)
+ * @param  level: 日志等级
+ * @param  id: 日志 ID
+ * @param  argc: 参数个数 (0 或 1)
+ * @param  arg: 32位参数
+ * @return 1: 写入成功, 0: 缓冲区空间不足
+ */
+uint8_t OTA_LogId(uint8_t level, OTA_LOG_ID_E id, uint8_t argc, uint32_t arg);
+
+/**
+ * @brief  按字典 ID 写入一条带多个参数的日志 (通常通过 OTA_LOGx_ARGS 宏调用，参数以空格分隔的十六进制输出)
+ *         高于 OTA_LOG_LEVEL 的等级不输出
+ * @param  level: 日志等级
+ * @param  id: 日志 ID
+ * @param  argc: 参数个数 (不超过 OTA_LOG_MAX_ARGS)
+ * @param  args: 32位参数数组
+ * @return 1: 写入成功, 0: 缓冲区空间不足、参数非法或等级被关闭
+ */
+uint8_t OTA_LogIdArgs(uint8_t level, OTA_LOG_ID_E id, uint8_t argc, const uint32_t *args);
+
+/**
+ * @brief  等待日志缓冲区发送完毕
+ *         跳转 App 前调用，避免关中断后丢失尾部日志
+ */
+void OTA_LogFlush(void);
+
+/**
+ * @brief  日志发送任务: 缓冲区非空时重新启动发送
+ *         供调度器周期调用，用于 DMA 发送完成后续发剩余日志
+ */
+void OTA_LogPoll(void);
+
+/**
+ * @brief  获取因缓冲区满而被丢弃的日志条数
+ * @return 丢弃条数
+ */
+uint32_t OTA_LogGetDropCount(void);
+
+#endif
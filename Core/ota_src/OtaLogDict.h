@@ -0,0 +1,115 @@
+/**
+ ******************************************************************************
+ * @file    OtaLogDict.h
+ * @author  MiniOTA Team
+ * @brief   调试日志字典
+ *          所有日志文本集中在此定义，ID 按 错误 -> 信息 -> 调试 的顺序依次编号。
+ *          令牌化模式下固件只发送 ID 与参数，上位机工具 Tools/OtaLogDecode.py
+ *          解析本文件生成字典并还原文本，因此本文件须与固件版本一一对应
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 MiniOTA.
+ * All rights reserved.
+ *
+ ******************************************************************************
+ */
+
+#ifndef OTALOGDICT_H
+#define OTALOGDICT_H
+
+/*
+ *  X(名称, 文本)
+ *  - 新增日志只能追加在对应等级列表末尾，或同步更新上位机字典
+ *  - 带 _HEX 宏输出的日志，文本后会追加一个 0xXXXXXXXX 参数
+ */
+
+/** 错误等级 (OTA_LOGE) */
+#define OTA_LOG_DICT_ERROR(X) \
+    X(CFG_FLASH_RANGE,   "In OtaInterface - The flash space allocated to MiniOTA must be located within the Flash memory..") \
+    X(CFG_ALIGN,         "In OtaInterface - MiniOTA's starting address must be aligned to the Flash page.") \
+    X(CFG_SIZE,          "In OtaInterface - MiniOTA available flash storage space must be larger than one Flash page.") \
+    X(FLASH_UNLOCK,      "Flash UnLock Faild") \
+    X(FLASH_ERASE,       "Flash Erase Faild") \
+    X(FLASH_LOCK,        "Flash Lock Faild") \
+    X(FLASH_VERIFY,      "Flash Verify Error ,Data Mismatch") \
+    X(XM_INTERRUPTED,    "Transmission interrupted.") \
+    X(XM_UNKNOWN_CHAR,   "An Vnknown Character Was Read.") \
+    X(XM_BLK_INV,        "Mismatched Package Serial Numbers And Inverse Codes") \
+    X(XM_BLK_ORDER,      "Packet Order Confusion") \
+    X(XM_CRC,            "Crc16 Is Inconsistent") \
+    X(XM_BYTE_TIMEOUT,   "Inter-byte timeout, resync") \
+    X(XM_PKT_TIMEOUT,    "Packet timeout, resync") \
+    X(XM_SESSION_TIMEOUT,"Session timeout, transfer aborted") \
+    X(CFG_BANK,          "In OtaInterface - Bank2 must match the chip layout, lie after Meta inside the Flash and hold a full slot.") \
+    X(CFG_EXT,           "In OtaInterface - The external staging offset must be aligned to a 4KB sector.") \
+    X(SPI_NOR_TIMEOUT,   "SPI NOR busy timeout") \
+    X(INSTALL_FAIL,      "Staged image install failed, keep Slot A") \
+    X(CFG_BACKUP,        "In OtaInterface - Slot A and the compressed backup slot must each hold at least one page.") \
+    X(BACKUP_FAIL,       "Backup compression failed, updating without rollback") \
+    X(RESTORE_FAIL,      "Compressed backup restore failed") \
+    X(CFG_PART,          "In OtaInterface - The partition table must fit in the Meta page.") \
+    X(PART_INVALID,      "Partition table invalid, using default layout") \
+    X(CFG_SLOT_NUM,      "In OtaInterface - OTA_SLOT_NUM must be 2~8, and 2 with dual bank, external staging, compressed backup or swap install.") \
+    X(CFG_SWAP,          "In OtaInterface - Swap install excludes the other layouts and a slot must fit the swap journal.") \
+    X(SWAP_FAIL,         "Slot swap failed") \
+    X(RELOC_FAIL,        "Image relocation failed") \
+    X(IMG_FORMAT,        "Unknown or malformed image header") \
+    X(IMG_TOO_LARGE,     "Image does not fit the target slot, bytes : ") \
+    X(IMG_UNSUPPORTED,   "Image uses unsupported features, flags : ") \
+    X(IMG_LOAD_ADDR,     "Image is linked for another address : ") \
+    X(REPAIR_BAD_CHUNK,  "Image chunk corrupted, index : ") \
+    X(REPAIR_MISMATCH,   "Repair stream does not match the image in the slot") \
+    X(IMG_HASH,          "Image SHA-256 digest mismatch, bytes hashed : ") \
+    X(CFG_SIG,           "In OtaInterface - Signature verification needs OTA_SHA256_ENABLE and excludes OTA_RELOC_ENABLE.") \
+    X(IMG_UNSIGNED,      "Image rejected, SHA-256 digest and signature required") \
+    X(SIG_BAD,           "Image signature invalid, slot address : ")
+
+/** 信息等级 (OTA_LOGI / OTA_LOGI_HEX) */
+#define OTA_LOG_DICT_INFO(X) \
+    X(IAP_RUNNING,       "IAPing...") \
+    X(IAP_SELECT,        "Selecting IAP... ") \
+    X(IAP_IOM_ADDR,      "Please set the IOM address to : ") \
+    X(PROF_STAT,         "Prof [point count min max mean] : ") \
+    X(PROF_HIST,         "Prof hist [point bin n0 n1 n2 n3] : ") \
+    X(LINK_XM,           "Link [packets nak duplicate seq blkinv crc] : ") \
+    X(LINK_UART,         "Link [overrun framing noise timeout rxoverflow] : ") \
+    X(IAP_PRE_ERASED,    "Slot pre-erased by app, skip erase : ") \
+    X(INSTALL_START,     "Installing staged image, bytes : ") \
+    X(BACKUP_DONE,       "Backup compressed, bytes : ") \
+    X(BACKUP_RESTORED,   "Rolled back from compressed backup, bytes : ") \
+    X(PART_LOADED,       "Partition table loaded") \
+    X(GOLDEN_BOOT,       "No bootable slot, starting golden image at : ") \
+    X(SWAP_START,        "Swapping slots, pages : ") \
+    X(SWAP_RESUME,       "Resuming interrupted swap") \
+    X(RELOC_DONE,        "Image relocated, entries : ") \
+    X(IMG_HEADER,        "Image header accepted, total bytes : ") \
+    X(REPAIR_COPIED,     "Corrupted chunks copied from another slot : ") \
+    X(REPAIR_START,      "Repairing image, chunks : ") \
+    X(IMG_SEGMENTS,      "Segmented image, bytes to receive : ") \
+    X(IMG_HASH_OK,       "Image SHA-256 digest verified") \
+    X(SIG_OK,            "Image signature verified, slot address : ") \
+    X(IMG_DECRYPT,       "Image body encrypted, decrypting with AES-128-CTR")
+
+/** 调试等级 (OTA_LOGD) */
+#define OTA_LOG_DICT_DEBUG(X) \
+    X(XM_SOH,            "SOH MODE") \
+    X(XM_STX,            "STX MODE") \
+    X(XM_BLK,            "GET PACK NUM") \
+    X(XM_CRC1,           "Get Crc1") \
+    X(XM_CRC2,           "Get Crc2")
+
+#define OTA_LOG_DICT_ENUM(name, text)   OTA_LOG_ID_##name,
+
+/**
+ * @brief 日志 ID 枚举
+ */
+typedef enum __OTA_LOG_ID
+{
+    OTA_LOG_DICT_ERROR(OTA_LOG_DICT_ENUM)
+    OTA_LOG_DICT_INFO(OTA_LOG_DICT_ENUM)
+    OTA_LOG_DICT_DEBUG(OTA_LOG_DICT_ENUM)
+    OTA_LOG_ID_MAX
+} OTA_LOG_ID_E;
+
+#endif
@@ -0,0 +1,550 @@
+/**
+ ******************************************************************************
+ * @file    OtaMeta.c
+ * @author  MiniOTA Team
+ * @brief   Meta 状态区读写实现
+ *          Bootloader 与 App 侧库共用，保证双方对 Meta 内容的解释一致
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 MiniOTA.
+ * All rights reserved.
+ *
+ ******************************************************************************
+ */
+
+#include "OtaInterface.h"
+#include "OtaUtils.h"
+#include "OtaFlash.h"
+#include "OtaMeta.h"
+#include "OtaBdev.h"
+#include "OtaFlashIfoDef.h"
+#include "OtaImage.h"
+#if OTA_EXT_STAGING
+#include "OtaSpiNor.h"
+#endif
+
+/** 已启用的分区表 (part_state 为 OTA_PART_LOADED 时有效) */
+static OTA_PART_TABLE_E part_table;
+static uint8_t part_state = 0xFF;   /* 0xFF: 尚未读取 */
+
+/**
+ * @brief  读取 Meta 状态区
+ * @param  pMeta: 输出 Meta 内容
+ * @return OTA_TRUE: 魔数有效, OTA_FALSE: Meta 无效(从未写入或已损坏)
+ */
+OTA_BOOL OTA_MetaLoad(OTA_META_DATA_E *pMeta)
+{
+    OTA_BdevRead(OTA_META_ADDR, (uint8_t *)pMeta, sizeof(OTA_META_DATA_E));
+    return (pMeta->magic == OTA_MAGIC_NUM) ? OTA_TRUE : OTA_FALSE;
+}
+
+/**
+ * @brief  写入整个 Meta 页
+ * @param  pMeta: Meta 内容
+ * @param  pTable: 分区表，为 NULL 时保留 Flash 中原有的分区表
+ * @return 0: 成功, 1: 失败
+ */
+static int Meta_WritePage(const OTA_META_DATA_E *pMeta, const OTA_PART_TABLE_E *pTable)
+{
+    uint8_t flashPage[OTA_FLASH_PAGE_SIZE];
+    OTA_MemSet(flashPage, 0xFF, OTA_FLASH_PAGE_SIZE);
+    OTA_MemCopy(flashPage, (const uint8_t *)pMeta, sizeof(OTA_META_DATA_E));
+    if (pTable != 0)
+    {
+        OTA_MemCopy(flashPage + OTA_PART_TABLE_OFFSET, (const uint8_t *)pTable, sizeof(OTA_PART_TABLE_E));
+    }
+    else
+    {
+        // 只更新 Meta 时原样保留页内的分区表
+        OTA_BdevRead(OTA_META_ADDR + OTA_PART_TABLE_OFFSET, flashPage + OTA_PART_TABLE_OFFSET,
+                     sizeof(OTA_PART_TABLE_E));
+    }
+    // 魔数最后写入: 写 Meta 途中掉电时整页无效 (由 OTA_MetaRebuild 重建)，不会读到只写了一半的插槽状态
+    OTA_MemSet(flashPage, 0xFF, sizeof(pMeta->magic));
+    OTA_FlashSetCurAddr(OTA_META_ADDR);
+    OTA_FlashSetMirr(flashPage, OTA_FLASH_PAGE_SIZE);
+    if (OTA_FlashWrite() != 0)
+    {
+        return 1;
+    }
+    return OTA_BdevProgram(OTA_META_ADDR, (const uint8_t *)&pMeta->magic, sizeof(pMeta->magic));
+}
+
+/**
+ * @brief  将 Meta 信息保存到 Flash 状态区 (同页中的分区表保持不变)
+ * @param  pMeta: 指向 Meta 结构体的指针
+ * @return 0: 成功, 1: 失败
+ */
+int OTA_MetaSave(const OTA_META_DATA_E *pMeta)
+{
+    return Meta_WritePage(pMeta, 0);
+}
+
+/**
+ * @brief  初始化 Meta 内容: 所有插槽为空，激活插槽为 A
+ * @param  pMeta: 输出 Meta 内容 (仅修改内存中的副本，需再调用 OTA_MetaSave)
+ */
+void OTA_MetaInit(OTA_META_DATA_E *pMeta)
+{
+    OTA_MemSet((uint8_t *)pMeta, 0xFF, sizeof(OTA_META_DATA_E));
+    pMeta->magic       = OTA_MAGIC_NUM;
+    pMeta->seq_num     = 0UL;
+    pMeta->active_slot = SLOT_A;
+    OTA_MemSet((uint8_t *)pMeta->slot_seq, 0, sizeof(pMeta->slot_seq));
+}
+
+/**
+ * @brief  插槽是否可执行 (OTA_EXT_STAGING 的暂存分区、OTA_BACKUP_COMPRESSED 的备份分区
+ *         与 OTA_SWAP_INSTALL 的下载分区不可执行)
+ * @param  slot: 插槽
+ * @return OTA_TRUE: 可作为启动目标
+ */
+OTA_BOOL OTA_MetaIsBootable(OTA_ACIVE_SLOT_E slot)
+{
+    if ((OTA_EXT_STAGING || OTA_BACKUP_COMPRESSED || OTA_SWAP_INSTALL) && slot != SLOT_A)
+    {
+        return OTA_FALSE;
+    }
+    return OTA_TRUE;
+}
+
+/**
+ * @brief  读取插槽中固件的版本号
+ * @param  slot: 插槽
+ * @return 固件头中的版本号，固件头无效时为 0
+ */
+static uint32_t Meta_SlotVersion(OTA_ACIVE_SLOT_E slot)
+{
+    OTA_IMG_INFO_E info;
+
+    return (OTA_ImageLoad(OTA_MetaSlotAddr(slot), &info) == OTA_TRUE) ? info.version : 0UL;
+}
+
+/**
+ * @brief  在已验证的可执行插槽中选出固件版本号最高的一个 (回退启动目标)
+ * @param  pMeta: Meta 信息
+ * @param  exclude: 需要排除的插槽位图 (bit n 对应插槽 n)
+ * @return 插槽编号，没有符合条件的插槽时为 OTA_SLOT_NONE
+ */
+OTA_ACIVE_SLOT_E OTA_MetaBestSlot(const OTA_META_DATA_E *pMeta, uint16_t exclude)
+{
+    uint8_t best = OTA_SLOT_NONE;
+    uint32_t best_ver = 0;
+    uint32_t ver;
+    uint8_t slot;
+
+    for (slot = 0; slot < OTA_SLOT_NUM; slot++)
+    {
+        if ((exclude & (1U << slot)) || pMeta->slot_status[slot] != SLOT_STATE_VALID ||
+            !OTA_MetaIsBootable((OTA_ACIVE_SLOT_E)slot))
+        {
+            continue;
+        }
+        ver = Meta_SlotVersion((OTA_ACIVE_SLOT_E)slot);
+        if (best == OTA_SLOT_NONE || ver > best_ver)
+        {
+            best = slot;
+            best_ver = ver;
+        }
+    }
+    return (OTA_ACIVE_SLOT_E)best;
+}
+
+/**
+ * @brief  按 Meta 状态获取当前会启动的插槽 (不校验固件)
+ *         激活插槽待确认或有效时为激活插槽，否则为版本号最高的已验证插槽
+ * @param  pMeta: Meta 信息
+ * @return 插槽编号，没有可启动的插槽时为 OTA_SLOT_NONE
+ */
+OTA_ACIVE_SLOT_E OTA_MetaGetBootSlot(const OTA_META_DATA_E *pMeta)
+{
+    uint8_t status = pMeta->slot_status[pMeta->active_slot];
+
+    if ((status == SLOT_STATE_UNCONFIRMED || status == SLOT_STATE_VALID) &&
+        OTA_MetaIsBootable(pMeta->active_slot))
+    {
+        return pMeta->active_slot;
+    }
+    return OTA_MetaBestSlot(pMeta, 0);
+}
+
+/**
+ * @brief  Meta 无效时按插槽内容重建: 固件头有效的可执行插槽标记为待确认 (由 Bootloader 校验)，
+ *         版本号最高的一个作为激活插槽; 空片上与 OTA_MetaInit 相同
+ * @param  pMeta: 输出 Meta 内容 (仅修改内存中的副本，需再调用 OTA_MetaSave)
+ */
+void OTA_MetaRebuild(OTA_META_DATA_E *pMeta)
+{
+    OTA_IMG_INFO_E info;
+    uint32_t best_ver = 0;
+    uint8_t slot;
+
+    OTA_MetaInit(pMeta);
+    for (slot = 0; slot < OTA_SLOT_NUM; slot++)
+    {
+        if (!OTA_MetaIsBootable((OTA_ACIVE_SLOT_E)slot) ||
+            OTA_ImageLoad(OTA_MetaSlotAddr((OTA_ACIVE_SLOT_E)slot), &info) != OTA_TRUE)
+        {
+            continue;
+        }
+        pMeta->slot_status[slot] = SLOT_STATE_UNCONFIRMED;
+        if (info.version > best_ver)
+        {
+            best_ver = info.version;
+            pMeta->active_slot = (OTA_ACIVE_SLOT_E)slot;
+        }
+    }
+}
+
+/**
+ * @brief  获取下一次升级应写入的插槽
+ *         空插槽或无效插槽优先 (编号小者优先)，否则按 OTA_SLOT_SELECT_POLICY 在其余插槽中
+ *         选择最久未写入或版本号最低的一个，当前启动的插槽不会被选中;
+ *         OTA_EXT_STAGING/OTA_SWAP_INSTALL 时总为 B，OTA_BACKUP_COMPRESSED 时总为 A
+ * @param  pMeta: Meta 信息
+ * @return 目标插槽
+ */
+OTA_ACIVE_SLOT_E OTA_MetaGetIapSlot(const OTA_META_DATA_E *pMeta)
+{
+#if OTA_EXT_STAGING || OTA_SWAP_INSTALL
+    // 外部暂存/交换安装: 新固件总是下载到 Slot B，由 Bootloader 安装到 Slot A
+    (void)pMeta;
+    return SLOT_B;
+#elif OTA_BACKUP_COMPRESSED
+    // 压缩备份: 旧固件压缩到 Slot B 后，新固件直接覆盖 Slot A
+    (void)pMeta;
+    return SLOT_A;
+#else
+    uint8_t boot = OTA_MetaGetBootSlot(pMeta);
+    uint8_t best = OTA_SLOT_NONE;
+    uint32_t best_key = 0;
+    uint32_t key;
+    uint8_t slot;
+
+    for (slot = 0; slot < OTA_SLOT_NUM; slot++)
+    {
+        if (slot == boot)
+        {
+            continue;
+        }
+        if (pMeta->slot_status[slot] == SLOT_STATE_EMPTY || pMeta->slot_status[slot] == SLOT_STATE_INVALID)
+        {
+            return (OTA_ACIVE_SLOT_E)slot;
+        }
+#if OTA_SLOT_SELECT_POLICY
+        key = Meta_SlotVersion((OTA_ACIVE_SLOT_E)slot);
+#else
+        // 按距当前序列号的写入间隔换算，越久未写入值越小，序列号回绕后仍可比较
+        key = pMeta->slot_seq[slot] - pMeta->seq_num - 1U;
+#endif
+        if (best == OTA_SLOT_NONE || key < best_key)
+        {
+            best = slot;
+            best_key = key;
+        }
+    }
+    return (OTA_ACIVE_SLOT_E)best;
+#endif
+}
+
+/**
+ * @brief  将刚写入的插槽标记为待确认并设为激活插槽，下次复位由 Bootloader 校验后启动
+ *         校验失败时 Bootloader 回退到版本号最高的已验证插槽
+ * @param  pMeta: Meta 信息 (仅修改内存中的副本，需再调用 OTA_MetaSave)
+ * @param  slot: 刚写入的插槽
+ */
+void OTA_MetaMarkPending(OTA_META_DATA_E *pMeta, OTA_ACIVE_SLOT_E slot)
+{
+    pMeta->seq_num++;
+    pMeta->slot_seq[slot]    = pMeta->seq_num;
+    pMeta->slot_status[slot] = SLOT_STATE_UNCONFIRMED;
+    pMeta->active_slot = slot;
+    pMeta->pre_erased  = OTA_PRE_ERASED_NONE;
+}
+
+/**
+ * @brief  插槽中固件的签名是否已验证过
+ * @param  pMeta: Meta 信息
+ * @param  slot: 插槽
+ * @return OTA_TRUE: 已验证
+ */
+OTA_BOOL OTA_MetaIsVerified(const OTA_META_DATA_E *pMeta, OTA_ACIVE_SLOT_E slot)
+{
+    return ((pMeta->sig_unverified & (1U << slot)) == 0) ? OTA_TRUE : OTA_FALSE;
+}
+
+/**
+ * @brief  记录插槽签名的验证状态 (位为 1 表示未验证，擦除后的 Meta 即全部未验证)
+ * @param  pMeta: Meta 信息
+ * @param  slot: 插槽
+ * @param  verified: OTA_TRUE: 已验证, OTA_FALSE: 未验证
+ */
+void OTA_MetaSetVerified(OTA_META_DATA_E *pMeta, OTA_ACIVE_SLOT_E slot, OTA_BOOL verified)
+{
+    if (verified == OTA_TRUE)
+    {
+        pMeta->sig_unverified &= (uint8_t)~(1U << slot);
+    }
+    else
+    {
+        pMeta->sig_unverified |= (uint8_t)(1U << slot);
+    }
+}
+
+/**
+ * @brief  获取插槽起始地址
+ * @param  slot: 插槽
+ * @return 插槽起始地址 (固件头所在位置)
+ */
+uint32_t OTA_MetaSlotAddr(OTA_ACIVE_SLOT_E slot)
+{
+    const OTA_PART_ENTRY_E *pEntry = OTA_PartFind((uint8_t)slot);
+    if (pEntry != 0)
+    {
+        return OTA_PartAddr(pEntry);
+    }
+    return (slot == SLOT_B) ? OTA_APP_B_ADDR : OTA_APP_A_ADDR + (uint32_t)slot * OTA_APP_SLOT_SIZE;
+}
+
+/**
+ * @brief  获取插槽大小 (含固件头)
+ * @param  slot: 插槽
+ * @return 插槽大小(字节)
+ */
+uint32_t OTA_MetaSlotSize(OTA_ACIVE_SLOT_E slot)
+{
+    const OTA_PART_ENTRY_E *pEntry = OTA_PartFind((uint8_t)slot);
+    if (pEntry != 0)
+    {
+        return pEntry->size;
+    }
+    return (slot == SLOT_B) ? OTA_APP_B_SIZE : OTA_APP_SLOT_SIZE;
+}
+
+/**
+ * @brief  判断地址是否落在 MiniOTA_GetLayout() 描述的扇区边界上 (含 Flash 末尾)
+ * @param  addr: 内部 Flash 地址
+ * @return OTA_TRUE: 是扇区边界
+ */
+static OTA_BOOL Part_IsSectorEdge(uint32_t addr)
+{
+    const MiniOTA_FlashLayout *layout = MiniOTA_GetLayout();
+    uint32_t edge = layout->start_addr;
+    uint32_t end = layout->start_addr + layout->total_size;
+    uint32_t g;
+    uint32_t n;
+
+    for (g = 0; g < layout->group_count && edge < addr; g++)
+    {
+        for (n = 0; n < layout->groups[g].count && edge < addr; n++)
+        {
+            edge += layout->groups[g].size;
+        }
+    }
+    return (edge == addr && addr <= end) ? OTA_TRUE : OTA_FALSE;
+}
+
+/**
+ * @brief  检查单个分区的范围与对齐
+ *         内部分区须位于 Meta 之后、Flash 之内，起止地址均为页边界与扇区边界，
+ *         OTA_SWAP_INSTALL 时不得占用交换暂存页与进度页;
+ *         外部分区须按 SPI NOR 扇区对齐
+ * @param  pEntry: 分区表项
+ * @return OTA_TRUE: 合法
+ */
+static OTA_BOOL Part_IsEntryValid(const OTA_PART_ENTRY_E *pEntry)
+{
+    uint32_t start;
+    uint32_t end;
+
+    if (pEntry->size == 0 || pEntry->offset + pEntry->size < pEntry->offset)
+    {
+        return OTA_FALSE;
+    }
+    if (pEntry->flags & OTA_PART_FLAG_EXT)
+    {
+#if OTA_EXT_STAGING
+        return ((pEntry->offset % OTA_SPI_NOR_SECTOR_SIZE) == 0 &&
+                (pEntry->size % OTA_SPI_NOR_SECTOR_SIZE) == 0 &&
+                pEntry->offset + pEntry->size <= OTA_SPI_NOR_MAX_SIZE) ? OTA_TRUE : OTA_FALSE;
+#else
+        return OTA_FALSE;
+#endif
+    }
+
+    start = OTA_FLASH_START_ADDRESS + pEntry->offset;
+    end = start + pEntry->size;
+#if OTA_SWAP_INSTALL
+    // 不得占用交换暂存页与进度页
+    if (start < OTA_SWAP_STATUS_ADDR + OTA_FLASH_PAGE_SIZE && OTA_SWAP_SCRATCH_ADDR < end)
+    {
+        return OTA_FALSE;
+    }
+#endif
+    if (start < OTA_APP_REGION_ADDR || end > OTA_FLASH_START_ADDRESS + OTA_FLASH_SIZE ||
+        (start % OTA_FLASH_PAGE_SIZE) != 0 || (end % OTA_FLASH_PAGE_SIZE) != 0)
+    {
+        return OTA_FALSE;
+    }
+    return (Part_IsSectorEdge(start) && Part_IsSectorEdge(end)) ? OTA_TRUE : OTA_FALSE;
+}
+
+/**
+ * @brief  检查分区表: 魔数与 CRC、每个分区的范围、分区间不重叠，
+ *         且 OTA_SLOT_NUM 个插槽各出现一次 (OTA_EXT_STAGING 时 B 必须位于外部 Flash)
+ * @param  pTable: 分区表
+ * @return OTA_TRUE: 合法
+ */
+static OTA_BOOL Part_IsTableValid(const OTA_PART_TABLE_E *pTable)
+{
+    const OTA_PART_ENTRY_E *pEntry;
+    uint16_t slots = 0;
+    uint8_t ext;
+    uint16_t i;
+    uint16_t j;
+
+    if (pTable->magic != OTA_PART_MAGIC || pTable->count == 0 || pTable->count > OTA_PART_MAX_NUM ||
+        pTable->crc16 != OTA_GetCrc16((const uint8_t *)pTable->entry, pTable->count * sizeof(OTA_PART_ENTRY_E)))
+    {
+        return OTA_FALSE;
+    }
+
+    for (i = 0; i < pTable->count; i++)
+    {
+        pEntry = &pTable->entry[i];
+        ext = pEntry->flags & OTA_PART_FLAG_EXT;
+        if (!Part_IsEntryValid(pEntry))
+        {
+            return OTA_FALSE;
+        }
+
+        if (pEntry->role < OTA_SLOT_NUM)
+        {
+            // 只有暂存分区位于外部 Flash; 每个插槽只能出现一次
+            if ((ext != 0) != (OTA_EXT_STAGING && pEntry->role == OTA_PART_ROLE_SLOT_B) ||
+                (slots & (1U << pEntry->role)))
+            {
+                return OTA_FALSE;
+            }
+            slots |= (uint16_t)(1U << pEntry->role);
+        }
+        else if (pEntry->role == OTA_PART_ROLE_GOLDEN)
+        {
+            // 可执行分区只能位于内部 Flash
+            if (ext)
+            {
+                return OTA_FALSE;
+            }
+        }
+        else if (pEntry->role != OTA_PART_ROLE_DATA)
+        {
+            return OTA_FALSE;
+        }
+
+        for (j = 0; j < i; j++)
+        {
+            if ((pTable->entry[j].flags & OTA_PART_FLAG_EXT) == ext &&
+                pEntry->offset < pTable->entry[j].offset + pTable->entry[j].size &&
+                pTable->entry[j].offset < pEntry->offset + pEntry->size)
+            {
+                return OTA_FALSE;
+            }
+        }
+    }
+    return (slots == (1U << OTA_SLOT_NUM) - 1U) ? OTA_TRUE : OTA_FALSE;
+}
+
+/**
+ * @brief  从 Meta 页读取并检查分区表，合法时启用，否则使用默认布局
+ *         Bootloader 在启动时调用; 其他接口首次查询分区时也会自动读取
+ * @return 分区表状态
+ */
+OTA_PART_STATE_E OTA_PartLoad(void)
+{
+    OTA_BdevRead(OTA_META_ADDR + OTA_PART_TABLE_OFFSET, (uint8_t *)&part_table, sizeof(part_table));
+    if (part_table.magic == 0xFFFFFFFFUL)
+    {
+        part_state = OTA_PART_DEFAULT;
+    }
+    else
+    {
+        part_state = Part_IsTableValid(&part_table) ? OTA_PART_LOADED : OTA_PART_INVALID;
+    }
+    return (OTA_PART_STATE_E)part_state;
+}
+
+/**
+ * @brief  查找指定用途的分区
+ * @param  role: OTA_PART_ROLE_xxx
+ * @return 分区表项，未启用分区表或不存在该分区时返回 NULL
+ */
+const OTA_PART_ENTRY_E *OTA_PartFind(uint8_t role)
+{
+    uint16_t i;
+
+    if (part_state == 0xFF)
+    {
+        OTA_PartLoad();
+    }
+    if (part_state != OTA_PART_LOADED)
+    {
+        return 0;
+    }
+    for (i = 0; i < part_table.count; i++)
+    {
+        if (part_table.entry[i].role == role)
+        {
+            return &part_table.entry[i];
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief  获取分区起始地址
+ * @param  pEntry: 分区表项
+ * @return 起始地址 (外部分区为 OTA_EXT_FLASH_BASE 之上的虚拟地址)
+ */
+uint32_t OTA_PartAddr(const OTA_PART_ENTRY_E *pEntry)
+{
+    if (pEntry->flags & OTA_PART_FLAG_EXT)
+    {
+        return OTA_EXT_FLASH_BASE + pEntry->offset;
+    }
+    return OTA_FLASH_START_ADDRESS + pEntry->offset;
+}
+
+/**
+ * @brief  写入新的分区表 (由 App 或产线工具调用，下次启动生效)
+ *         magic 与 crc16 由本函数填写; 表不合法时不写入。
+ *         调整分区不会搬移已有固件，调用者需保证插槽内容与新布局相符，
+ *         否则 Bootloader 校验插槽失败后进入 IAP
+ * @param  pTable: 分区表 (只需填写 count 与 entry)
+ * @return 0: 成功, 1: 失败
+ */
+int OTA_PartSave(const OTA_PART_TABLE_E *pTable)
+{
+    OTA_META_DATA_E meta;
+    OTA_PART_TABLE_E table;
+
+    OTA_MemCopy((uint8_t *)&table, (const uint8_t *)pTable, sizeof(table));
+    table.magic = OTA_PART_MAGIC;
+    if (table.count == 0 || table.count > OTA_PART_MAX_NUM)
+    {
+        return 1;
+    }
+    table.crc16 = OTA_GetCrc16((const uint8_t *)table.entry, table.count * sizeof(OTA_PART_ENTRY_E));
+    if (!Part_IsTableValid(&table))
+    {
+        return 1;
+    }
+
+    // 原样保留页内的 Meta 内容
+    OTA_BdevRead(OTA_META_ADDR, (uint8_t *)&meta, sizeof(meta));
+    if (Meta_WritePage(&meta, &table) != 0)
+    {
+        return 1;
+    }
+    return (OTA_PartLoad() == OTA_PART_LOADED) ? 0 : 1;
+}
@@ -0,0 +1,144 @@
+/**
+ ******************************************************************************
+ * @file    OtaMeta.h
+ * @author  MiniOTA Team
+ * @brief   Meta 状态区读写头文件
+ *          Bootloader 与 App 侧库共用，保证双方对 Meta 内容的解释一致
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 MiniOTA.
+ * All rights reserved.
+ *
+ ******************************************************************************
+ */
+
+#ifndef OTAMETA_H
+#define OTAMETA_H
+
+#include "OtaInterface.h"
+#include "OtaUtils.h"
+
+/**
+ * @brief  读取 Meta 状态区
+ * @param  pMeta: 输出 Meta 内容
+ * @return OTA_TRUE: 魔数有效, OTA_FALSE: Meta 无效(从未写入或已损坏)
+ */
+OTA_BOOL OTA_MetaLoad(OTA_META_DATA_E *pMeta);
+
+/**
+ * @brief  将 Meta 信息保存到 Flash 状态区 (同页中的分区表保持不变)
+ * @param  pMeta: 指向 Meta 结构体的指针
+ * @return 0: 成功, 1: 失败
+ */
+int OTA_MetaSave(const OTA_META_DATA_E *pMeta);
+
+/**
+ * @brief  初始化 Meta 内容: 所有插槽为空，激活插槽为 A
+ * @param  pMeta: 输出 Meta 内容 (仅修改内存中的副本，需再调用 OTA_MetaSave)
+ */
+void OTA_MetaInit(OTA_META_DATA_E *pMeta);
+
+/**
+ * @brief  Meta 无效时按插槽内容重建: 固件头有效的可执行插槽标记为待确认，版本号最高的一个作为激活插槽
+ * @param  pMeta: 输出 Meta 内容 (仅修改内存中的副本，需再调用 OTA_MetaSave)
+ */
+void OTA_MetaRebuild(OTA_META_DATA_E *pMeta);
+
+/**
+ * @brief  插槽是否可执行 (暂存分区与压缩备份分区不可执行)
+ * @param  slot: 插槽
+ * @return OTA_TRUE: 可作为启动目标
+ */
+OTA_BOOL OTA_MetaIsBootable(OTA_ACIVE_SLOT_E slot);
+
+/**
+ * @brief  在已验证的可执行插槽中选出固件版本号最高的一个
+ * @param  pMeta: Meta 信息
+ * @param  exclude: 需要排除的插槽位图 (bit n 对应插槽 n)
+ * @return 插槽编号，没有符合条件的插槽时为 OTA_SLOT_NONE
+ */
+OTA_ACIVE_SLOT_E OTA_MetaBestSlot(const OTA_META_DATA_E *pMeta, uint16_t exclude);
+
+/**
+ * @brief  按 Meta 状态获取当前会启动的插槽 (不校验固件)
+ * @param  pMeta: Meta 信息
+ * @return 插槽编号，没有可启动的插槽时为 OTA_SLOT_NONE
+ */
+OTA_ACIVE_SLOT_E OTA_MetaGetBootSlot(const OTA_META_DATA_E *pMeta);
+
+/**
+ * @brief  获取下一次升级应写入的插槽
+ *         空插槽或无效插槽优先，否则按 OTA_SLOT_SELECT_POLICY 选择最久未写入或版本号最低的插槽，
+ *         当前启动的插槽不会被选中
+ * @param  pMeta: Meta 信息
+ * @return 目标插槽
+ */
+OTA_ACIVE_SLOT_E OTA_MetaGetIapSlot(const OTA_META_DATA_E *pMeta);
+
+/**
+ * @brief  将刚写入的插槽标记为待确认并设为激活插槽，下次复位由 Bootloader 校验后启动
+ *         校验失败时 Bootloader 回退到版本号最高的已验证插槽
+ * @param  pMeta: Meta 信息 (仅修改内存中的副本，需再调用 OTA_MetaSave)
+ * @param  slot: 刚写入的插槽
+ */
+void OTA_MetaMarkPending(OTA_META_DATA_E *pMeta, OTA_ACIVE_SLOT_E slot);
+
+/**
+ * @brief  插槽中固件的签名是否已验证过 (OTA_SIG_ENABLE)，已验证的插槽启动时跳过签名验证
+ * @param  pMeta: Meta 信息
+ * @param  slot: 插槽
+ * @return OTA_TRUE: 已验证
+ */
+OTA_BOOL OTA_MetaIsVerified(const OTA_META_DATA_E *pMeta, OTA_ACIVE_SLOT_E slot);
+
+/**
+ * @brief  记录插槽签名的验证状态，插槽内容被改写时须先记为未验证
+ * @param  pMeta: Meta 信息 (仅修改内存中的副本，需再调用 OTA_MetaSave)
+ * @param  slot: 插槽
+ * @param  verified: OTA_TRUE: 已验证, OTA_FALSE: 未验证
+ */
+void OTA_MetaSetVerified(OTA_META_DATA_E *pMeta, OTA_ACIVE_SLOT_E slot, OTA_BOOL verified);
+
+/**
+ * @brief  获取插槽起始地址
+ * @param  slot: 插槽
+ * @return 插槽起始地址 (固件头所在位置)，分区表未启用时为默认布局的地址
+ */
+uint32_t OTA_MetaSlotAddr(OTA_ACIVE_SLOT_E slot);
+
+/**
+ * @brief  获取插槽大小 (含固件头)
+ * @param  slot: 插槽
+ * @return 插槽大小(字节)，分区表未启用时为默认布局的大小
+ */
+uint32_t OTA_MetaSlotSize(OTA_ACIVE_SLOT_E slot);
+
+/**
+ * @brief  从 Meta 页读取并按 MiniOTA_GetLayout() 检查分区表，合法时启用，否则使用默认布局
+ * @return 分区表状态
+ */
+OTA_PART_STATE_E OTA_PartLoad(void);
+
+/**
+ * @brief  查找指定用途的分区
+ * @param  role: OTA_PART_ROLE_xxx
+ * @return 分区表项，未启用分区表或不存在该分区时返回 NULL
+ */
+const OTA_PART_ENTRY_E *OTA_PartFind(uint8_t role);
+
+/**
+ * @brief  获取分区起始地址
+ * @param  pEntry: 分区表项
+ * @return 起始地址
+ */
+uint32_t OTA_PartAddr(const OTA_PART_ENTRY_E *pEntry);
+
+/**
+ * @brief  写入新的分区表，下次启动生效 (magic 与 crc16 由本函数填写，表不合法时不写入)
+ * @param  pTable: 分区表
+ * @return 0: 成功, 1: 失败
+ */
+int OTA_PartSave(const OTA_PART_TABLE_E *pTable);
+
+#endif
@@ -15,6 +15,15 @@
 #include "OtaInterface.h"
 #include "OtaXmodem.h"
 #include "OtaUtils.h"
+#include "OtaProf.h"
+#include "OtaSched.h"
+
+#define RX_MASK     (OTA_RX_BUF_SIZE - 1U)
+
+/** 接收环形缓冲区: 接收中断写入，接收任务读出 */
+static uint8_t rx_buf[OTA_RX_BUF_SIZE];
+static volatile uint16_t rx_head;
+static volatile uint16_t rx_tail;
 
 /**
  * @brief  判断是否应进入 IAP 模式
@@ -36,18 +45,63 @@ void OTA_PeripheralsDeInit(void)
 
 /**
  * @brief  串口接收中断回调函数
+ *         只把字节存入接收缓冲区并置 OTA_EVT_RX，协议解析与 Flash 写入在主循环中完成
  * @param  byte: 接收到的字节
  */
-void OTA_ReceiveTask(uint8_t byte)
+OTA_RAMFUNC void OTA_ReceiveTask(uint8_t byte)
+{
+	OTA_PROF_BEGIN(OTA_PROF_RX_ISR);
+	uint16_t next = (rx_head + 1U) & RX_MASK;
+	if (next == rx_tail)
+	{
+		// 缓冲区已满，丢弃该字节
+		OTA_XmodemLinkErr(OTA_LINK_ERR_RXBUF);
+	}
+	else
+	{
+		rx_buf[rx_head] = byte;
+		rx_head = next;
+	}
+	OTA_SchedSetEvent(OTA_EVT_RX);
+	OTA_PROF_END(OTA_PROF_RX_ISR);
+}
+
+/**
+ * @brief  从接收缓冲区读取一个字节
+ * @return 接收到的字节
+ */
+uint8_t OTA_TransReadByte(void)
+{
+	uint8_t byte = rx_buf[rx_tail];
+	rx_tail = (rx_tail + 1U) & RX_MASK;
+	return byte;
+}
+
+/**
+ * @brief  查询接收缓冲区是否为空
+ * @return 1: 为空, 0: 有数据
+ */
+uint8_t OTA_IsTransEmpty(void)
+{
+	return (rx_head == rx_tail) ? 1 : 0;
+}
+
+/**
+ * @brief  串口接收错误回调函数
+ *         USART1_IRQHandler 中读取 SR 检测到 ORE/FE/NE 时调用
+ * @param  err: OTA_LINK_ERR_xxx 位组合
+ */
+OTA_RAMFUNC void OTA_ReceiveErrTask(uint8_t err)
 {
-	OTA_XmodemRevByte(byte);
+	OTA_XmodemLinkErr(err);
 }
 
 /**
  * @brief  Flash 解锁并清除标志位
+ *         XL 大容量型 FLASH_Unlock() 同时解锁 Bank1/Bank2
  * @return 0: 成功
  */
-uint8_t OTA_FlashUnlock(void)
+OTA_RAMFUNC uint8_t OTA_FlashUnlock(void)
 {
     
 }
@@ -56,28 +110,63 @@ uint8_t OTA_FlashUnlock(void)
  * @brief  Flash 上锁
  * @return 0: 成功
  */
-uint8_t OTA_FlashLock(void)
+OTA_RAMFUNC uint8_t OTA_FlashLock(void)
 {
 	
 }
 
 /**
  * @brief  擦除指定地址所在的 Flash 页
+ *         直接操作 FLASH->CR/AR 并在本函数内轮询 BSY，不调用位于 Flash 的库函数
  * @param  addr: 目标页地址
  * @return 0: 成功, 1: 失败
  */
-int OTA_ErasePage(uint32_t addr)
+OTA_RAMFUNC int OTA_ErasePage(uint32_t addr)
+{
+    
+}
+
+/**
+ * @brief  启动擦除指定地址所在的 Flash 页后立即返回
+ *         FLASH->CR |= CR_PER; FLASH->AR = addr; FLASH->CR |= CR_STRT，不等待 BSY
+ *         (addr 位于 Bank2 时使用 CR2/AR2)
+ * @param  addr: 目标页地址
+ * @return 0: 已启动, 1: 失败
+ */
+OTA_RAMFUNC int OTA_EraseStart(uint32_t addr)
+{
+    
+}
+
+/**
+ * @brief  查询 Flash 控制器是否忙
+ * @param  addr: 正在擦除的页地址 (Bank2 读 FLASH->SR2)
+ * @return 1: FLASH->SR 的 BSY 置位, 0: 空闲
+ */
+OTA_RAMFUNC uint8_t OTA_FlashIsBusy(uint32_t addr)
+{
+    
+}
+
+/**
+ * @brief  结束一次后台擦除
+ *         清除 FLASH->CR 的 PER 位，检查并清除 PGERR/WRPRTERR/EOP 标志 (Bank2 对应 CR2/SR2)
+ * @param  addr: 擦除的页地址
+ * @return 0: 成功, 1: 失败
+ */
+OTA_RAMFUNC int OTA_EraseComplete(uint32_t addr)
 {
     
 }
 
 /**
  * @brief  写入半字数据到 Flash
+ *         直接操作 FLASH->CR 并在本函数内轮询 BSY，不调用位于 Flash 的库函数
  * @param  addr: 目标地址
  * @param  data: 16位数据
  * @return 0: 成功, 1: 失败
  */
-int OTA_DrvProgramHalfword(uint32_t addr, uint16_t data)
+OTA_RAMFUNC int OTA_DrvProgramHalfword(uint32_t addr, uint16_t data)
 {
     
 }
@@ -104,20 +193,114 @@ uint8_t OTA_SendByte(uint8_t byte)
 }
 
 /**
- * @brief  发送调试信息到 USART2
- * @param  data: 字符串指针
- * @return 1: 成功, 0: 参数无效
+ * @brief  启动 USART2 调试信息发送
+ *         使能 USART2 TXE 中断，USART2_IRQHandler 中循环调用 OTA_DebugTxTask()，
+ *         返回 0 时关闭 TXE 中断
+ */
+void OTA_DebugTxStart(void)
+{
+    
+}
+
+/**
+ * @brief  喂看门狗
+ *         IAP 模式下每毫秒调用一次，未使用看门狗时留空
+ */
+void OTA_WatchdogFeed(void)
+{
+    
+}
+
+/**
+ * @brief  初始化毫秒时基
+ *         SysTick_Config(SystemCoreClock / 1000)，SysTick_Handler 中累加毫秒计数
+ */
+void OTA_TimebaseInit(void)
+{
+    
+}
+
+/**
+ * @brief  获取单调递增的毫秒计数
+ * @return SysTick_Handler 中累加的毫秒计数
+ */
+uint32_t OTA_GetTickMs(void)
+{
+    
+}
+
+/**
+ * @brief  切换到高性能时钟配置
+ *         HSE 8MHz x9 -> PLL 72MHz: 先 FLASH_PrefetchBufferCmd(ENABLE)、
+ *         FLASH_SetLatency(FLASH_Latency_2)，再切换 SYSCLK 到 PLL (APB1 二分频)，
+ *         最后 SystemCoreClockUpdate() 并重新配置 USART1/USART2 波特率
+ */
+void OTA_ClockHighPerf(void)
+{
+    
+}
+
+/**
+ * @brief  恢复时钟树为复位默认状态
+ *         RCC_DeInit() 切回 HSI 并关闭 PLL 后，再 FLASH_SetLatency(FLASH_Latency_0)
+ *         (须先降频再减少等待周期)，最后 SystemCoreClockUpdate()
+ */
+void OTA_ClockRestore(void)
+{
+    
+}
+
+/**
+ * @brief  控制外部 SPI NOR 的片选
+ *         片选接 PA4 (软件 NSS): sel 为 1 时 GPIO_ResetBits，为 0 时先等待
+ *         SPI_I2S_FLAG_BSY 清零再 GPIO_SetBits
+ * @param  sel: 1-拉低片选, 0-拉高片选
+ */
+void OTA_SpiSelect(uint8_t sel)
+{
+    
+}
+
+/**
+ * @brief  SPI1 收发一个字节
+ *         等待 SPI_I2S_FLAG_TXE 后 SPI_I2S_SendData，再等待 SPI_I2S_FLAG_RXNE 后 SPI_I2S_ReceiveData
+ * @param  byte: 发送的字节
+ * @return 同时收到的字节
+ */
+uint8_t OTA_SpiTransfer(uint8_t byte)
+{
+    
+}
+
+/**
+ * @brief  SPI1 连续收发一段数据
+ *         DMA 实现: DMA1_Channel2 (SPI1_RX) 与 DMA1_Channel3 (SPI1_TX) 同时配置 len 字节，
+ *         tx 为 NULL 时 TX 通道指向一个 0xFF 常量并关闭内存地址自增，rx 为 NULL 时 RX 通道
+ *         写入一个哑字节; SPI_I2S_DMACmd 使能后等待 DMA1_FLAG_TC2 再关闭两个通道;
+ *         不使用 DMA 时循环调用 OTA_SpiTransfer
+ * @param  tx: 发送数据，为 NULL 时发送 0xFF
+ * @param  rx: 接收缓冲区，为 NULL 时丢弃
+ * @param  len: 传输长度
  */
-uint8_t OTA_DebugSend(const char *data)
+void OTA_SpiTransferBlock(const uint8_t *tx, uint8_t *rx, uint32_t len)
 {
     
 }
 
 /**
- * @brief  毫秒级延时函数（基于空操作循环）
- *         注意：此延时精度依赖于 CPU 频率
+ * @brief  硬件 AES-128-CTR 加解密整分组数据 (STM32F10x 没有 CRYP，OTA_AES_HW 须为 0)
+ *         STM32F415/417/437/439 的实现: 关闭 CRYPEN 后 CR 设 ALGOMODE = 110b (AES-CTR)、
+ *         KEYSIZE = 00b (128 位)、DATATYPE = 10b (字节交换，数据按内存顺序送入); 密钥按大端字
+ *         写入 K2LR/K2RR/K3LR/K3RR，计数块按大端字写入 IV0LR/IV0RR/IV1LR/IV1RR; FFLUSH 后置 CRYPEN，
+ *         每个分组在 SR.IFNF 时向 DIN 写 4 个字、SR.OFNE 时从 DOUT 读 4 个字，结束后关闭 CRYPEN;
+ *         分组较多时可用 DMA2_Stream6 (CRYP_IN) / DMA2_Stream5 (CRYP_OUT) 搬运
+ * @param  key: 16 字节密钥
+ * @param  ctr: 16 字节初始计数块
+ * @param  in: 输入数据
+ * @param  out: 输出数据
+ * @param  blocks: 分组数
  */
-void OTA_Delay1ms(void)
+void OTA_AesHwCtr(const uint8_t *key, const uint8_t *ctr, const uint8_t *in, uint8_t *out, uint32_t blocks)
 {
     
 }
@@ -0,0 +1,137 @@
+/**
+ ******************************************************************************
+ * @file    OtaProf.c
+ * @author  MiniOTA Team
+ * @brief   热路径耗时统计模块实现
+ *          目标板使用 DWT CYCCNT 周期计数器，主机仿真使用 clock_gettime，
+ *          两者输出格式一致，便于对比
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 MiniOTA.
+ * All rights reserved.
+ *
+ ******************************************************************************
+ */
+
+#ifdef OTA_HOST_BUILD
+/* 主机仿真: 须在包含任何系统头文件之前定义，-std=c99 下 <time.h> 才声明 clock_gettime 与 CLOCK_MONOTONIC */
+#define _POSIX_C_SOURCE 199309L
+#endif
+
+#include "OtaInterface.h"
+#include "OtaUtils.h"
+#include "OtaLog.h"
+#include "OtaProf.h"
+
+#if OTA_PROF_ENABLE
+
+#ifdef OTA_HOST_BUILD
+#include <time.h>
+#endif
+
+/** 各测量点统计数据，常驻 RAM，可直接在调试器中查看 */
+OTA_PROF_STAT ota_prof_stats[OTA_PROF_POINT_MAX];
+
+/** 各测量点本次开始时刻 */
+uint32_t ota_prof_start[OTA_PROF_POINT_MAX];
+
+/**
+ * @brief  初始化计数器并清空统计数据
+ *         目标板使能 DWT CYCCNT；主机仿真 (定义 OTA_HOST_BUILD) 使用 clock_gettime
+ */
+void OTA_ProfInit(void)
+{
+    OTA_MemSet((uint8_t *)ota_prof_stats, 0, sizeof(ota_prof_stats));
+    for (uint8_t i = 0; i < OTA_PROF_POINT_MAX; i++)
+    {
+        ota_prof_stats[i].min = 0xFFFFFFFFUL;
+    }
+
+#ifndef OTA_HOST_BUILD
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+}
+
+/**
+ * @brief  读取当前计数值 (位于 SRAM，可在接收中断及 Flash 忙期间调用)
+ * @return 目标板为 CPU 周期数，主机仿真为纳秒
+ */
+OTA_RAMFUNC uint32_t OTA_ProfNow(void)
+{
+#ifdef OTA_HOST_BUILD
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec);
+#else
+    return DWT->CYCCNT;
+#endif
+}
+
+/**
+ * @brief  记录一次采样 (位于 SRAM，可在接收中断及 Flash 忙期间调用)
+ * @param  pt: 测量点
+ * @param  ticks: 本次耗时
+ */
+OTA_RAMFUNC void OTA_ProfRecord(OTA_PROF_POINT_E pt, uint32_t ticks)
+{
+    OTA_PROF_STAT *st;
+    uint8_t bin = 0;
+    uint32_t v;
+
+    if (pt >= OTA_PROF_POINT_MAX) return;
+    st = &ota_prof_stats[pt];
+
+    st->count++;
+    st->sum += ticks;
+    if (ticks < st->min) st->min = ticks;
+    if (ticks > st->max) st->max = ticks;
+
+    /* 桶号 = floor(log2(ticks)) - SHIFT，限制在 [0, BINS-1] */
+    v = ticks >> (OTA_PROF_HIST_SHIFT + 1);
+    while (v != 0 && bin < OTA_PROF_HIST_BINS - 1)
+    {
+        v >>= 1;
+        bin++;
+    }
+    st->hist[bin]++;
+}
+
+/**
+ * @brief  通过调试日志输出全部测量点的统计结果 (仅在主循环中调用)
+ */
+void OTA_ProfDump(void)
+{
+    uint32_t args[OTA_LOG_MAX_ARGS];
+
+    for (uint8_t i = 0; i < OTA_PROF_POINT_MAX; i++)
+    {
+        const OTA_PROF_STAT *st = &ota_prof_stats[i];
+
+        if (st->count == 0) continue;
+
+        args[0] = i;
+        args[1] = st->count;
+        args[2] = st->min;
+        args[3] = st->max;
+        args[4] = (uint32_t)(st->sum / st->count);
+        OTA_LogFlush();
+        OTA_LOGI_ARGS(PROF_STAT, 5, args);
+
+        for (uint8_t b = 0; b < OTA_PROF_HIST_BINS; b += 4)
+        {
+            args[0] = i;
+            args[1] = b;
+            args[2] = st->hist[b];
+            args[3] = st->hist[b + 1];
+            args[4] = st->hist[b + 2];
+            args[5] = st->hist[b + 3];
+            OTA_LogFlush();
+            OTA_LOGI_ARGS(PROF_HIST, 6, args);
+        }
+    }
+}
+
+#endif
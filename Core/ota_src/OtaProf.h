@@ -0,0 +1,113 @@
+/**
+ ******************************************************************************
+ * @file    OtaProf.h
+ * @author  MiniOTA Team
+ * @brief   热路径耗时统计模块头文件
+ *          基于 Cortex-M3 DWT 周期计数器 (CYCCNT) 统计各测量点的
+ *          次数 / 最小 / 最大 / 平均耗时及对数直方图。
+ *          OTA_PROF_ENABLE 为 0 (默认) 时全部测量宏编译为空
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 MiniOTA.
+ * All rights reserved.
+ *
+ ******************************************************************************
+ */
+
+#ifndef OTAPROF_H
+#define OTAPROF_H
+
+#include "OtaInterface.h"
+
+#ifndef OTA_PROF_ENABLE
+#define OTA_PROF_ENABLE     0
+#endif
+
+/** 直方图桶数: 第 i 桶统计 [2^(i+SHIFT), 2^(i+SHIFT+1)) 个计数，首尾桶兼收越界值 */
+#define OTA_PROF_HIST_BINS  16
+
+/** 直方图首桶上界 = 2^(OTA_PROF_HIST_SHIFT+1) 个计数 */
+#define OTA_PROF_HIST_SHIFT 6
+
+/**
+ * @brief 测量点枚举 (dump 输出中以序号标识，顺序不可随意调整)
+ */
+typedef enum __OTA_PROF_POINT
+{
+    OTA_PROF_FLASH_ERASE = 0,   /**< 单页擦除 */
+    OTA_PROF_FLASH_PROGRAM,     /**< 单页编程 */
+    OTA_PROF_FLASH_VERIFY,      /**< 单页回读校验 */
+    OTA_PROF_PKT_CRC,           /**< 单包 CRC 计算 */
+    OTA_PROF_RX_ISR,            /**< 接收中断服务 (OTA_ReceiveTask) */
+    OTA_PROF_ACK_TURNAROUND,    /**< 收到包尾 CRC 到发出应答 */
+    OTA_PROF_BOOT_CFG,          /**< OTA_Run: 用户配置检查 */
+    OTA_PROF_BOOT_META,         /**< OTA_Run: 读取并更新 Meta (含分区校验) */
+    OTA_PROF_BOOT_SELECT,       /**< OTA_Run: 选择跳转目标 (含分区校验) */
+    OTA_PROF_SWAP_PAGE,         /**< 交换安装: 单页交换 (三次页复制与进度记录) */
+    OTA_PROF_RELOC,             /**< 安装时重定位: 整个固件 (只改写含重定位项的页) */
+    OTA_PROF_SHA256_BLOCK,      /**< SHA-256: 单个 64 字节分组的压缩 (平均值 / 64 即每字节周期数) */
+    OTA_PROF_SIG_VERIFY,        /**< 签名验证: 一次 Ed25519 验证 (解码公钥、双标量乘与编码) */
+    OTA_PROF_AES_CTR,           /**< AES-CTR: 一次解密调用 (通常为一包数据，耗时 / 字节数即每字节周期数) */
+    OTA_PROF_POINT_MAX
+} OTA_PROF_POINT_E;
+
+/**
+ * @brief 单个测量点的统计数据
+ */
+typedef struct __OTA_PROF_STAT
+{
+    uint32_t count;                     /**< 采样次数 */
+    uint32_t min;                       /**< 最小耗时 */
+    uint32_t max;                       /**< 最大耗时 */
+    uint64_t sum;                       /**< 累计耗时 (用于计算平均值) */
+    uint32_t hist[OTA_PROF_HIST_BINS];  /**< 对数直方图 */
+} OTA_PROF_STAT;
+
+#if OTA_PROF_ENABLE
+
+/** 各测量点统计数据，常驻 RAM，可直接在调试器中查看 */
+extern OTA_PROF_STAT ota_prof_stats[OTA_PROF_POINT_MAX];
+
+/** 各测量点本次开始时刻 */
+extern uint32_t ota_prof_start[OTA_PROF_POINT_MAX];
+
+#define OTA_PROF_INIT()         OTA_ProfInit()
+#define OTA_PROF_BEGIN(pt)      (ota_prof_start[(pt)] = OTA_ProfNow())
+#define OTA_PROF_END(pt)        OTA_ProfRecord((pt), OTA_ProfNow() - ota_prof_start[(pt)])
+#define OTA_PROF_DUMP()         OTA_ProfDump()
+
+#else
+
+#define OTA_PROF_INIT()         ((void)0)
+#define OTA_PROF_BEGIN(pt)      ((void)0)
+#define OTA_PROF_END(pt)        ((void)0)
+#define OTA_PROF_DUMP()         ((void)0)
+
+#endif
+
+/**
+ * @brief  初始化计数器并清空统计数据
+ *         目标板使能 DWT CYCCNT；主机仿真 (定义 OTA_HOST_BUILD) 使用 clock_gettime
+ */
+void OTA_ProfInit(void);
+
+/**
+ * @brief  读取当前计数值 (位于 SRAM，可在接收中断及 Flash 忙期间调用)
+ * @return 目标板为 CPU 周期数，主机仿真为纳秒
+ */
+uint32_t OTA_ProfNow(void);
+
+/**
+ * @brief  记录一次采样 (位于 SRAM，可在接收中断及 Flash 忙期间调用)
+ * @param  pt: 测量点
+ * @param  ticks: 本次耗时
+ */
+void OTA_ProfRecord(OTA_PROF_POINT_E pt, uint32_t ticks);
+
+/**
+ * @brief  通过调试日志输出全部测量点的统计结果 (仅在主循环中调用)
+ */
+void OTA_ProfDump(void);
+
+#endif
@@ -0,0 +1,181 @@
+/**
+ ******************************************************************************
+ * @file    OtaReloc.c
+ * @author  MiniOTA Team
+ * @brief   安装时重定位实现
+ *          重定位表按偏移升序排列，安装时逐页读入页镜像、修正该页中的全部重定位项后整页写回，
+ *          不含重定位项的页不会被擦写; 校验时反向修正，CRC 与链接时的原始固件一致
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 MiniOTA.
+ * All rights reserved.
+ *
+ ******************************************************************************
+ */
+
+#include "OtaInterface.h"
+#include "OtaUtils.h"
+#include "OtaFlash.h"
+#include "OtaBdev.h"
+#include "OtaMeta.h"
+#include "OtaLog.h"
+#include "OtaProf.h"
+#include "OtaImage.h"
+#include "OtaReloc.h"
+
+/**
+ * @brief  读取重定位表尾
+ * @param  img_addr: 固件起始地址
+ * @param  img_size: 固件大小
+ * @return 重定位项数，不带重定位表时为 0
+ */
+static uint32_t Reloc_Count(uint32_t img_addr, uint32_t img_size)
+{
+    OTA_RELOC_TRAILER_E trailer;
+
+    if (img_size < sizeof(trailer))
+    {
+        return 0;
+    }
+    OTA_BdevRead(img_addr + img_size - sizeof(trailer), (uint8_t *)&trailer, sizeof(trailer));
+    if (trailer.magic != OTA_RELOC_MAGIC || trailer.count > (img_size - sizeof(trailer)) / 4U)
+    {
+        return 0;
+    }
+    return trailer.count;
+}
+
+/**
+ * @brief  读取第 idx 个重定位偏移并检查
+ * @param  table: 重定位表相对固件起始的偏移 (即需要重定位的代码与数据的大小)
+ * @param  pos: 上一项之后的偏移，偏移须升序且不小于它
+ * @param  pOff: 输出偏移
+ * @return OTA_TRUE: 偏移有效
+ */
+static OTA_BOOL Reloc_Offset(uint32_t img_addr, uint32_t table, uint32_t idx, uint32_t pos, uint32_t *pOff)
+{
+    OTA_BdevRead(img_addr + table + idx * 4U, (uint8_t *)pOff, sizeof(uint32_t));
+    if ((*pOff & 3U) != 0 || *pOff < pos || table < 4U || *pOff > table - 4U)
+    {
+        return OTA_FALSE;
+    }
+    return OTA_TRUE;
+}
+
+/**
+ * @brief  获取插槽中固件的重定位量
+ * @param  slot_addr: 固件所在插槽的起始地址
+ * @param  run_slot_addr: 固件运行插槽的起始地址
+ * @return 重定位量
+ */
+uint32_t OTA_RelocDelta(uint32_t slot_addr, uint32_t run_slot_addr)
+{
+    OTA_IMG_INFO_E info;
+
+    if (OTA_ImageLoad(slot_addr, &info) != OTA_TRUE)
+    {
+        return 0;
+    }
+    return run_slot_addr + info.hdr_len - (info.has_load_addr ? info.load_addr : 0UL);
+}
+
+/**
+ * @brief  分段计算固件的 CRC16，已重定位的字先减去重定位量
+ * @param  crc: 上一段的计算结果，首段传 0
+ * @param  img_addr: 固件体起始地址
+ * @param  img_size: 固件体大小
+ * @param  delta: 重定位量
+ * @return 累计的 CRC16 校验值
+ */
+uint16_t OTA_RelocCrc16(uint16_t crc, uint32_t img_addr, uint32_t img_size, uint32_t delta)
+{
+    uint32_t count = Reloc_Count(img_addr, img_size);
+    uint32_t table = img_size - sizeof(OTA_RELOC_TRAILER_E) - count * 4U;
+    uint32_t pos = 0;
+    uint32_t off;
+    uint32_t word;
+
+    for (uint32_t idx = 0; idx < count; idx++)
+    {
+        if (Reloc_Offset(img_addr, table, idx, pos, &off) != OTA_TRUE)
+        {
+            // 表无效时固件不会被重定位，其余部分按原样计算
+            break;
+        }
+        crc = OTA_BdevUpdateCrc16(crc, img_addr + pos, off - pos);
+        OTA_BdevRead(img_addr + off, (uint8_t *)&word, sizeof(word));
+        word -= delta;
+        crc = OTA_UpdateCrc16(crc, (const uint8_t *)&word, sizeof(word));
+        pos = off + sizeof(word);
+    }
+    return OTA_BdevUpdateCrc16(crc, img_addr + pos, img_size - pos);
+}
+
+/**
+ * @brief  按运行地址重定位插槽中刚下载的固件
+ * @param  slot: 固件所在插槽
+ * @return 0: 成功, 1: 重定位表无效或写入失败
+ */
+int OTA_RelocApply(OTA_ACIVE_SLOT_E slot)
+{
+    OTA_IMG_INFO_E info;
+    uint32_t img_addr;
+    uint32_t delta;
+    uint32_t page = 0;
+    uint32_t count;
+    uint32_t table;
+    uint32_t pos = 0;
+    uint32_t off;
+    uint32_t addr;
+    uint32_t word;
+
+    if (OTA_ImageLoad(OTA_MetaSlotAddr(slot), &info) != OTA_TRUE ||
+        OTA_ImageCheck(&info, OTA_MetaSlotSize(slot), OTA_ImageRunSlotAddr(slot)) != 0)
+    {
+        return 1;
+    }
+    img_addr = OTA_MetaSlotAddr(slot) + info.hdr_len;
+    count = Reloc_Count(img_addr, info.img_size);
+    if (count == 0)
+    {
+        return 0;
+    }
+    table = info.img_size - sizeof(OTA_RELOC_TRAILER_E) - count * 4U;
+    delta = OTA_RelocDelta(OTA_MetaSlotAddr(slot), OTA_ImageRunSlotAddr(slot));
+
+    OTA_PROF_BEGIN(OTA_PROF_RELOC);
+    for (uint32_t idx = 0; idx < count; idx++)
+    {
+        if (Reloc_Offset(img_addr, table, idx, pos, &off) != OTA_TRUE)
+        {
+            OTA_LOGE(RELOC_FAIL);
+            return 1;
+        }
+        addr = img_addr + off;
+        // 插槽按页对齐，固件起始与重定位项均 4 字节对齐，重定位的字不会跨页
+        if (page == 0 || addr - page >= OTA_FLASH_PAGE_SIZE)
+        {
+            if (page != 0 && OTA_FlashWrite() != 0)
+            {
+                OTA_LOGE(RELOC_FAIL);
+                return 1;
+            }
+            page = addr / OTA_FLASH_PAGE_SIZE * OTA_FLASH_PAGE_SIZE;
+            OTA_FlashHandleInit(page);
+        }
+        OTA_MemCopy((uint8_t *)&word, OTA_FlashGetMirr() + (addr - page), sizeof(word));
+        word += delta;
+        OTA_MemCopy(OTA_FlashGetMirr() + (addr - page), (const uint8_t *)&word, sizeof(word));
+        pos = off + sizeof(word);
+    }
+    if (OTA_FlashWrite() != 0)
+    {
+        OTA_LOGE(RELOC_FAIL);
+        return 1;
+    }
+    OTA_PROF_END(OTA_PROF_RELOC);
+
+    OTA_LOGI_HEX(RELOC_DONE, count);
+    return 0;
+}
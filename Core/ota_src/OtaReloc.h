@@ -0,0 +1,64 @@
+/**
+ ******************************************************************************
+ * @file    OtaReloc.h
+ * @author  MiniOTA Team
+ * @brief   安装时重定位头文件
+ *          固件以 0 (或 v2 固件头中的 OTA_TLV_LOAD_ADDR) 为基址链接，尾部附带重定位表; 下载完成后按运行地址修正表中列出的绝对地址字，
+ *          同一个固件文件可以运行在任意插槽
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 MiniOTA.
+ * All rights reserved.
+ *
+ ******************************************************************************
+ */
+
+#ifndef OTARELOC_H
+#define OTARELOC_H
+
+#include "OtaInterface.h"
+#include "OtaUtils.h"
+
+#define OTA_RELOC_MAGIC     0x4F4C4552  /**< "RELO" - 重定位表尾魔数 */
+
+/**
+ * @brief 重定位表尾部结构 (固件体的最后 8 字节)
+ *        其前为 count 个升序排列的 uint32_t 偏移 (相对于固件体起始，4 字节对齐)，
+ *        每个偏移处的字在安装时加上重定位量; 重定位表计入 img_size 与 CRC
+ */
+typedef struct __OTA_RELOC_TRAILER
+{
+    uint32_t count;         /**< 重定位项数 */
+    uint32_t magic;         /**< OTA_RELOC_MAGIC */
+} OTA_RELOC_TRAILER_E;
+
+/**
+ * @brief  分段计算固件的 CRC16，已重定位的字先减去重定位量，结果与链接时的原始固件一致
+ *         不带重定位表的固件等同于 OTA_BdevUpdateCrc16
+ * @param  crc: 上一段的计算结果 (v2 固件头的 TLV 扩展区)，首段传 0
+ * @param  img_addr: 固件体起始地址 (固件头之后)
+ * @param  img_size: 固件体大小
+ * @param  delta: 重定位量 (固件体运行地址 - 链接地址)
+ * @return 累计的 CRC16 校验值
+ */
+uint16_t OTA_RelocCrc16(uint16_t crc, uint32_t img_addr, uint32_t img_size, uint32_t delta);
+
+/**
+ * @brief  获取插槽中固件的重定位量
+ *         运行地址取固件的运行插槽 (OTA_ImageRunSlotAddr)，链接地址取 OTA_TLV_LOAD_ADDR，未给出时为 0
+ * @param  slot_addr: 固件所在插槽的起始地址
+ * @param  run_slot_addr: 固件运行插槽的起始地址
+ * @return 重定位量
+ */
+uint32_t OTA_RelocDelta(uint32_t slot_addr, uint32_t run_slot_addr);
+
+/**
+ * @brief  按运行地址重定位插槽中刚下载的固件 (只改写含重定位项的页)
+ *         须在标记插槽待确认之前调用; 不带重定位表的固件直接返回成功
+ * @param  slot: 固件所在插槽
+ * @return 0: 成功, 1: 重定位表无效或写入失败
+ */
+int OTA_RelocApply(OTA_ACIVE_SLOT_E slot);
+
+#endif
@@ -0,0 +1,125 @@
+/**
+ ******************************************************************************
+ * @file    OtaRepair.c
+ * @author  MiniOTA Team
+ * @brief   分块修复实现
+ *          分块 CRC 覆盖固件体 (不含固件头)，其他插槽中固件体同一偏移处的内容 CRC 一致即可复制;
+ *          复制经页镜像按页读-改-写，内部 Flash 与外部暂存分区均适用
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 MiniOTA.
+ * All rights reserved.
+ *
+ ******************************************************************************
+ */
+
+#include "OtaInterface.h"
+#include "OtaUtils.h"
+#include "OtaFlash.h"
+#include "OtaBdev.h"
+#include "OtaMeta.h"
+#include "OtaLog.h"
+#include "OtaImage.h"
+#include "OtaRepair.h"
+
+#if OTA_REPAIR_ENABLE
+
+/**
+ * @brief  在其他插槽中查找与损坏分块内容一致的位置并复制
+ * @param  slot: 损坏的插槽
+ * @param  dst: 分块在损坏插槽中的地址
+ * @param  off: 分块相对固件体起始的偏移
+ * @param  len: 分块长度
+ * @param  crc: 分块的 CRC16
+ * @return OTA_TRUE: 已复制
+ */
+static OTA_BOOL Repair_CopyChunk(OTA_ACIVE_SLOT_E slot, uint32_t dst, uint32_t off, uint32_t len, uint16_t crc)
+{
+    OTA_IMG_INFO_E info;
+    uint32_t src;
+    uint8_t  buf[64];
+    uint32_t n;
+
+    for (uint8_t other = 0; other < OTA_SLOT_NUM; other++)
+    {
+        if (other == slot || OTA_ImageLoad(OTA_MetaSlotAddr((OTA_ACIVE_SLOT_E)other), &info) != OTA_TRUE ||
+            info.hdr_len + off + len > OTA_MetaSlotSize((OTA_ACIVE_SLOT_E)other))
+        {
+            continue;
+        }
+        src = OTA_MetaSlotAddr((OTA_ACIVE_SLOT_E)other) + info.hdr_len + off;
+        if (OTA_BdevCrc16(src, len) != crc)
+        {
+            continue;
+        }
+
+        for (uint32_t i = 0; i < len; i += n)
+        {
+            n = (len - i < sizeof(buf)) ? len - i : sizeof(buf);
+            OTA_BdevRead(src + i, buf, n);
+            if (OTA_FlashPatch(dst + i, buf, n) != 0)
+            {
+                return OTA_FALSE;
+            }
+        }
+        return OTA_TRUE;
+    }
+    return OTA_FALSE;
+}
+
+/**
+ * @brief  逐块检查插槽中的固件并修复
+ * @param  slot: 校验失败的插槽
+ * @return 0: 所有分块均已完好, 1: 仍有损坏的块或无法修复
+ */
+int OTA_RepairSlot(OTA_ACIVE_SLOT_E slot)
+{
+    OTA_IMG_INFO_E info;
+    uint32_t slot_addr = OTA_MetaSlotAddr(slot);
+    uint32_t body;
+    uint32_t off;
+    uint32_t len;
+    uint32_t bad = 0;
+    uint32_t copied = 0;
+    uint16_t crc;
+
+    if (OTA_ImageLoad(slot_addr, &info) != OTA_TRUE || info.chunk_num == 0 ||
+        (info.flags & OTA_IMG_FLAG_RELOC) != 0 ||
+        OTA_ImageCheck(&info, OTA_MetaSlotSize(slot), OTA_ImageRunSlotAddr(slot)) != 0)
+    {
+        return 1;
+    }
+
+    body = slot_addr + info.hdr_len;
+    OTA_FlashHandleInit(body - body % OTA_FLASH_PAGE_SIZE);
+    for (uint32_t idx = 0; idx < info.chunk_num; idx++)
+    {
+        off = idx * info.chunk_size;
+        len = (info.img_size - off < info.chunk_size) ? info.img_size - off : info.chunk_size;
+        OTA_BdevRead(slot_addr + info.chunk_off + idx * 2U, (uint8_t *)&crc, sizeof(crc));
+        if (OTA_BdevCrc16(body + off, len) == crc)
+        {
+            continue;
+        }
+        if (Repair_CopyChunk(slot, body + off, off, len, crc))
+        {
+            copied++;
+            continue;
+        }
+        OTA_LOGE_HEX(REPAIR_BAD_CHUNK, idx);
+        bad++;
+    }
+    if (OTA_FlashFlush() != 0)
+    {
+        return 1;
+    }
+
+    if (copied > 0)
+    {
+        OTA_LOGI_HEX(REPAIR_COPIED, copied);
+    }
+    return (bad == 0) ? 0 : 1;
+}
+
+#endif
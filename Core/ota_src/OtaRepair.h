@@ -0,0 +1,31 @@
+/**
+ ******************************************************************************
+ * @file    OtaRepair.h
+ * @author  MiniOTA Team
+ * @brief   分块修复头文件
+ *          v2 固件头中的 OTA_TLV_CHUNKS 给出固件体每个分块的 CRC16; 插槽校验失败时
+ *          按分块找出损坏的位置，能从其他插槽复制的直接复制，其余由上位机以修复流补发
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 MiniOTA.
+ * All rights reserved.
+ *
+ ******************************************************************************
+ */
+
+#ifndef OTAREPAIR_H
+#define OTAREPAIR_H
+
+#include "OtaInterface.h"
+#include "OtaUtils.h"
+
+/**
+ * @brief  逐块检查插槽中的固件，损坏的块从其他插槽复制，无法复制的块输出序号
+ *         固件头无效、不带分块 CRC 表或带重定位表时不处理
+ * @param  slot: 校验失败的插槽
+ * @return 0: 所有分块均已完好 (调用者应重新校验整个固件), 1: 仍有损坏的块或无法修复
+ */
+int OTA_RepairSlot(OTA_ACIVE_SLOT_E slot);
+
+#endif
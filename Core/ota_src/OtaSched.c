@@ -0,0 +1,107 @@
+/**
+ ******************************************************************************
+ * @file    OtaSched.c
+ * @author  MiniOTA Team
+ * @brief   协作式事件调度器实现
+ *          表驱动的运行至完成调度，空闲时 __WFI 降低 IAP 模式功耗
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 MiniOTA.
+ * All rights reserved.
+ *
+ ******************************************************************************
+ */
+
+#include "OtaInterface.h"
+#include "OtaPort.h"
+#include "OtaUtils.h"
+#include "OtaSched.h"
+
+/** 待处理事件 */
+static volatile uint32_t sched_events;
+
+/** 上一轮调度时的毫秒计数，用于产生 OTA_EVT_TICK */
+static uint32_t sched_last_tick;
+
+/**
+ * @brief  置位事件 (中断与主循环中均可调用)
+ * @param  evt: 事件位组合
+ */
+OTA_RAMFUNC void OTA_SchedSetEvent(uint32_t evt)
+{
+    uint32_t primask;
+
+    OTA_ENTER_CRITICAL(primask);
+    sched_events |= evt;
+    OTA_EXIT_CRITICAL(primask);
+}
+
+/**
+ * @brief  取出待处理事件并运行关注这些事件的任务
+ * @param  tasks: 任务表
+ * @param  count: 任务数
+ * @param  sleep: 没有待处理事件时是否 __WFI
+ * @return 本轮处理的事件位组合
+ */
+static uint32_t Sched_Run(const OTA_SCHED_TASK *tasks, uint8_t count, OTA_BOOL sleep)
+{
+    uint32_t primask;
+    uint32_t evts;
+    uint32_t now = OTA_GetTickMs();
+
+    if (now != sched_last_tick)
+    {
+        sched_last_tick = now;
+        OTA_SchedSetEvent(OTA_EVT_TICK);
+    }
+
+    /* 关中断后再检查事件: 若检查与 WFI 之间来了中断，
+       挂起的中断仍会唤醒 WFI，不会错过事件 */
+    OTA_ENTER_CRITICAL(primask);
+    evts = sched_events;
+    sched_events = 0;
+#if OTA_SCHED_USE_WFI
+    if (evts == 0 && sleep)
+    {
+        __WFI();
+    }
+#else
+    (void)sleep;
+#endif
+    OTA_EXIT_CRITICAL(primask);
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        if ((tasks[i].events & evts) != 0 && tasks[i].fn != 0)
+        {
+            tasks[i].fn();
+        }
+    }
+
+    return evts;
+}
+
+/**
+ * @brief  运行一轮调度
+ *         取出并清除全部待处理事件，按表顺序运行关注这些事件的任务；
+ *         若没有待处理事件则 __WFI 睡眠直到下一次中断
+ * @param  tasks: 任务表
+ * @param  count: 任务数
+ * @return 本轮处理的事件位组合
+ */
+uint32_t OTA_SchedRunOnce(const OTA_SCHED_TASK *tasks, uint8_t count)
+{
+    return Sched_Run(tasks, count, OTA_TRUE);
+}
+
+/**
+ * @brief  运行一轮调度但不睡眠 (供 App 主循环/RTOS 任务中周期调用)
+ * @param  tasks: 任务表
+ * @param  count: 任务数
+ * @return 本轮处理的事件位组合
+ */
+uint32_t OTA_SchedPoll(const OTA_SCHED_TASK *tasks, uint8_t count)
+{
+    return Sched_Run(tasks, count, OTA_FALSE);
+}
@@ -0,0 +1,75 @@
+/**
+ ******************************************************************************
+ * @file    OtaSched.h
+ * @author  MiniOTA Team
+ * @brief   协作式事件调度器头文件
+ *          中断只置事件标志，任务在主循环中按表顺序运行至完成；
+ *          没有待处理事件时执行 __WFI 进入睡眠
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 MiniOTA.
+ * All rights reserved.
+ *
+ ******************************************************************************
+ */
+
+#ifndef OTASCHED_H
+#define OTASCHED_H
+
+#include "OtaInterface.h"
+
+/** @defgroup OTA_Sched_Events
+ * @{
+ */
+#define OTA_EVT_RX          (1UL << 0)  /**< 接收缓冲区有新数据 */
+#define OTA_EVT_FLASH       (1UL << 1)  /**< 有待提交的 Flash 页 */
+#define OTA_EVT_TICK        (1UL << 2)  /**< 毫秒计数发生变化 (由调度器自动产生) */
+#define OTA_EVT_USER        (1UL << 8)  /**< 用户自定义事件起始位 */
+/**
+ * @}
+ */
+
+#ifndef OTA_SCHED_USE_WFI
+#define OTA_SCHED_USE_WFI   1
+#endif
+
+/**
+ * @brief 任务函数指针类型
+ */
+typedef void (*ota_task_fn_t)(void);
+
+/**
+ * @brief 任务表项: 任一关注的事件置位时运行一次
+ */
+typedef struct __OTA_SCHED_TASK
+{
+    uint32_t      events;   /**< 关注的事件位 */
+    ota_task_fn_t fn;       /**< 任务函数 */
+} OTA_SCHED_TASK;
+
+/**
+ * @brief  置位事件 (中断与主循环中均可调用)
+ * @param  evt: 事件位组合
+ */
+void OTA_SchedSetEvent(uint32_t evt);
+
+/**
+ * @brief  运行一轮调度
+ *         取出并清除全部待处理事件，按表顺序运行关注这些事件的任务；
+ *         若没有待处理事件则 __WFI 睡眠直到下一次中断
+ * @param  tasks: 任务表
+ * @param  count: 任务数
+ * @return 本轮处理的事件位组合
+ */
+uint32_t OTA_SchedRunOnce(const OTA_SCHED_TASK *tasks, uint8_t count);
+
+/**
+ * @brief  运行一轮调度但不睡眠 (供 App 主循环/RTOS 任务中周期调用)
+ * @param  tasks: 任务表
+ * @param  count: 任务数
+ * @return 本轮处理的事件位组合
+ */
+uint32_t OTA_SchedPoll(const OTA_SCHED_TASK *tasks, uint8_t count);
+
+#endif
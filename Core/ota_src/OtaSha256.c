@@ -0,0 +1,194 @@
+/**
+ ******************************************************************************
+ * @file    OtaSha256.c
+ * @author  MiniOTA Team
+ * @brief   SHA-256 流式摘要实现 (FIPS 180-4)
+ *          面向 Cortex-M3: 轮函数按 8 轮展开，8 个工作变量轮换命名而不搬移，
+ *          消息扩展使用 16 字的环形缓冲随轮计算，栈占用约 100 字节;
+ *          循环移位写成 (x >> n) | (x << (32 - n))，编译为单条 ROR
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 MiniOTA.
+ * All rights reserved.
+ *
+ ******************************************************************************
+ */
+
+#include "OtaInterface.h"
+#include "OtaUtils.h"
+#include "OtaProf.h"
+#include "OtaSha256.h"
+
+static const uint32_t sha256_k[64] =
+{
+    0x428A2F98UL, 0x71374491UL, 0xB5C0FBCFUL, 0xE9B5DBA5UL, 0x3956C25BUL, 0x59F111F1UL, 0x923F82A4UL, 0xAB1C5ED5UL,
+    0xD807AA98UL, 0x12835B01UL, 0x243185BEUL, 0x550C7DC3UL, 0x72BE5D74UL, 0x80DEB1FEUL, 0x9BDC06A7UL, 0xC19BF174UL,
+    0xE49B69C1UL, 0xEFBE4786UL, 0x0FC19DC6UL, 0x240CA1CCUL, 0x2DE92C6FUL, 0x4A7484AAUL, 0x5CB0A9DCUL, 0x76F988DAUL,
+    0x983E5152UL, 0xA831C66DUL, 0xB00327C8UL, 0xBF597FC7UL, 0xC6E00BF3UL, 0xD5A79147UL, 0x06CA6351UL, 0x14292967UL,
+    0x27B70A85UL, 0x2E1B2138UL, 0x4D2C6DFCUL, 0x53380D13UL, 0x650A7354UL, 0x766A0ABBUL, 0x81C2C92EUL, 0x92722C85UL,
+    0xA2BFE8A1UL, 0xA81A664BUL, 0xC24B8B70UL, 0xC76C51A3UL, 0xD192E819UL, 0xD6990624UL, 0xF40E3585UL, 0x106AA070UL,
+    0x19A4C116UL, 0x1E376C08UL, 0x2748774CUL, 0x34B0BCB5UL, 0x391C0CB3UL, 0x4ED8AA4AUL, 0x5B9CCA4FUL, 0x682E6FF3UL,
+    0x748F82EEUL, 0x78A5636FUL, 0x84C87814UL, 0x8CC70208UL, 0x90BEFFFAUL, 0xA4506CEBUL, 0xBEF9A3F7UL, 0xC67178F2UL,
+};
+
+#define SHA_ROR(x, n)       (((x) >> (n)) | ((x) << (32U - (n))))
+#define SHA_S0(x)           (SHA_ROR((x), 2U) ^ SHA_ROR((x), 13U) ^ SHA_ROR((x), 22U))
+#define SHA_S1(x)           (SHA_ROR((x), 6U) ^ SHA_ROR((x), 11U) ^ SHA_ROR((x), 25U))
+#define SHA_G0(x)           (SHA_ROR((x), 7U) ^ SHA_ROR((x), 18U) ^ ((x) >> 3))
+#define SHA_G1(x)           (SHA_ROR((x), 17U) ^ SHA_ROR((x), 19U) ^ ((x) >> 10))
+#define SHA_CH(x, y, z)     ((z) ^ ((x) & ((y) ^ (z))))
+#define SHA_MAJ(x, y, z)    (((x) & (y)) | ((z) & ((x) | (y))))
+
+/** 前 16 轮直接使用分组中的字 */
+#define SHA_W_LOAD(i)       (w[(i)])
+/** 之后的轮在环形缓冲中原地扩展出 W[i] */
+#define SHA_W_EXPAND(i)     (w[(i) & 15U] += SHA_G1(w[((i) - 2U) & 15U]) + w[((i) - 7U) & 15U] + \
+                                             SHA_G0(w[((i) - 15U) & 15U]))
+
+/** 单轮: 只更新 d 与 h，其余变量由调用处轮换名称 */
+#define SHA_ROUND(a, b, c, d, e, f, g, h, i, W)                                 \
+    do {                                                                        \
+        uint32_t t1 = (h) + SHA_S1(e) + SHA_CH((e), (f), (g)) + sha256_k[(i)] + W(i); \
+        (d) += t1;                                                              \
+        (h) = t1 + SHA_S0(a) + SHA_MAJ((a), (b), (c));                          \
+    } while (0)
+
+/** 8 轮展开，之后工作变量回到原来的名称 */
+#define SHA_ROUND8(i, W)                                    \
+    do {                                                    \
+        SHA_ROUND(a, b, c, d, e, f, g, h, (i) + 0U, W);     \
+        SHA_ROUND(h, a, b, c, d, e, f, g, (i) + 1U, W);     \
+        SHA_ROUND(g, h, a, b, c, d, e, f, (i) + 2U, W);     \
+        SHA_ROUND(f, g, h, a, b, c, d, e, (i) + 3U, W);     \
+        SHA_ROUND(e, f, g, h, a, b, c, d, (i) + 4U, W);     \
+        SHA_ROUND(d, e, f, g, h, a, b, c, (i) + 5U, W);     \
+        SHA_ROUND(c, d, e, f, g, h, a, b, (i) + 6U, W);     \
+        SHA_ROUND(b, c, d, e, f, g, h, a, (i) + 7U, W);     \
+    } while (0)
+
+/**
+ * @brief  压缩一个 64 字节分组
+ * @param  state: 中间哈希值
+ * @param  block: 分组数据 (无对齐要求)
+ */
+static void Sha256_Block(uint32_t state[8], const uint8_t *block)
+{
+    uint32_t w[16];
+    uint32_t a, b, c, d, e, f, g, h;
+    uint32_t i;
+
+    OTA_PROF_BEGIN(OTA_PROF_SHA256_BLOCK);
+    for (i = 0; i < 16U; i++)
+    {
+        w[i] = ((uint32_t)block[0] << 24) | ((uint32_t)block[1] << 16) |
+               ((uint32_t)block[2] << 8) | (uint32_t)block[3];
+        block += 4;
+    }
+
+    a = state[0]; b = state[1]; c = state[2]; d = state[3];
+    e = state[4]; f = state[5]; g = state[6]; h = state[7];
+
+    for (i = 0; i < 16U; i += 8U)
+    {
+        SHA_ROUND8(i, SHA_W_LOAD);
+    }
+    for (; i < 64U; i += 8U)
+    {
+        SHA_ROUND8(i, SHA_W_EXPAND);
+    }
+
+    state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+    state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+    OTA_PROF_END(OTA_PROF_SHA256_BLOCK);
+}
+
+/**
+ * @brief  开始计算摘要
+ * @param  pCtx: 计算上下文
+ */
+void OTA_Sha256Init(OTA_SHA256_CTX_E *pCtx)
+{
+    pCtx->state[0] = 0x6A09E667UL;
+    pCtx->state[1] = 0xBB67AE85UL;
+    pCtx->state[2] = 0x3C6EF372UL;
+    pCtx->state[3] = 0xA54FF53AUL;
+    pCtx->state[4] = 0x510E527FUL;
+    pCtx->state[5] = 0x9B05688CUL;
+    pCtx->state[6] = 0x1F83D9ABUL;
+    pCtx->state[7] = 0x5BE0CD19UL;
+    pCtx->total    = 0;
+    pCtx->buf_len  = 0;
+}
+
+/**
+ * @brief  输入数据: 先补满缓存的分组，其余整组直接从输入压缩，不经过缓存
+ * @param  pCtx: 计算上下文
+ * @param  data: 数据
+ * @param  len: 数据长度
+ */
+void OTA_Sha256Update(OTA_SHA256_CTX_E *pCtx, const uint8_t *data, uint32_t len)
+{
+    uint32_t n;
+
+    pCtx->total += len;
+    if (pCtx->buf_len > 0)
+    {
+        n = OTA_SHA256_BLOCK_SIZE - pCtx->buf_len;
+        n = (len < n) ? len : n;
+        OTA_MemCopy(&pCtx->buf[pCtx->buf_len], data, n);
+        pCtx->buf_len += n;
+        data += n;
+        len  -= n;
+        if (pCtx->buf_len < OTA_SHA256_BLOCK_SIZE)
+        {
+            return;
+        }
+        Sha256_Block(pCtx->state, pCtx->buf);
+        pCtx->buf_len = 0;
+    }
+    while (len >= OTA_SHA256_BLOCK_SIZE)
+    {
+        Sha256_Block(pCtx->state, data);
+        data += OTA_SHA256_BLOCK_SIZE;
+        len  -= OTA_SHA256_BLOCK_SIZE;
+    }
+    OTA_MemCopy(pCtx->buf, data, len);
+    pCtx->buf_len = len;
+}
+
+/**
+ * @brief  结束计算: 补 0x80 与 0，最后 8 字节为按位计的长度 (大端)
+ * @param  pCtx: 计算上下文
+ * @param  digest: 输出 32 字节摘要
+ */
+void OTA_Sha256Final(OTA_SHA256_CTX_E *pCtx, uint8_t digest[OTA_SHA256_DIGEST_SIZE])
+{
+    uint32_t i;
+
+    pCtx->buf[pCtx->buf_len++] = 0x80;
+    if (pCtx->buf_len > OTA_SHA256_BLOCK_SIZE - 8U)
+    {
+        OTA_MemSet(&pCtx->buf[pCtx->buf_len], 0, OTA_SHA256_BLOCK_SIZE - pCtx->buf_len);
+        Sha256_Block(pCtx->state, pCtx->buf);
+        pCtx->buf_len = 0;
+    }
+    OTA_MemSet(&pCtx->buf[pCtx->buf_len], 0, OTA_SHA256_BLOCK_SIZE - 8U - pCtx->buf_len);
+    pCtx->buf[56] = 0;
+    pCtx->buf[57] = 0;
+    pCtx->buf[58] = 0;
+    pCtx->buf[59] = (uint8_t)(pCtx->total >> 29);
+    pCtx->buf[60] = (uint8_t)(pCtx->total >> 21);
+    pCtx->buf[61] = (uint8_t)(pCtx->total >> 13);
+    pCtx->buf[62] = (uint8_t)(pCtx->total >> 5);
+    pCtx->buf[63] = (uint8_t)(pCtx->total << 3);
+    Sha256_Block(pCtx->state, pCtx->buf);
+
+    for (i = 0; i < 8U; i++)
+    {
+        digest[i * 4U + 0U] = (uint8_t)(pCtx->state[i] >> 24);
+        digest[i * 4U + 1U] = (uint8_t)(pCtx->state[i] >> 16);
+        digest[i * 4U + 2U] = (uint8_t)(pCtx->state[i] >> 8);
+        digest[i * 4U + 3U] = (uint8_t)pCtx->state[i];
+    }
+}
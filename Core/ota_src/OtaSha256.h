@@ -0,0 +1,57 @@
+/**
+ ******************************************************************************
+ * @file    OtaSha256.h
+ * @author  MiniOTA Team
+ * @brief   SHA-256 流式摘要头文件
+ *          接收固件时随数据逐包更新，传输结束时得到摘要，无需再读一遍插槽
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 MiniOTA.
+ * All rights reserved.
+ *
+ ******************************************************************************
+ */
+
+#ifndef OTASHA256_H
+#define OTASHA256_H
+
+#include "OtaInterface.h"
+#include "OtaUtils.h"
+
+#define OTA_SHA256_DIGEST_SIZE  32U     /**< 摘要长度 (字节) */
+#define OTA_SHA256_BLOCK_SIZE   64U     /**< 分组长度 (字节) */
+
+/**
+ * @brief SHA-256 计算上下文
+ */
+typedef struct __OTA_SHA256_CTX
+{
+    uint32_t state[8];                      /**< 中间哈希值 */
+    uint32_t total;                         /**< 已输入的字节数 (固件不超过 4GB) */
+    uint32_t buf_len;                       /**< buf 中未满一个分组的字节数 */
+    uint8_t  buf[OTA_SHA256_BLOCK_SIZE];    /**< 未满一个分组的数据 */
+} OTA_SHA256_CTX_E;
+
+/**
+ * @brief  开始计算摘要
+ * @param  pCtx: 计算上下文
+ */
+void OTA_Sha256Init(OTA_SHA256_CTX_E *pCtx);
+
+/**
+ * @brief  输入数据，可分多次调用，每次长度任意
+ * @param  pCtx: 计算上下文
+ * @param  data: 数据
+ * @param  len: 数据长度
+ */
+void OTA_Sha256Update(OTA_SHA256_CTX_E *pCtx, const uint8_t *data, uint32_t len);
+
+/**
+ * @brief  结束计算并输出摘要 (之后须重新 OTA_Sha256Init)
+ * @param  pCtx: 计算上下文
+ * @param  digest: 输出 32 字节摘要
+ */
+void OTA_Sha256Final(OTA_SHA256_CTX_E *pCtx, uint8_t digest[OTA_SHA256_DIGEST_SIZE]);
+
+#endif
@@ -0,0 +1,95 @@
+/**
+ ******************************************************************************
+ * @file    OtaSig.c
+ * @author  MiniOTA Team
+ * @brief   固件签名验证实现
+ *          被签名的消息为固件头本身 (img_crc16 与签名值置 0)，长度不超过 OTA_IMG_HDR_MAX，
+ *          一次 Ed25519 验证的耗时与固件大小无关; 固件体由固件头中的 SHA-256 摘要间接覆盖
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 MiniOTA.
+ * All rights reserved.
+ *
+ ******************************************************************************
+ */
+
+#include "OtaInterface.h"
+#include "OtaUtils.h"
+#include "OtaBdev.h"
+#include "OtaImage.h"
+#include "OtaSha256.h"
+#include "OtaEd25519.h"
+#include "OtaSig.h"
+
+/** img_crc16 在固件头中的偏移: 签名之后才计算 CRC，签名时按 0 计算 */
+#define SIG_CRC_OFF     12U
+
+/** 内置公钥 */
+static const uint8_t sig_pubkey[OTA_ED25519_KEY_SIZE] = OTA_SIG_PUBKEY;
+
+/** 被签名的消息; 验证插槽时先作为读取固件体的缓存 */
+static uint8_t sig_buf[OTA_IMG_HDR_MAX];
+
+/**
+ * @brief  用内置公钥验证固件头的签名
+ * @param  hdr: 完整的固件头
+ * @param  pInfo: 固件头信息
+ * @return 0: 签名有效, 1: 无效
+ */
+int OTA_SigVerifyHeader(const uint8_t *hdr, const OTA_IMG_INFO_E *pInfo)
+{
+    uint8_t sig[OTA_ED25519_SIG_SIZE];
+
+    if (pInfo->hash_off == 0 || pInfo->sig_off == 0)
+    {
+        return 1;
+    }
+    // 先取出签名值，hdr 可以就是 sig_buf
+    OTA_MemCopy(sig, &hdr[pInfo->sig_off], OTA_ED25519_SIG_SIZE);
+    OTA_MemCopy(sig_buf, hdr, pInfo->hdr_len);
+    OTA_MemSet(&sig_buf[SIG_CRC_OFF], 0, sizeof(uint16_t));
+    OTA_MemSet(&sig_buf[pInfo->sig_off], 0, OTA_ED25519_SIG_SIZE);
+    return OTA_Ed25519Verify(sig, sig_pubkey, sig_buf, pInfo->hdr_len);
+}
+
+/**
+ * @brief  验证插槽中的固件 (摘要 + 签名)
+ * @param  slot_addr: 插槽起始地址
+ * @return 0: 签名有效, 1: 无效
+ */
+int OTA_SigVerifySlot(uint32_t slot_addr)
+{
+    OTA_IMG_INFO_E info;
+    OTA_SHA256_CTX_E sha;
+    uint8_t  digest[OTA_SHA256_DIGEST_SIZE];
+    uint8_t  diff = 0;
+    uint32_t off;
+    uint32_t n;
+
+    if (OTA_ImageLoad(slot_addr, &info) != OTA_TRUE || info.hash_off == 0 || info.sig_off == 0)
+    {
+        return 1;
+    }
+
+    OTA_Sha256Init(&sha);
+    for (off = 0; off < info.img_size; off += n)
+    {
+        n = (info.img_size - off < sizeof(sig_buf)) ? info.img_size - off : sizeof(sig_buf);
+        OTA_BdevRead(slot_addr + info.hdr_len + off, sig_buf, n);
+        OTA_Sha256Update(&sha, sig_buf, n);
+    }
+    OTA_Sha256Final(&sha, digest);
+
+    // 固件头读到 sig_buf 中，作为消息原地处理
+    OTA_BdevRead(slot_addr, sig_buf, info.hdr_len);
+    for (uint32_t i = 0; i < OTA_SHA256_DIGEST_SIZE; i++)
+    {
+        diff |= digest[i] ^ sig_buf[info.hash_off + i];
+    }
+    if (diff != 0)
+    {
+        return 1;
+    }
+    return OTA_SigVerifyHeader(sig_buf, &info);
+}
@@ -0,0 +1,41 @@
+/**
+ ******************************************************************************
+ * @file    OtaSig.h
+ * @author  MiniOTA Team
+ * @brief   固件签名验证头文件
+ *          签名覆盖整个固件头 (img_crc16 与签名值按 0 计算)，固件头中的 SHA-256 摘要再覆盖固件体;
+ *          接收时摘要已随数据流式算出，收到 EOT 只需验证一次签名，不再读取插槽
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 MiniOTA.
+ * All rights reserved.
+ *
+ ******************************************************************************
+ */
+
+#ifndef OTASIG_H
+#define OTASIG_H
+
+#include "OtaInterface.h"
+#include "OtaUtils.h"
+#include "OtaImage.h"
+
+/**
+ * @brief  用内置公钥 (OTA_SIG_PUBKEY) 验证固件头的签名
+ *         调用者须已确认固件体与固件头中的摘要一致
+ * @param  hdr: 完整的固件头 (hdr_len 字节)
+ * @param  pInfo: 固件头信息 (须带摘要与签名)
+ * @return 0: 签名有效, 1: 无效
+ */
+int OTA_SigVerifyHeader(const uint8_t *hdr, const OTA_IMG_INFO_E *pInfo);
+
+/**
+ * @brief  验证插槽中的固件: 从存储中读出固件体计算摘要，与固件头中的摘要比对后验证签名
+ *         用于启动时验证 Meta 中尚未记录为已验证的插槽
+ * @param  slot_addr: 插槽起始地址 (内部 Flash 或外部暂存分区)
+ * @return 0: 签名有效, 1: 缺少摘要或签名、摘要不符或签名无效
+ */
+int OTA_SigVerifySlot(uint32_t slot_addr);
+
+#endif
@@ -0,0 +1,153 @@
+/**
+ ******************************************************************************
+ * @file    OtaSpiNor.c
+ * @author  MiniOTA Team
+ * @brief   外部 SPI NOR Flash (25 系列) 驱动实现
+ *          只使用标准 JEDEC 指令 (WREN/RDSR/READ/PP/SE)，兼容 W25Qxx、GD25Qxx、MX25Lxx 等;
+ *          数据阶段通过 OTA_SpiTransferBlock 收发，端口层可用 DMA 实现
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 MiniOTA.
+ * All rights reserved.
+ *
+ ******************************************************************************
+ */
+
+#include "OtaInterface.h"
+#include "OtaPort.h"
+#include "OtaLog.h"
+#include "OtaSpiNor.h"
+
+/**
+ * @brief  发送指令及 24 位地址 (片选保持有效)
+ * @param  cmd: 指令
+ * @param  addr: 芯片内地址
+ */
+static void SpiNor_SendCmdAddr(uint8_t cmd, uint32_t addr)
+{
+    uint8_t hdr[4];
+
+    hdr[0] = cmd;
+    hdr[1] = (uint8_t)(addr >> 16);
+    hdr[2] = (uint8_t)(addr >> 8);
+    hdr[3] = (uint8_t)addr;
+    OTA_SpiTransferBlock(hdr, 0, sizeof(hdr));
+}
+
+/**
+ * @brief  写使能
+ */
+static void SpiNor_WriteEnable(void)
+{
+    OTA_SpiSelect(1);
+    OTA_SpiTransfer(SPI_NOR_CMD_WREN);
+    OTA_SpiSelect(0);
+}
+
+/**
+ * @brief  轮询状态寄存器直到芯片空闲
+ * @return 0: 空闲, 1: 超时
+ */
+static int SpiNor_WaitReady(void)
+{
+    uint32_t start = OTA_GetTickMs();
+    uint8_t sr;
+
+    OTA_SpiSelect(1);
+    OTA_SpiTransfer(SPI_NOR_CMD_RDSR);
+    do
+    {
+        sr = OTA_SpiTransfer(0xFF);
+        if ((OTA_GetTickMs() - start) > OTA_SPI_NOR_TIMEOUT_MS)
+        {
+            OTA_SpiSelect(0);
+            OTA_LOGE(SPI_NOR_TIMEOUT);
+            return 1;
+        }
+    } while (sr & SPI_NOR_SR_WIP);
+    OTA_SpiSelect(0);
+
+    return 0;
+}
+
+/**
+ * @brief  读取 JEDEC ID
+ * @return (厂商ID << 16) | (类型 << 8) | 容量
+ */
+uint32_t OTA_SpiNorReadId(void)
+{
+    uint8_t id[3];
+
+    OTA_SpiSelect(1);
+    OTA_SpiTransfer(SPI_NOR_CMD_JEDEC_ID);
+    OTA_SpiTransferBlock(0, id, sizeof(id));
+    OTA_SpiSelect(0);
+
+    return ((uint32_t)id[0] << 16) | ((uint32_t)id[1] << 8) | id[2];
+}
+
+/**
+ * @brief  读取数据
+ * @param  addr: 芯片内地址
+ * @param  buf: 目标缓冲区
+ * @param  len: 读取长度
+ */
+void OTA_SpiNorRead(uint32_t addr, uint8_t *buf, uint32_t len)
+{
+    OTA_SpiSelect(1);
+    SpiNor_SendCmdAddr(SPI_NOR_CMD_READ, addr);
+    OTA_SpiTransferBlock(0, buf, len);
+    OTA_SpiSelect(0);
+}
+
+/**
+ * @brief  写入数据 (按编程页拆分，目标区域须已擦除)
+ * @param  addr: 芯片内地址
+ * @param  buf: 源数据
+ * @param  len: 写入长度
+ * @return 0: 成功, 1: 超时
+ */
+int OTA_SpiNorWrite(uint32_t addr, const uint8_t *buf, uint32_t len)
+{
+    while (len > 0)
+    {
+        /* 单次页编程不能跨越 256 字节页边界 */
+        uint32_t chunk = OTA_SPI_NOR_PAGE_SIZE - (addr % OTA_SPI_NOR_PAGE_SIZE);
+        if (chunk > len)
+        {
+            chunk = len;
+        }
+
+        SpiNor_WriteEnable();
+        OTA_SpiSelect(1);
+        SpiNor_SendCmdAddr(SPI_NOR_CMD_PP, addr);
+        OTA_SpiTransferBlock(buf, 0, chunk);
+        OTA_SpiSelect(0);
+        if (SpiNor_WaitReady() != 0)
+        {
+            return 1;
+        }
+
+        addr += chunk;
+        buf  += chunk;
+        len  -= chunk;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief  擦除地址所在的 4KB 扇区
+ * @param  addr: 芯片内地址
+ * @return 0: 成功, 1: 超时
+ */
+int OTA_SpiNorEraseSector(uint32_t addr)
+{
+    SpiNor_WriteEnable();
+    OTA_SpiSelect(1);
+    SpiNor_SendCmdAddr(SPI_NOR_CMD_SE, addr & ~(OTA_SPI_NOR_SECTOR_SIZE - 1U));
+    OTA_SpiSelect(0);
+
+    return SpiNor_WaitReady();
+}
@@ -0,0 +1,79 @@
+/**
+ ******************************************************************************
+ * @file    OtaSpiNor.h
+ * @author  MiniOTA Team
+ * @brief   外部 SPI NOR Flash (25 系列) 驱动头文件
+ *          通过端口层的 SPI 收发接口访问，支持页编程、4KB 扇区擦除及状态轮询
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 MiniOTA.
+ * All rights reserved.
+ *
+ ******************************************************************************
+ */
+
+#ifndef OTASPINOR_H
+#define OTASPINOR_H
+
+#include "OtaInterface.h"
+
+/** @defgroup OTA_SpiNor_Commands
+ * @{
+ */
+#define SPI_NOR_CMD_WREN        0x06  /**< 写使能 */
+#define SPI_NOR_CMD_RDSR        0x05  /**< 读状态寄存器1 */
+#define SPI_NOR_CMD_READ        0x03  /**< 读数据 */
+#define SPI_NOR_CMD_PP          0x02  /**< 页编程 */
+#define SPI_NOR_CMD_SE          0x20  /**< 4KB 扇区擦除 */
+#define SPI_NOR_CMD_JEDEC_ID    0x9F  /**< 读 JEDEC ID */
+#define SPI_NOR_SR_WIP          0x01  /**< 状态寄存器: 忙 */
+/**
+ * @}
+ */
+
+/** 编程页大小 */
+#define OTA_SPI_NOR_PAGE_SIZE       256U
+
+/** 最小擦除单元 (扇区) 大小 */
+#define OTA_SPI_NOR_SECTOR_SIZE     4096U
+
+/** 可寻址的最大容量 (3 字节地址) */
+#define OTA_SPI_NOR_MAX_SIZE        0x1000000UL
+
+/** 忙等待超时(ms): 需大于芯片手册中的最大扇区擦除时间 */
+#ifndef OTA_SPI_NOR_TIMEOUT_MS
+#define OTA_SPI_NOR_TIMEOUT_MS      500U
+#endif
+
+/**
+ * @brief  读取 JEDEC ID
+ * @return (厂商ID << 16) | (类型 << 8) | 容量
+ */
+uint32_t OTA_SpiNorReadId(void);
+
+/**
+ * @brief  读取数据
+ * @param  addr: 芯片内地址
+ * @param  buf: 目标缓冲区
+ * @param  len: 读取长度
+ */
+void OTA_SpiNorRead(uint32_t addr, uint8_t *buf, uint32_t len);
+
+/**
+ * @brief  写入数据 (按编程页拆分，目标区域须已擦除)
+ * @param  addr: 芯片内地址
+ * @param  buf: 源数据
+ * @param  len: 写入长度
+ * @return 0: 成功, 1: 超时
+ */
+int OTA_SpiNorWrite(uint32_t addr, const uint8_t *buf, uint32_t len);
+
+/**
+ * @brief  擦除地址所在的 4KB 扇区
+ * @param  addr: 芯片内地址
+ * @return 0: 成功, 1: 超时
+ */
+int OTA_SpiNorEraseSector(uint32_t addr);
+
+#endif
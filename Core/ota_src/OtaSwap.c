@@ -0,0 +1,216 @@
+/**
+ ******************************************************************************
+ * @file    OtaSwap.c
+ * @author  MiniOTA Team
+ * @brief   交换安装实现
+ *          每页分三步: Slot A 的页复制到暂存页、Slot B 的页复制到 A、暂存页复制到 B，
+ *          每完成一步在进度页追加一个半字记录 (只编程不擦除)。
+ *          掉电后从第一条空记录处重做该步: 该步的源数据在重做前都未被改写，
+ *          因此交换可以从任意位置继续而不必重新开始
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 MiniOTA.
+ * All rights reserved.
+ *
+ ******************************************************************************
+ */
+
+#include "OtaInterface.h"
+#include "OtaPort.h"
+#include "OtaUtils.h"
+#include "OtaFlash.h"
+#include "OtaBdev.h"
+#include "OtaMeta.h"
+#include "OtaProf.h"
+#include "OtaImage.h"
+#include "OtaSwap.h"
+
+/**
+ * @brief  获取第 idx 条进度记录的地址
+ */
+static uint32_t Swap_RecAddr(uint32_t idx)
+{
+    return OTA_SWAP_STATUS_ADDR + sizeof(OTA_SWAP_HEADER_E) + idx * 2U;
+}
+
+/**
+ * @brief  追加第 idx 条进度记录
+ * @return 0: 成功, 1: 失败
+ */
+static int Swap_Record(uint32_t idx)
+{
+    static const uint8_t rec[2] = { 0x00, 0x00 };
+    return OTA_BdevProgram(Swap_RecAddr(idx), rec, sizeof(rec));
+}
+
+/**
+ * @brief  统计已完成的步数 (记录按顺序写入，遇到第一条空记录即停止)
+ * @param  limit: 最大记录数
+ */
+static uint32_t Swap_CountDone(uint32_t limit)
+{
+    uint32_t idx;
+    uint16_t rec;
+
+    for (idx = 0; idx < limit; idx++)
+    {
+        OTA_BdevRead(Swap_RecAddr(idx), (uint8_t *)&rec, sizeof(rec));
+        if (rec == 0xFFFFU)
+        {
+            break;
+        }
+    }
+    return idx;
+}
+
+/**
+ * @brief  将一页数据复制到目标页 (经 OtaFlash 页镜像写入，含擦除与回读校验)
+ * @return 0: 成功, 1: 失败
+ */
+static int Swap_CopyPage(uint32_t dst, uint32_t src)
+{
+    OTA_FlashHandleInit(dst);
+    OTA_BdevRead(src, OTA_FlashGetMirr(), OTA_FLASH_PAGE_SIZE);
+    return OTA_FlashWrite();
+}
+
+/**
+ * @brief  插槽中固件 (含固件头) 占用的页数
+ * @return 页数，固件头无效时为 0
+ */
+static uint32_t Swap_ImagePages(OTA_ACIVE_SLOT_E slot)
+{
+    OTA_IMG_INFO_E info;
+
+    if (OTA_ImageLoad(OTA_MetaSlotAddr(slot), &info) != OTA_TRUE)
+    {
+        return 0;
+    }
+    return (info.hdr_len + info.img_size + OTA_FLASH_PAGE_SIZE - 1U) / OTA_FLASH_PAGE_SIZE;
+}
+
+/**
+ * @brief  读取交换进度页
+ * @param  pHeader: 输出交换头
+ * @return OTA_TRUE: 存在已开始但尚未清除的交换
+ */
+OTA_BOOL OTA_SwapLoad(OTA_SWAP_HEADER_E *pHeader)
+{
+    OTA_BdevRead(OTA_SWAP_STATUS_ADDR, (uint8_t *)pHeader, sizeof(OTA_SWAP_HEADER_E));
+    return (pHeader->magic == OTA_SWAP_MAGIC && pHeader->pages <= OTA_SWAP_MAX_PAGES) ? OTA_TRUE : OTA_FALSE;
+}
+
+/**
+ * @brief  开始一次交换: 擦除进度页并写入交换头，随后执行交换
+ * @param  a_status: 交换完成后 Slot A 的状态
+ * @param  b_status: 交换完成后 Slot B 的状态
+ * @return 0: 交换完成, 1: 新固件超出可交换范围或写入失败
+ */
+int OTA_SwapBegin(uint8_t a_status, uint8_t b_status)
+{
+    OTA_SWAP_HEADER_E header;
+    uint32_t limit = OTA_MetaSlotSize(SLOT_A);
+    uint32_t pages_a = Swap_ImagePages(SLOT_A);
+    uint32_t pages_b = Swap_ImagePages(SLOT_B);
+
+    if (OTA_MetaSlotSize(SLOT_B) < limit)
+    {
+        limit = OTA_MetaSlotSize(SLOT_B);
+    }
+    limit /= OTA_FLASH_PAGE_SIZE;
+    if (limit > OTA_SWAP_MAX_PAGES)
+    {
+        limit = OTA_SWAP_MAX_PAGES;
+    }
+    if (pages_b > limit)
+    {
+        return 1;
+    }
+    if (pages_a > limit)
+    {
+        // 旧固件只能交换出一部分，B 中的内容不再可用
+        pages_a = limit;
+        b_status = SLOT_STATE_INVALID;
+    }
+
+    OTA_MemSet((uint8_t *)&header, 0xFF, sizeof(header));
+    header.magic    = OTA_SWAP_MAGIC;
+    header.pages    = (uint16_t)((pages_a > pages_b) ? pages_a : pages_b);
+    header.a_status = a_status;
+    header.b_status = b_status;
+    // 魔数最后写入: 写交换头途中掉电时进度页无效，下次启动按 Meta 重新开始交换，不会带着不完整的状态继续
+    if (OTA_BdevErase(OTA_SWAP_STATUS_ADDR) != 0 ||
+        OTA_BdevProgram(OTA_SWAP_STATUS_ADDR + sizeof(header.magic), (const uint8_t *)&header + sizeof(header.magic),
+                        sizeof(header) - sizeof(header.magic)) != 0 ||
+        OTA_BdevProgram(OTA_SWAP_STATUS_ADDR, (const uint8_t *)&header.magic, sizeof(header.magic)) != 0)
+    {
+        return 1;
+    }
+    return OTA_SwapRun();
+}
+
+/**
+ * @brief  从进度页最后一条记录之后继续交换，直到写入完成记录
+ * @return 0: 交换完成, 1: 进度页无效或写入失败
+ */
+int OTA_SwapRun(void)
+{
+    OTA_SWAP_HEADER_E header;
+    uint32_t a_addr = OTA_MetaSlotAddr(SLOT_A);
+    uint32_t b_addr = OTA_MetaSlotAddr(SLOT_B);
+    uint32_t total;
+    uint32_t done;
+    uint32_t page;
+    uint32_t step;
+    uint32_t off;
+    int ret;
+
+    if (OTA_SwapLoad(&header) != OTA_TRUE)
+    {
+        return 1;
+    }
+    total = header.pages * OTA_SWAP_STEPS;
+    done  = Swap_CountDone(total + 1U);
+    if (done > total)
+    {
+        // 已写入完成记录
+        return 0;
+    }
+
+    for (page = done / OTA_SWAP_STEPS; page < header.pages; page++)
+    {
+        OTA_PROF_BEGIN(OTA_PROF_SWAP_PAGE);
+        off = page * OTA_FLASH_PAGE_SIZE;
+        for (step = (page == done / OTA_SWAP_STEPS) ? done % OTA_SWAP_STEPS : 0; step < OTA_SWAP_STEPS; step++)
+        {
+            switch (step)
+            {
+            case 0:
+                ret = Swap_CopyPage(OTA_SWAP_SCRATCH_ADDR, a_addr + off);
+                break;
+            case 1:
+                ret = Swap_CopyPage(a_addr + off, b_addr + off);
+                break;
+            default:
+                ret = Swap_CopyPage(b_addr + off, OTA_SWAP_SCRATCH_ADDR);
+                break;
+            }
+            if (ret != 0 || Swap_Record(page * OTA_SWAP_STEPS + step) != 0)
+            {
+                return 1;
+            }
+        }
+        OTA_PROF_END(OTA_PROF_SWAP_PAGE);
+        OTA_WatchdogFeed();
+    }
+    return Swap_Record(total);
+}
+
+/**
+ * @brief  清除进度页 (交换结果已保存到 Meta 后调用)
+ */
+void OTA_SwapFinish(void)
+{
+    OTA_BdevErase(OTA_SWAP_STATUS_ADDR);
+}
@@ -0,0 +1,70 @@
+/**
+ ******************************************************************************
+ * @file    OtaSwap.h
+ * @author  MiniOTA Team
+ * @brief   交换安装头文件
+ *          经暂存页将 Slot B 与 Slot A 逐页交换，进度逐步记录在进度页中，掉电后从中断处继续
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 MiniOTA.
+ * All rights reserved.
+ *
+ ******************************************************************************
+ */
+
+#ifndef OTASWAP_H
+#define OTASWAP_H
+
+#include "OtaInterface.h"
+#include "OtaUtils.h"
+
+#define OTA_SWAP_MAGIC      0x50415753  /**< "SWAP" - 交换进度页魔数 */
+
+/**
+ * @brief 交换进度头部结构 (放在进度页开头，其后每完成一步追加一个半字记录)
+ */
+typedef struct __OTA_SWAP_HEADER
+{
+    uint32_t magic;         /**< OTA_SWAP_MAGIC */
+    uint16_t pages;         /**< 需要交换的页数 */
+    uint8_t  a_status;      /**< 交换完成后 Slot A 的状态 */
+    uint8_t  b_status;      /**< 交换完成后 Slot B 的状态 */
+    uint8_t  reserved[8];   /**< 保留字段，保证结构体16字节对齐 */
+} OTA_SWAP_HEADER_E;
+
+/** 每页交换分三步: A->暂存页、B->A、暂存页->B */
+#define OTA_SWAP_STEPS      3U
+
+/** 进度页可记录的最大交换页数 (每步一个半字记录，另有一个完成记录) */
+#define OTA_SWAP_MAX_PAGES  ((OTA_FLASH_PAGE_SIZE - sizeof(OTA_SWAP_HEADER_E)) / 2U / OTA_SWAP_STEPS - 1U)
+
+/**
+ * @brief  读取交换进度页
+ * @param  pHeader: 输出交换头
+ * @return OTA_TRUE: 存在已开始但尚未清除的交换
+ */
+OTA_BOOL OTA_SwapLoad(OTA_SWAP_HEADER_E *pHeader);
+
+/**
+ * @brief  开始一次交换: 擦除进度页并写入交换头，随后执行交换
+ *         交换页数取两个插槽中较大的固件，受较小插槽与 OTA_SWAP_MAX_PAGES 限制;
+ *         Slot A 的旧固件放不进 Slot B 时，交换后 B 的状态为无效
+ * @param  a_status: 交换完成后 Slot A 的状态
+ * @param  b_status: 交换完成后 Slot B 的状态
+ * @return 0: 交换完成, 1: 新固件超出可交换范围或写入失败
+ */
+int OTA_SwapBegin(uint8_t a_status, uint8_t b_status);
+
+/**
+ * @brief  从进度页最后一条记录之后继续交换，直到写入完成记录
+ * @return 0: 交换完成, 1: 进度页无效或写入失败
+ */
+int OTA_SwapRun(void);
+
+/**
+ * @brief  清除进度页 (交换结果已保存到 Meta 后调用)
+ */
+void OTA_SwapFinish(void);
+
+#endif
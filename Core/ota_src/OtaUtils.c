@@ -3,7 +3,7 @@
  * @file    OtaUtils.c
  * @author  MiniOTA Team
  * @brief   工具函数集
- *          提供内存操作、CRC计算、十六进制打印等基础功能
+ *          提供内存操作、CRC计算等基础功能
  ******************************************************************************
  * @attention
  * 
@@ -41,7 +41,18 @@ void OTA_U8ArryCopy(uint8_t *dst, const uint8_t *src, uint32_t len)
  */
 uint16_t OTA_GetCrc16(const uint8_t *buf, uint32_t len)
 {
-    uint16_t crc = 0;
+    return OTA_UpdateCrc16(0, buf, len);
+}
+
+/**
+ * @brief  XMODEM CRC16 分段计算 (数据无法一次性访问时使用，如外部 Flash)
+ * @param  crc: 上一段的计算结果，首段传 0
+ * @param  buf: 数据缓冲区
+ * @param  len: 数据长度
+ * @return 累计的 CRC16 校验值
+ */
+uint16_t OTA_UpdateCrc16(uint16_t crc, const uint8_t *buf, uint32_t len)
+{
     for (uint32_t i = 0; i < len; i++)
     {
         crc ^= (uint16_t)buf[i] << 8;
@@ -78,27 +89,3 @@ void OTA_MemCopy(uint8_t *dst, const uint8_t *src, uint32_t len)
         *dst++ = *src++;
     }
 }
-
-/**
- * @brief  打印32位十六进制数值到调试串口
- * @param  value: 待打印的32位数值
- */
-void OTA_PrintHex32(uint32_t value)
-{
-    char buf[11];          // "0x12345678\0"
-    buf[0] = '0';
-    buf[1] = 'x';
-
-    for (int i = 0; i < 8; i++)
-    {
-        uint8_t nibble = (value >> (28 - i * 4)) & 0xF;
-
-        if (nibble < 10)
-            buf[2 + i] = '0' + nibble;
-        else
-            buf[2 + i] = 'A' + (nibble - 10);
-    }
-
-    buf[10] = '\0';
-    OTA_DebugSend(buf);
-}
@@ -23,8 +23,12 @@
  */
 #define OTA_MAGIC_NUM       0x5A5A0001  /**< Meta 数据有效性识别魔数 */
 #define APP_MAGIC_NUM       0x424C4150  /**< "BLAP" - BootLoader APp 固件头魔数 */
+#define APP_MAGIC_NUM_V2    0x32414C42  /**< "BLA2" - v2 固件头魔数 (带 TLV 扩展区) */
 #define U32_INVALID         0UL         /**< 32位无效值 */
 #define OTA_1KB             1024U       /**< 1KB 大小定义 */
+#define OTA_PRE_ERASED_NONE 0xFFU       /**< Meta 中没有预擦除完毕的插槽 */
+#define OTA_SLOT_NONE       0xFFU       /**< 没有符合条件的插槽 */
+#define OTA_PART_MAGIC      0x54524150  /**< "PART" - Meta 页内分区表魔数 */
 
 /** @defgroup OTA_Internal_Memory_Map
  * @{
@@ -35,20 +39,76 @@
 /* 状态区(Meta)起始地址 */
 #define OTA_META_ADDR             OTA_TOTAL_START_ADDRESS
 
+/* 分区表在 Meta 页内的偏移: 位于 Meta 结构之后，为 Meta 结构扩展预留空间 */
+#define OTA_PART_TABLE_OFFSET     64
+
 /* APP 分区(A+B)的起始地址 */
 #define OTA_APP_REGION_ADDR       (OTA_META_ADDR + OTA_META_SIZE)
 
 /* APP 分区(A+B)的总可用空间 */
 #define OTA_APP_REGION_SIZE       (OTA_FLASH_SIZE - (OTA_APP_REGION_ADDR - OTA_FLASH_START_ADDRESS))
 
-/* 单个 APP 分区的大小 (对齐到页) */
-#define OTA_APP_SLOT_SIZE         ((OTA_APP_REGION_SIZE / 2) / OTA_FLASH_PAGE_SIZE * OTA_FLASH_PAGE_SIZE)
+#if OTA_EXT_STAGING
+/* 单个 APP 分区的大小: Meta 之后的全部内部空间 (对齐到页)，暂存分区大小与之相同 */
+#define OTA_APP_SLOT_SIZE         (OTA_APP_REGION_SIZE / OTA_FLASH_PAGE_SIZE * OTA_FLASH_PAGE_SIZE)
+
+/* APP_A 分区起始地址 (内部 Flash，唯一可执行的分区) */
+#define OTA_APP_A_ADDR            OTA_APP_REGION_ADDR
+
+/* APP_B 暂存分区起始地址 (外部 SPI NOR 虚拟地址) */
+#define OTA_APP_B_ADDR            (OTA_EXT_FLASH_BASE + OTA_EXT_STAGING_OFFSET)
+#elif OTA_BACKUP_COMPRESSED
+/* 压缩备份分区的大小 (按 OTA_BACKUP_SLOT_PERCENT 分配，对齐到页) */
+#define OTA_APP_B_SIZE            (OTA_APP_REGION_SIZE / 100 * OTA_BACKUP_SLOT_PERCENT / OTA_FLASH_PAGE_SIZE * OTA_FLASH_PAGE_SIZE)
+
+/* 可执行 APP 分区的大小: 除备份分区外的全部空间 (对齐到页) */
+#define OTA_APP_SLOT_SIZE         (OTA_APP_REGION_SIZE / OTA_FLASH_PAGE_SIZE * OTA_FLASH_PAGE_SIZE - OTA_APP_B_SIZE)
+
+/* APP_A 分区起始地址 */
+#define OTA_APP_A_ADDR            OTA_APP_REGION_ADDR
+
+/* APP_B 压缩备份分区起始地址 */
+#define OTA_APP_B_ADDR            (OTA_APP_A_ADDR + OTA_APP_SLOT_SIZE)
+#elif OTA_SWAP_INSTALL
+/* 单个 APP 分区的大小: 末尾两页留作交换暂存页与进度页，其余平分 (对齐到页) */
+#define OTA_APP_SLOT_SIZE         ((OTA_APP_REGION_SIZE / OTA_FLASH_PAGE_SIZE - 2U) / 2U * OTA_FLASH_PAGE_SIZE)
+
+/* APP_A 分区起始地址 (唯一的运行地址) */
+#define OTA_APP_A_ADDR            OTA_APP_REGION_ADDR
+
+/* APP_B 分区起始地址 (新固件下载位置，交换后保存旧固件) */
+#define OTA_APP_B_ADDR            (OTA_APP_A_ADDR + OTA_APP_SLOT_SIZE)
+#elif OTA_DUAL_BANK
+/* 单个 APP 分区的大小: Bank1 中 Meta 之后的剩余空间 (对齐到页) */
+#define OTA_APP_SLOT_SIZE         ((OTA_BANK2_START_ADDRESS - OTA_APP_REGION_ADDR) / OTA_FLASH_PAGE_SIZE * OTA_FLASH_PAGE_SIZE)
+
+/* APP_A 分区起始地址 (Bank1) */
+#define OTA_APP_A_ADDR            OTA_APP_REGION_ADDR
+
+/* APP_B 分区起始地址 (Bank2) */
+#define OTA_APP_B_ADDR            OTA_BANK2_START_ADDRESS
+#else
+/* 单个 APP 分区的大小: OTA_SLOT_NUM 个插槽平分 (对齐到页) */
+#define OTA_APP_SLOT_SIZE         ((OTA_APP_REGION_SIZE / OTA_SLOT_NUM) / OTA_FLASH_PAGE_SIZE * OTA_FLASH_PAGE_SIZE)
 
 /* APP_A 分区起始地址 */
 #define OTA_APP_A_ADDR            OTA_APP_REGION_ADDR
 
 /* APP_B 分区起始地址 */
 #define OTA_APP_B_ADDR            (OTA_APP_A_ADDR + OTA_APP_SLOT_SIZE)
+#endif
+
+#ifndef OTA_APP_B_SIZE
+/* APP_B 分区的大小: 除压缩备份外与 Slot A 相同 */
+#define OTA_APP_B_SIZE            OTA_APP_SLOT_SIZE
+#endif
+
+/* 交换暂存页与交换进度页: APP 区域末尾两页 (OTA_SWAP_INSTALL 时使用) */
+#define OTA_SWAP_SCRATCH_ADDR     (OTA_APP_REGION_ADDR + (OTA_APP_REGION_SIZE / OTA_FLASH_PAGE_SIZE - 2U) * OTA_FLASH_PAGE_SIZE)
+#define OTA_SWAP_STATUS_ADDR      (OTA_SWAP_SCRATCH_ADDR + OTA_FLASH_PAGE_SIZE)
+
+/* 地址所在的 Bank: 0-Bank1, 1-Bank2 (单 Bank 时恒为 0)，端口层据此选择 Flash 控制器 */
+#define OTA_FLASH_BANK_OF(addr)   ((OTA_DUAL_BANK && (uint32_t)(addr) >= OTA_BANK2_START_ADDRESS) ? 1U : 0U)
 
 /**
  * @brief 布尔类型枚举
@@ -90,10 +150,17 @@ typedef enum __OTA_USER_SETINGS_STATE
     OTA_ERR_FLASH_RANGE,      /**< App 区间超出 Flash 范围 */
     OTA_ERR_ALIGN,            /**< App 起始地址未对齐 Flash 页 */
     OTA_ERR_SIZE,             /**< App 区域大小不合法 */
+    OTA_ERR_BANK,             /**< 芯片不是双 Bank，或第二个 Bank 的位置或大小不合法 */
+    OTA_ERR_EXT,              /**< 外部暂存分区未按扇区对齐 */
+    OTA_ERR_BACKUP,           /**< 压缩备份模式下分区大小不合法 */
+    OTA_ERR_PART,             /**< 分区表无法放入 Meta 页 */
+    OTA_ERR_SLOT_NUM,         /**< 插槽数量不合法 */
+    OTA_ERR_SWAP,             /**< 交换安装模式下分区大小不合法或与其他模式同时使能 */
+    OTA_ERR_SIG,              /**< 签名验证未使能 SHA-256 或与重定位同时使能 */
 } OTA_USER_SETINGS_STATE_E;
 
 /**
- * @brief 目标插槽枚举
+ * @brief 目标插槽枚举 (插槽编号 0 ~ OTA_SLOT_NUM-1，SLOT_A/SLOT_B 为前两个插槽)
  */
 typedef enum __OTA_ACIVE_SLOT
 {
@@ -110,7 +177,7 @@ typedef struct __OTA_APP_IMG_HEADER
     uint32_t img_size;      /**< 固件实际大小 (不含头) */
     uint32_t version;       /**< 版本号 (用于比较新旧) */
     uint16_t img_crc16;     /**< 固件数据的 CRC16 校验值 */
-    uint8_t  reserved[2];   /**< 保留字段，保证结构体16字节对齐 */
+    uint16_t hdr_len;       /**< v2: 固件头总长度 (含 TLV 扩展区，4 字节对齐); v1 中为保留字段 */
 } OTA_APP_IMG_HEADER_E;
 
 /**
@@ -119,13 +186,76 @@ typedef struct __OTA_APP_IMG_HEADER
 typedef struct __OTA_META_DATA
 {
     uint32_t     magic;       /**< Meta 数据有效性魔数 */
-    uint32_t     seq_num;     /**< 序列号 (每次更新+1，用于简单的寿命均衡或版本追踪) */
-    OTA_ACIVE_SLOT_E active_slot; /**< 当前应启动的插槽 (A 或 B) */
-    OTA_SLOT_STATE_E  slotAStatus; /**< slotA 状态 */
-    OTA_SLOT_STATE_E  slotBStatus; /**< slotB 状态 */
-    uint8_t      reserved[5]; /**< 保留字段，保证结构体16字节对齐 */
+    uint32_t     seq_num;     /**< 序列号 (每写入一次新固件+1，用于 LRU 选择目标插槽) */
+    OTA_ACIVE_SLOT_E active_slot; /**< 当前应启动的插槽 */
+    uint8_t      slot_status[OTA_SLOT_NUM]; /**< 各插槽状态 (OTA_SLOT_STATE_E) */
+    uint8_t      pre_erased;  /**< 已由 App 预擦除完毕的插槽，OTA_PRE_ERASED_NONE 表示无 */
+    uint32_t     slot_seq[OTA_SLOT_NUM];    /**< 各插槽写入新固件时的 seq_num，LRU 选择目标插槽时使用 */
+    uint8_t      sig_unverified;            /**< 按位记录签名尚未验证的插槽 (擦除后的 0xFF 即全部未验证)，OTA_SIG_ENABLE 时使用 */
 } OTA_META_DATA_E;
 
+/** @defgroup OTA_Partition_Roles
+ * @{
+ */
+#define OTA_PART_ROLE_SLOT_A      0x00    /**< App 插槽 A (0x00 ~ OTA_SLOT_NUM-1 为插槽编号) */
+#define OTA_PART_ROLE_SLOT_B      0x01    /**< App 插槽 B */
+#define OTA_PART_ROLE_DATA        0x10    /**< App 数据分区，OTA 不读写 */
+#define OTA_PART_ROLE_GOLDEN      0x11    /**< 出厂固件，OTA 不写入，所有插槽均不可用时启动 */
+
+#define OTA_PART_FLAG_EXT         0x01    /**< 分区位于外部 SPI NOR (OTA_EXT_STAGING)，偏移相对 OTA_EXT_FLASH_BASE */
+/**
+ * @}
+ */
+
+/**
+ * @brief 分区表项 (offset 相对 OTA_FLASH_START_ADDRESS，起止地址须落在 Flash 扇区边界上)
+ */
+typedef struct __OTA_PART_ENTRY
+{
+    uint32_t offset;        /**< 分区起始偏移 */
+    uint32_t size;          /**< 分区大小 */
+    uint8_t  role;          /**< 分区用途 OTA_PART_ROLE_xxx */
+    uint8_t  flags;         /**< OTA_PART_FLAG_xxx 位组合 */
+    uint8_t  reserved[2];   /**< 保留字段，保证结构体4字节对齐 */
+} OTA_PART_ENTRY_E;
+
+/**
+ * @brief 分区表 (保存在 Meta 页 OTA_PART_TABLE_OFFSET 处)
+ */
+typedef struct __OTA_PART_TABLE
+{
+    uint32_t magic;         /**< OTA_PART_MAGIC */
+    uint16_t count;         /**< 有效表项数 */
+    uint16_t crc16;         /**< 前 count 个表项的 CRC16 */
+    OTA_PART_ENTRY_E entry[OTA_PART_MAX_NUM];
+} OTA_PART_TABLE_E;
+
+/**
+ * @brief 分区表读取结果枚举
+ */
+typedef enum __OTA_PART_STATE
+{
+    OTA_PART_DEFAULT = 0,    /**< 未写入分区表，使用默认布局 */
+    OTA_PART_LOADED,         /**< 分区表有效并已启用 */
+    OTA_PART_INVALID         /**< 分区表损坏或与 Flash 布局不符，使用默认布局 */
+} OTA_PART_STATE_E;
+
+/**
+ * @brief 临界区保护 (保存并恢复 PRIMASK，可嵌套，中断与主循环中均可使用)
+ */
+#define OTA_ENTER_CRITICAL(primask)   do { (primask) = __get_PRIMASK(); __disable_irq(); } while (0)
+#define OTA_EXIT_CRITICAL(primask)    __set_PRIMASK(primask)
+
+/**
+ * @brief 放入 SRAM 执行的函数 (Flash 擦写期间仍需运行的代码)
+ *        .RamFunc 段须由分散加载文件/链接脚本放入 RAM 执行区，由启动代码完成复制
+ */
+#if OTA_RAMFUNC_ENABLE
+#define OTA_RAMFUNC   __attribute__((section(".RamFunc"), noinline))
+#else
+#define OTA_RAMFUNC
+#endif
+
 /**
  * @brief 应用函数指针类型定义
  */
@@ -133,9 +263,9 @@ typedef void (*pFunction)(void);
 
 void OTA_U8ArryCopy(uint8_t *dst, const uint8_t *src, uint32_t len);
 uint16_t OTA_GetCrc16(const uint8_t *buf, uint32_t len);
+uint16_t OTA_UpdateCrc16(uint16_t crc, const uint8_t *buf, uint32_t len);
 void OTA_MemSet(uint8_t *dst, uint8_t val, uint32_t len);
 void OTA_MemCopy(uint8_t *dst, const uint8_t *src, uint32_t len);
-void OTA_PrintHex32(uint32_t value);
 
 
 #endif
@@ -17,7 +17,11 @@
 #include "OtaInterface.h"
 #include "OtaPort.h"
 #include "OtaUtils.h"
+#include "OtaLog.h"
+#include "OtaProf.h"
 #include "OtaFlash.h"
+#include "OtaSched.h"
+#include "OtaImage.h"
 
 
 /** Xmodem 协议句柄 */
@@ -26,6 +30,9 @@ static OTA_XMODEM_HANDLE xm;
 /** 接收完成标志 */
 static OTA_REC_FLAG_STATE_E RecComp_Flag;
 
+/** 链路健康统计 */
+static OTA_LINK_STATS link_stats;
+
 /* 状态处理函数声明 */
 static void Handle_WaitStart(uint8_t ch);
 static void Handle_WaitBlk(uint8_t ch);
@@ -33,6 +40,10 @@ static void Handle_WaitBlkInv(uint8_t ch);
 static void Handle_WaitData(uint8_t ch);
 static void Handle_WaitCrc1(uint8_t ch);
 static void Handle_WaitCrc2(uint8_t ch);
+static void Handle_Purge(uint8_t ch);
+static void Xm_SendNak(void);
+static void Xm_Cancel(void);
+static int Xm_StorePacket(void);
 
 /** 状态处理函数表（表驱动设计） */
 static const xm_state_fn_t xm_state_handlers[XM_STATE_MAX] = {
@@ -41,7 +52,8 @@ static const xm_state_fn_t xm_state_handlers[XM_STATE_MAX] = {
     [XM_WAIT_BLK_INV] = Handle_WaitBlkInv,
     [XM_WAIT_DATA]    = Handle_WaitData,
     [XM_WAIT_CRC1]    = Handle_WaitCrc1,
-    [XM_WAIT_CRC2]    = Handle_WaitCrc2
+    [XM_WAIT_CRC2]    = Handle_WaitCrc2,
+    [XM_PURGE]        = Handle_Purge
 };
 
 /* ---------------- API 实现 ---------------- */
@@ -56,6 +68,8 @@ void OTA_XmodemInit(uint32_t addr)
     xm.state = XM_WAIT_START;
     xm.expected_blk = 1; // Xmodem协议通常从包号1开始
     RecComp_Flag = REC_FLAG_IDLE;
+    OTA_MemSet((uint8_t *)&link_stats, 0, sizeof(OTA_LINK_STATS));
+    xm.start_tick = OTA_GetTickMs() - OTA_XM_START_INTERVAL_MS;
     
     OTA_FlashHandleInit(addr);
 }
@@ -78,12 +92,206 @@ uint8_t OTA_XmodemRevCompFlag(void)
     return RecComp_Flag;
 }
 
+/**
+ * @brief  接收任务: 从传输缓冲区取出字节并解析 (OTA_EVT_RX 触发)
+ *         有待提交的 Flash 操作时暂停解析，剩余字节留在缓冲区中
+ */
+void OTA_XmodemRxTask(void)
+{
+    while (xm.commit == XM_COMMIT_NONE && !OTA_IsTransEmpty())
+    {
+        OTA_XmodemRevByte(OTA_TransReadByte());
+    }
+}
+
+/**
+ * @brief  Flash 提交任务: 写入已满的页镜像并应答 (OTA_EVT_FLASH 触发)
+ */
+void OTA_XmodemCommitTask(void)
+{
+    if (xm.commit == XM_COMMIT_PAGE)
+    {
+        // 写入失败时不应答，发送端超时后会重发本包
+        if (OTA_FlashWrite() == 0 && Xm_StorePacket() == 0)
+        {
+            OTA_SendByte(XM_ACK);
+            OTA_PROF_END(OTA_PROF_ACK_TURNAROUND);
+        }
+    }
+    else if (xm.commit == XM_COMMIT_EOT)
+    {
+        // 最后一页写入成功后才应答 EOT，失败时以 CAN 代替，插槽不会被标记为待确认
+        if (OTA_FlashWrite() == 0)
+        {
+            OTA_SendByte(XM_ACK);
+            RecComp_Flag = REC_FLAG_FINISH;
+        }
+        else
+        {
+            Xm_Cancel();
+        }
+    }
+    else
+    {
+        return;
+    }
+
+    xm.commit = XM_COMMIT_NONE;
+    // 继续解析提交期间留在缓冲区中的字节
+    OTA_SchedSetEvent(OTA_EVT_RX);
+}
+
+/**
+ * @brief  记录端口层上报的串口接收错误
+ * @param  err: OTA_LINK_ERR_xxx 位组合
+ */
+OTA_RAMFUNC void OTA_XmodemLinkErr(uint8_t err)
+{
+    if (err & OTA_LINK_ERR_ORE) link_stats.overrun++;
+    if (err & OTA_LINK_ERR_FE)  link_stats.framing++;
+    if (err & OTA_LINK_ERR_NE)  link_stats.noise++;
+    if (err & OTA_LINK_ERR_RXBUF) link_stats.rx_overflow++;
+}
+
+/**
+ * @brief  获取本次传输的链路健康统计
+ * @return 统计数据指针
+ */
+const OTA_LINK_STATS *OTA_XmodemGetStats(void)
+{
+    return &link_stats;
+}
+
+/**
+ * @brief  通过调试日志输出本次传输的链路健康报告
+ */
+void OTA_XmodemReportStats(void)
+{
+    uint32_t args[OTA_LOG_MAX_ARGS];
+
+    args[0] = link_stats.packets;
+    args[1] = link_stats.nak;
+    args[2] = link_stats.duplicate;
+    args[3] = link_stats.seq_err;
+    args[4] = link_stats.blk_inv_err;
+    args[5] = link_stats.crc_err;
+    OTA_LOGI_ARGS(LINK_XM, 6, args);
+
+    args[0] = link_stats.overrun;
+    args[1] = link_stats.framing;
+    args[2] = link_stats.noise;
+    args[3] = link_stats.timeout;
+    args[4] = link_stats.rx_overflow;
+    OTA_LOGI_ARGS(LINK_UART, 5, args);
+}
+
+/**
+ * @brief  进入丢弃状态: 发送端可能仍在发送本包的剩余字节，全部丢弃，
+ *         线路静默 OTA_XM_BYTE_TIMEOUT_MS 后再发送 NAK，避免剩余字节被当作包头、EOT 或 CAN 解析
+ * @param  now: 当前时刻(ms)，作为静默计时的起点
+ */
+static void Xm_Purge(uint32_t now)
+{
+    xm.state = XM_PURGE;
+    xm.byte_tick = now;
+}
+
+/**
+ * @brief  Xmodem 超时检查，在主循环中周期调用
+ *         包内字节间或单包超时: 丢弃当前包并进入丢弃状态，线路静默后发送 NAK；
+ *         会话超时: 置传输中断标志
+ *         单包超时按包长计算: 1024 字节包为 OTA_XM_PACKET_TIMEOUT_MS 的 8 倍
+ */
+void OTA_XmodemPoll(void)
+{
+    uint32_t primask;
+    uint32_t now;
+    uint8_t  timeout = 0;   /* 1: 字节间超时，2: 单包超时 */
+    uint8_t  nak = 0;
+    uint8_t  session = 0;
+
+    /* 在临界区内取时刻，避免与接收中断更新的 byte_tick 比较时出现负差值; 日志与应答在临界区外发送 */
+    OTA_ENTER_CRITICAL(primask);
+    now = OTA_GetTickMs();
+    if (xm.state == XM_PURGE)
+    {
+        if ((now - xm.byte_tick) > OTA_XM_BYTE_TIMEOUT_MS)
+        {
+            xm.state = XM_WAIT_START;
+            nak = 1;
+        }
+    }
+    else if (xm.state != XM_WAIT_START)
+    {
+        if ((now - xm.byte_tick) > OTA_XM_BYTE_TIMEOUT_MS)
+        {
+            timeout = 1;
+        }
+        else if ((now - xm.pkt_tick) > OTA_XM_PACKET_TIMEOUT_MS * (uint32_t)(xm.data_len / 128U))
+        {
+            timeout = 2;
+        }
+        if (timeout != 0)
+        {
+            link_stats.timeout++;
+            Xm_Purge(now);
+        }
+    }
+
+    if (RecComp_Flag == REC_FLAG_WORKING &&
+        (now - xm.progress_tick) > OTA_XM_SESSION_TIMEOUT_MS)
+    {
+        xm.state = XM_WAIT_START;
+        RecComp_Flag = REC_FLAG_INT;
+        session = 1;
+        nak = 0;
+    }
+    OTA_EXIT_CRITICAL(primask);
+
+    if (timeout == 1)
+    {
+        OTA_LOGE(XM_BYTE_TIMEOUT);
+    }
+    else if (timeout == 2)
+    {
+        OTA_LOGE(XM_PKT_TIMEOUT);
+    }
+    if (nak != 0)
+    {
+        Xm_SendNak();
+    }
+    if (session != 0)
+    {
+        OTA_LOGE(XM_SESSION_TIMEOUT);
+    }
+}
+
+/**
+ * @brief  Xmodem 周期任务 (OTA_EVT_TICK 触发)
+ *         传输未开始时每 OTA_XM_START_INTERVAL_MS 发送 'C'，并执行超时检查
+ */
+void OTA_XmodemTickTask(void)
+{
+    uint32_t now = OTA_GetTickMs();
+
+    /* 传输未开始时，周期发送 'C' 请求发送端以 CRC 模式开始 */
+    if (xm.state == XM_WAIT_START && RecComp_Flag == REC_FLAG_IDLE &&
+        (now - xm.start_tick) >= OTA_XM_START_INTERVAL_MS)
+    {
+        OTA_SendByte(0x43);
+        xm.start_tick = now;
+    }
+
+    OTA_XmodemPoll();
+}
+
 /**
  * @brief  Xmodem 字节接收处理主函数
  * @param  ch: 接收到的字节
  */
 void OTA_XmodemRevByte(uint8_t ch)
 {
+    xm.byte_tick = OTA_GetTickMs();
     if (xm.state < XM_STATE_MAX && xm_state_handlers[xm.state] != NULL)
     {
 		xm_state_handlers[xm.state](ch);
@@ -97,6 +305,46 @@ void OTA_XmodemRevByte(uint8_t ch)
 
 /* ---------------- 状态处理函数实现 ---------------- */
 
+/**
+ * @brief  发送 NAK 并计数
+ */
+static void Xm_SendNak(void)
+{
+    link_stats.nak++;
+    OTA_SendByte(XM_NAK);
+}
+
+/**
+ * @brief  取消传输: 连续发送两个 CAN，发送端收到后停止发送
+ */
+static void Xm_Cancel(void)
+{
+    OTA_SendByte(XM_CAN);
+    OTA_SendByte(XM_CAN);
+    xm.state = XM_WAIT_START;
+    RecComp_Flag = REC_FLAG_INT;
+}
+
+/**
+ * @brief  把接收到的包交给固件流 (OtaImage) 存进Flash页的镜像中，等待写入Flash
+ *         固件头收齐后不适合目标插槽时立即取消传输
+ * @return 0: 已存入, 1: 固件被拒绝，传输已取消
+ */
+static int Xm_StorePacket(void)
+{
+    if (OTA_ImageStreamFeed(xm.data_buf, xm.data_len) != OTA_IMG_FEED_OK)
+    {
+        Xm_Cancel();
+        return 1;
+    }
+
+    // 更新状态
+    xm.expected_blk++;
+    link_stats.packets++;
+    xm.progress_tick = xm.byte_tick;
+    return 0;
+}
+
 /**
  * @brief  等待控制符阶段处理
  * @param  ch: 接收到的控制字符
@@ -105,39 +353,71 @@ static void Handle_WaitStart(uint8_t ch)
 {
     if (ch == XM_SOH) {            // SOH 128字节包
         xm.data_len = 128;
+        xm.pkt_tick = xm.byte_tick;
         xm.state = XM_WAIT_BLK;
+        if (RecComp_Flag != REC_FLAG_WORKING)
+        {
+            xm.progress_tick = xm.byte_tick;    // 会话开始
+        }
 		RecComp_Flag = REC_FLAG_WORKING;
-		OTA_DebugSend("[OTA]:SOH MODE\r\n");
+		OTA_LOGD(XM_SOH);
 		return;
     }
     else if (ch == XM_STX) {       // STX 1024字节包
         xm.data_len = 1024;
+        xm.pkt_tick = xm.byte_tick;
         xm.state = XM_WAIT_BLK;
+        if (RecComp_Flag != REC_FLAG_WORKING)
+        {
+            xm.progress_tick = xm.byte_tick;    // 会话开始
+        }
 		RecComp_Flag = REC_FLAG_WORKING;
-		OTA_DebugSend("[OTA]:STX MODE\r\n");
+		OTA_LOGD(XM_STX);
 		return;
     }
     else if (ch == XM_EOT) {       // EOT 传输结束
-        OTA_SendByte(XM_ACK);      // ACK
-        
-        // 若镜像区还有写回的数据
+        // 流式摘要不符时以 CAN 代替 ACK，插槽不会被标记为待确认
+        if (OTA_ImageStreamEnd() != OTA_IMG_FEED_OK)
+        {
+            Xm_Cancel();
+            return;
+        }
+        // 若镜像区还有写回的数据，交由 Flash 提交任务写入后再应答
         if(OTA_FlashGetPageOffset() > 0)
         {
-            OTA_FlashWrite();
+            xm.commit = XM_COMMIT_EOT;
+            OTA_SchedSetEvent(OTA_EVT_FLASH);
+            return;
         }
+        OTA_SendByte(XM_ACK);      // ACK
         RecComp_Flag = REC_FLAG_FINISH;
 		return;
     }else if (ch == XM_CAN)
 	{
 		RecComp_Flag = REC_FLAG_INT;
 		xm.state = XM_WAIT_START;
-		OTA_DebugSend("[OTA][Error]:Transmission interrupted.\r\n");
+		OTA_LOGE(XM_INTERRUPTED);
+		return;
+	}
+	OTA_LOGE(XM_UNKNOWN_CHAR);
+	// 传输中出现的意外字节多为上一包的残余: 丢弃到线路静默后再请求重发，会话保持进行中
+	if (RecComp_Flag == REC_FLAG_WORKING)
+	{
+		Xm_Purge(xm.byte_tick);
 		return;
 	}
-	OTA_DebugSend("[OTA][Error]:An Vnknown Character Was Read.\r\n");
 	RecComp_Flag = REC_FLAG_IDLE;
 }
 
+/**
+ * @brief  丢弃状态处理: 字节只更新静默计时 (在 OTA_XmodemRevByte 中)，由 OTA_XmodemPoll 结束
+ * @param  ch: 接收到的字节 (丢弃)
+ */
+static void Handle_Purge(uint8_t ch)
+{
+    (void)ch;
+}
+
 /**
  * @brief  等待包序号阶段处理
  * @param  ch: 接收到的包序号
@@ -146,7 +426,7 @@ static void Handle_WaitBlk(uint8_t ch)
 {
     xm.blk = ch;
     xm.state = XM_WAIT_BLK_INV;
-	OTA_DebugSend("[OTA]:GET PACK NUM\r\n");
+	OTA_LOGD(XM_BLK);
 }
 
 /**
@@ -158,8 +438,9 @@ static void Handle_WaitBlkInv(uint8_t ch)
     xm.blk_inv = ch;
     // 校验：包号 + 包号反码 必须等于 0xFF
     if ((uint8_t)(xm.blk + xm.blk_inv) != (uint8_t)0xFF) {
-		OTA_DebugSend("[OTA][Error]:Mismatched Package Serial Numbers And Inverse Codes\r\n");
-        OTA_SendByte(XM_NAK);        // NAK
+		OTA_LOGE(XM_BLK_INV);
+        link_stats.blk_inv_err++;
+        Xm_SendNak();
         xm.state = XM_WAIT_START;
     } else {
         xm.data_cnt = 0;
@@ -186,7 +467,7 @@ static void Handle_WaitData(uint8_t ch)
  */
 static void Handle_WaitCrc1(uint8_t ch)
 {
-	OTA_DebugSend("[OTA]:Get Crc1\r\n");
+	OTA_LOGD(XM_CRC1);
     xm.crc_recv = ((uint16_t)ch) << 8;
     xm.state = XM_WAIT_CRC2;
 }
@@ -197,10 +478,13 @@ static void Handle_WaitCrc1(uint8_t ch)
  */
 static void Handle_WaitCrc2(uint8_t ch)
 {
-	OTA_DebugSend("[OTA]:Get Crc2\r\n");
+    OTA_PROF_BEGIN(OTA_PROF_ACK_TURNAROUND);
+	OTA_LOGD(XM_CRC2);
     xm.crc_recv |= ch;
 
+    OTA_PROF_BEGIN(OTA_PROF_PKT_CRC);
     xm.crc_calc = OTA_GetCrc16(xm.data_buf, xm.data_len);
+    OTA_PROF_END(OTA_PROF_PKT_CRC);
 
     // 1. CRC校验通过
     if (xm.crc_calc == xm.crc_recv)
@@ -208,42 +492,44 @@ static void Handle_WaitCrc2(uint8_t ch)
         // 情况A: 正常的顺序包
         if (xm.blk == xm.expected_blk)
         {
-            // 检查flash镜像是否还能容纳本小包数据
-            if(OTA_FLASH_PAGE_SIZE - OTA_FlashGetPageOffset() < xm.data_len)
+            // 检查flash镜像是否还能容纳本小包数据 (按映射写入时由固件流自行写回)
+            if(OTA_ImageStreamMapped() != OTA_TRUE &&
+               OTA_FLASH_PAGE_SIZE - OTA_FlashGetPageOffset() < xm.data_len)
             {
-                // 先进行一次flash写入，更新镜像
-                if (OTA_FlashWrite() != 0) {
-                    xm.state = XM_WAIT_START;
-                    return; 
-                }
+                // 先由 Flash 提交任务写入镜像，再存包并应答
+                xm.commit = XM_COMMIT_PAGE;
+                xm.state = XM_WAIT_START;
+                OTA_SchedSetEvent(OTA_EVT_FLASH);
+                return;
             }
 
-			// 把接收到的包存进当前Flash页的镜像中，等待写入Flash
-            OTA_U8ArryCopy(&(OTA_FlashGetMirr()[OTA_FlashGetPageOffset()]), xm.data_buf, xm.data_len);
-            
-            // 更新状态
-            xm.expected_blk++;
-			OTA_FlashSetPageOffset(OTA_FlashGetPageOffset() + xm.data_len);
-            
-            OTA_SendByte(XM_ACK);     // ACK
+            if (Xm_StorePacket() == 0)
+            {
+                OTA_SendByte(XM_ACK);     // ACK
+                OTA_PROF_END(OTA_PROF_ACK_TURNAROUND);
+            }
         }
         // 情况B: 发送端重发了上一个已写入的包
         else if (xm.blk == (uint8_t)(xm.expected_blk - 1))
         {
+            link_stats.duplicate++;
             OTA_SendByte(XM_ACK);
+            OTA_PROF_END(OTA_PROF_ACK_TURNAROUND);
         }
         // 情况C: 包号完全对不上
         else
         {
-			OTA_DebugSend("[OTA][Error]:Packet Order Confusion\r\n");
-            OTA_SendByte(XM_NAK);     // 取消传输或请求重发
+			OTA_LOGE(XM_BLK_ORDER);
+            link_stats.seq_err++;
+            Xm_SendNak();             // 取消传输或请求重发
 			return;
         }
     }
     // 2. CRC校验失败
     else {
-		OTA_DebugSend("[OTA][Error]:Crc16 Is Inconsistent\r\n");
-        OTA_SendByte(XM_NAK);     // NAK
+		OTA_LOGE(XM_CRC);
+        link_stats.crc_err++;
+        Xm_SendNak();
     }
 
     xm.state = XM_WAIT_START; // 回到开始等待下一个包头
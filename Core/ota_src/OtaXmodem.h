@@ -46,9 +46,20 @@ typedef enum __OTA_XM_STATE
     XM_WAIT_DATA,       /**< 等待数据 */
     XM_WAIT_CRC1,       /**< 等待CRC高字节 */
     XM_WAIT_CRC2,       /**< 等待CRC低字节 */
+    XM_PURGE,           /**< 丢弃线路上的剩余字节，静默 OTA_XM_BYTE_TIMEOUT_MS 后发送 NAK */
     XM_STATE_MAX        /**< 状态总数 */
 } OTA_XM_STATE_E;
 
+/**
+ * @brief 待提交的 Flash 操作枚举
+ */
+typedef enum __OTA_XM_COMMIT
+{
+    XM_COMMIT_NONE = 0, /**< 无 */
+    XM_COMMIT_PAGE,     /**< 页镜像已满: 写入后存入当前包并应答 */
+    XM_COMMIT_EOT       /**< 传输结束: 写回镜像中剩余数据，成功后应答 EOT */
+} OTA_XM_COMMIT_E;
+
 /**
  * @brief 接收完成标志枚举
  */
@@ -73,9 +84,32 @@ typedef struct __OTA_XMODEM_HANDLE
     uint16_t   data_cnt;     /**< 已接收数据计数 */
     uint16_t   crc_recv;     /**< 接收到的CRC值 */
     uint16_t   crc_calc;     /**< 计算得到的CRC值 */
+    uint32_t   byte_tick;    /**< 最近一次收到字节的时刻(ms) */
+    uint32_t   pkt_tick;     /**< 当前包包头到达的时刻(ms) */
+    uint32_t   progress_tick;/**< 最近一次成功写入数据包的时刻(ms) */
+    uint32_t   start_tick;   /**< 上一次发送 'C' 的时刻(ms) */
+    OTA_XM_COMMIT_E commit;  /**< 待 Flash 提交任务处理的操作 */
     uint8_t    data_buf[1024]; /**< 数据缓冲区 */
 } OTA_XMODEM_HANDLE;
 
+/**
+ * @brief 链路健康统计 (每次 OTA_XmodemInit 清零，传输结束时输出)
+ */
+typedef struct __OTA_LINK_STATS
+{
+    uint32_t packets;       /**< 成功写入的数据包数 */
+    uint32_t nak;           /**< 发出的 NAK 次数 */
+    uint32_t duplicate;     /**< 发送端重发的已写入包 (重复包) */
+    uint32_t seq_err;       /**< 包序号错乱 */
+    uint32_t blk_inv_err;   /**< 包序号与反码不匹配 */
+    uint32_t crc_err;       /**< CRC 校验失败 */
+    uint32_t overrun;       /**< 串口溢出 (ORE)，由端口层上报 */
+    uint32_t framing;       /**< 串口帧错误 (FE)，由端口层上报 */
+    uint32_t noise;         /**< 串口噪声错误 (NE)，由端口层上报 */
+    uint32_t timeout;       /**< 字节间/单包超时后重新同步的次数 */
+    uint32_t rx_overflow;   /**< 接收缓冲区满而丢弃的字节数 */
+} OTA_LINK_STATS;
+
 /**
  * @brief 状态处理函数指针类型
  */
@@ -100,6 +134,17 @@ void OTA_XmodemInit(uint32_t addr);
  */
 void OTA_XmodemRevByte(uint8_t ch);
 
+/**
+ * @brief  接收任务: 从传输缓冲区取出字节并解析 (OTA_EVT_RX 触发)
+ *         有待提交的 Flash 操作时暂停解析，剩余字节留在缓冲区中
+ */
+void OTA_XmodemRxTask(void);
+
+/**
+ * @brief  Flash 提交任务: 写入已满的页镜像并应答 (OTA_EVT_FLASH 触发)
+ */
+void OTA_XmodemCommitTask(void);
+
 /**
  * @brief  获取接收完成标志
  * @return 接收标志状态
@@ -111,6 +156,36 @@ uint8_t OTA_XmodemRevCompFlag(void);
  * @return Xmodem 状态
  */
 OTA_XM_STATE_E OTA_GetXmodemState(void);
+
+/**
+ * @brief  Xmodem 超时检查，在主循环中周期调用
+ *         包内字节间或单包超时: 丢弃当前包，回到等待包头并发送 NAK；
+ *         会话超时: 置传输中断标志
+ */
+void OTA_XmodemPoll(void);
+
+/**
+ * @brief  Xmodem 周期任务 (OTA_EVT_TICK 触发)
+ *         传输未开始时每 OTA_XM_START_INTERVAL_MS 发送 'C'，并执行超时检查
+ */
+void OTA_XmodemTickTask(void);
+
+/**
+ * @brief  记录端口层上报的串口接收错误
+ * @param  err: OTA_LINK_ERR_xxx 位组合
+ */
+void OTA_XmodemLinkErr(uint8_t err);
+
+/**
+ * @brief  获取本次传输的链路健康统计
+ * @return 统计数据指针
+ */
+const OTA_LINK_STATS *OTA_XmodemGetStats(void);
+
+/**
+ * @brief  通过调试日志输出本次传输的链路健康报告
+ */
+void OTA_XmodemReportStats(void);
 /**
  * @}
  */
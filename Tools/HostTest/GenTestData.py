@@ -0,0 +1,132 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+MiniOTA 主机测试数据生成
+
+在输出目录中生成:
+    app.bin       连续的测试固件体 (向量表 + 伪随机内容)
+    app.hex       三段的 Intel HEX，段间空隙大于 OtaImageGen.py 的 --min-gap 默认值
+    app_flat.bin  app.hex 还原为连续固件体后的内容 (空隙为 0xFF)，用于比对插槽
+    aes.key       与 OtaInterface.h 默认的 OTA_AES_KEY 相同 (FIPS 197 附录 A.1 的密钥)
+    wrong.aes     另一把 AES 密钥
+    sig.key       与默认的 OTA_SIG_PUBKEY 对应的私钥种子 (RFC 8032 TEST 1)
+    aes_ctr.bin   由 OtaImageGen.aes_ctr 计算的 AES-128-CTR 用例，供 TestAes 与 C 实现比对
+    reloc_0.bin / reloc_100000.bin
+                  模拟以 0 与 0x100000 为基址链接的同一固件，供 OtaRelocGen.py 生成重定位表
+
+固件再由 Makefile 调用 OtaImageGen.py 生成。内容由固定的种子决定，每次生成相同。
+
+用法:
+    python GenTestData.py build/data
+"""
+
+import os
+import random
+import struct
+import sys
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), ".."))
+import OtaImageGen  # noqa: E402
+
+SLOT_A = 0x08003400     # 默认布局下的 Slot A (Meta 页之后)
+HDR_LEN = 0x100         # 测试固件的固件头长度 (--hdr-len)
+APP_SP = 0x20005000
+AES_KEY = bytes.fromhex("2b7e151628aed2a6abf7158809cf4f3c")
+SIG_SEED = bytes.fromhex("9d61b19deffd5a60ba844af492ec2cc44449c5697b326919703bac031cae7f60")
+# (在固件体中的偏移, 长度): 长度不是 16 的倍数，各段的密钥流从分组中间开始
+SEGMENTS = [(0x0000, 1203), (0x0800, 500), (0x1800, 237)]
+AES_CASES = 60
+RELOC_SIZE = 3000       # 重定位测试固件体的大小
+RELOC_BASE = 0x100000   # 第二次链接的基址
+RELOC_WORDS = 40        # 除复位向量外的绝对地址个数
+
+
+def app_body(rng, size):
+    """向量表 (SP、复位向量) 后接伪随机内容"""
+    body = bytearray(rng.getrandbits(8) for _ in range(size))
+    body[0:8] = struct.pack("<II", APP_SP, SLOT_A + HDR_LEN + 0x101)
+    return bytes(body)
+
+
+def hex_records(addr, data):
+    """Intel HEX 数据记录，必要时插入扩展线性地址记录"""
+    lines = []
+    upper = None
+    for i in range(0, len(data), 16):
+        a = addr + i
+        if a >> 16 != upper:
+            upper = a >> 16
+            lines.append(hex_line(0, 0x04, struct.pack(">H", upper)))
+        lines.append(hex_line(a & 0xFFFF, 0x00, data[i:i + 16]))
+    return lines
+
+
+def hex_line(addr, rtype, value):
+    rec = bytes([len(value), addr >> 8, addr & 0xFF, rtype]) + value
+    return ":" + (rec + bytes([-sum(rec) & 0xFF])).hex().upper()
+
+
+def aes_cases(rng):
+    """随机密钥、初始计数块、偏移与长度; 部分用例的计数块低 32 位接近回绕"""
+    out = bytearray()
+    for i in range(AES_CASES):
+        key = bytes(rng.getrandbits(8) for _ in range(16))
+        iv = bytearray(rng.getrandbits(8) for _ in range(16))
+        if i % 3 == 0:
+            iv[12:16] = struct.pack(">I", 0xFFFFFFFF - rng.randrange(4))
+        off = rng.choice([0, rng.randrange(16), rng.randrange(0x2000)])
+        data = bytes(rng.getrandbits(8) for _ in range(rng.randrange(1, 800)))
+        out += key + bytes(iv) + struct.pack("<II", off, len(data)) + data + \
+            OtaImageGen.aes_ctr(key, bytes(iv), off, data)
+    return bytes(out)
+
+
+def reloc_bins(rng):
+    """复位向量与随机位置的绝对地址 (指向固件内部) 在两个 bin 中相差 RELOC_BASE，其余内容相同"""
+    body = bytearray(rng.getrandbits(8) for _ in range(RELOC_SIZE))
+    body[0:8] = struct.pack("<II", APP_SP, 0x101)
+    offs = [4] + sorted(rng.sample(range(8, RELOC_SIZE - 3, 4), RELOC_WORDS))
+    for off in offs[1:]:
+        struct.pack_into("<I", body, off, rng.randrange(RELOC_SIZE))
+    moved = bytearray(body)
+    for off in offs:
+        struct.pack_into("<I", moved, off, struct.unpack_from("<I", body, off)[0] + RELOC_BASE)
+    return bytes(body), bytes(moved)
+
+
+def main():
+    if len(sys.argv) != 2:
+        sys.exit("usage: GenTestData.py <output dir>")
+    out = sys.argv[1]
+    os.makedirs(out, exist_ok=True)
+    rng = random.Random(20260501)
+
+    files = {
+        "app.bin": app_body(rng, 5000),
+        "aes.key": AES_KEY,
+        "wrong.aes": bytes(rng.getrandbits(8) for _ in range(16)),
+        "sig.key": SIG_SEED,
+    }
+
+    flat = bytearray(b"\xFF" * (SEGMENTS[-1][0] + SEGMENTS[-1][1]))
+    flat[0:SEGMENTS[0][1]] = app_body(rng, SEGMENTS[0][1])
+    lines = []
+    for off, size in SEGMENTS:
+        if off != 0:
+            flat[off:off + size] = bytes(rng.getrandbits(8) for _ in range(size))
+        lines += hex_records(SLOT_A + HDR_LEN + off, bytes(flat[off:off + size]))
+    lines.append(":00000001FF")
+    files["app.hex"] = ("\n".join(lines) + "\n").encode()
+    files["app_flat.bin"] = bytes(flat) + b"\xFF" * (-len(flat) % 4)
+
+    files["aes_ctr.bin"] = aes_cases(rng)
+    files["reloc_0.bin"], files["reloc_100000.bin"] = reloc_bins(rng)
+
+    for name, data in files.items():
+        with open(os.path.join(out, name), "wb") as f:
+            f.write(data)
+    print("%d files -> %s" % (len(files), out))
+
+
+if __name__ == "__main__":
+    main()
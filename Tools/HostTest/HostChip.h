@@ -0,0 +1,79 @@
+/**
+ ******************************************************************************
+ * @file    HostChip.h
+ * @author  MiniOTA Team
+ * @brief   主机测试用的 CMSIS 替身
+ *          生成的 OtaInterface.h 以本文件代替 CMSIS 设备头文件与 Flash 布局文件，
+ *          只提供 MiniOTA 用到的内核寄存器与内联函数; 中断开关为空操作
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 MiniOTA.
+ * All rights reserved.
+ *
+ ******************************************************************************
+ */
+
+#ifndef HOSTCHIP_H
+#define HOSTCHIP_H
+
+#include <stdint.h>
+
+typedef struct
+{
+    volatile uint32_t CTRL;
+    volatile uint32_t LOAD;
+    volatile uint32_t VAL;
+    volatile uint32_t CALIB;
+} SysTick_Type;
+
+typedef struct
+{
+    volatile uint32_t CPUID;
+    volatile uint32_t ICSR;
+    volatile uint32_t VTOR;
+    volatile uint32_t AIRCR;
+    volatile uint32_t SCR;
+    volatile uint32_t CCR;
+    volatile uint8_t  SHP[12];
+    volatile uint32_t SHCSR;
+} SCB_Type;
+
+typedef struct
+{
+    volatile uint32_t CTRL;
+    volatile uint32_t CYCCNT;
+} DWT_Type;
+
+typedef struct
+{
+    volatile uint32_t DHCSR;
+    volatile uint32_t DCRSR;
+    volatile uint32_t DCRDR;
+    volatile uint32_t DEMCR;
+} CoreDebug_Type;
+
+/* 寄存器实例定义在 HostPort.c */
+extern SysTick_Type   *SysTick;
+extern SCB_Type       *SCB;
+extern DWT_Type       *DWT;
+extern CoreDebug_Type *CoreDebug;
+extern uint32_t        SystemCoreClock;
+
+#define CoreDebug_DEMCR_TRCENA_Msk  (1UL << 24)
+#define DWT_CTRL_CYCCNTENA_Msk      (1UL << 0)
+#define SysTick_CTRL_CLKSOURCE_Msk  (1UL << 2)
+#define SysTick_CTRL_TICKINT_Msk    (1UL << 1)
+#define SysTick_CTRL_ENABLE_Msk     (1UL << 0)
+
+static inline void     __disable_irq(void)          { }
+static inline void     __enable_irq(void)           { }
+static inline uint32_t __get_PRIMASK(void)          { return 0; }
+static inline void     __set_PRIMASK(uint32_t mask) { (void)mask; }
+static inline void     __set_MSP(uint32_t sp)       { (void)sp; }
+static inline void     __NOP(void)                  { }
+static inline void     __WFI(void)                  { }
+static inline void     __DSB(void)                  { }
+static inline void     __ISB(void)                  { }
+
+#endif
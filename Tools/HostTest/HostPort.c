@@ -0,0 +1,639 @@
+/**
+ ******************************************************************************
+ * @file    HostPort.c
+ * @author  MiniOTA Team
+ * @brief   主机测试移植层实现
+ *          Core/ota_src/OtaPort.c 中的移植函数在链接前被弱化，由本文件中的模型覆盖:
+ *          - 内部 Flash: 页擦除置 0xFF，半字编程要求目标为 0xFFFF (STM32F1 PGERR)，上锁时拒绝擦写
+ *          - SPI NOR: 25 系列命令 (WREN/RDSR/READ/PP/SE/JEDEC ID)，擦除置 0xFF，编程只能清零位，
+ *            页编程在 256 字节页内回绕，忙期间除 RDSR 外的命令被忽略并记为违例
+ *          - 串口: Xmodem-CRC 发送端，应答触发下一包，整包在下一次读取时钟时送入 OTA_ReceiveTask
+ *          - 时钟: 每次读取前进 100us，Flash 与 SPI 操作按模拟时序前进
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 MiniOTA.
+ * All rights reserved.
+ *
+ ******************************************************************************
+ */
+
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#include "HostPort.h"
+#include "OtaPort.h"
+#include "OtaFlashIfoDef.h"
+#include "OtaJump.h"
+#include "OtaLog.h"
+
+#define XM_SOH      0x01
+#define XM_STX      0x02
+#define XM_EOT      0x04
+#define XM_ACK      0x06
+#define XM_NAK      0x15
+#define XM_CAN      0x18
+
+/* 模拟时间超过该值仍未跳转或返回时结束本次启动 (us) */
+#define HOST_TIME_LIMIT_US      (120ULL * 1000000ULL)
+
+SysTick_Type   host_systick;
+SCB_Type       host_scb;
+DWT_Type       host_dwt;
+CoreDebug_Type host_coredebug;
+SysTick_Type   *SysTick   = &host_systick;
+SCB_Type       *SCB       = &host_scb;
+DWT_Type       *DWT       = &host_dwt;
+CoreDebug_Type *CoreDebug = &host_coredebug;
+uint32_t SystemCoreClock  = 72000000UL;
+
+HOST_STATS *host_stats;
+
+static uint8_t  *nor;
+static char     *host_log;
+static uint32_t  flash_map_size;
+static uint64_t  host_us;
+static uint8_t   host_enter_iap;
+static uint8_t   host_verbose;
+static uint32_t  host_cut_at;
+static uint32_t  host_ops;
+static uint32_t  host_fail_addr;
+static uint8_t   flash_locked = 1;
+static uint32_t  flash_busy_polls;
+static int       checks, failures;
+
+/* SPI NOR 命令状态 */
+static uint8_t   nor_cs, nor_cmd, nor_wel;
+static uint32_t  nor_n, nor_addr;
+static uint64_t  nor_busy_until;
+
+/* Xmodem 发送端 */
+enum { TX_IDLE, TX_DATA, TX_EOT, TX_DONE };
+static const uint8_t *tx_img;
+static uint32_t  tx_len, tx_sent;
+static uint16_t  tx_pkt;
+static uint8_t   tx_blk, tx_state;
+static uint8_t   tx_buf[1029];
+static uint32_t  tx_n;
+
+static const MiniOTA_SectorGroup host_groups[1] = { { OTA_FLASH_SIZE / OTA_1KB, OTA_1KB } };
+static const MiniOTA_FlashLayout host_layout = {
+    .start_addr  = OTA_FLASH_START_ADDRESS,
+    .total_size  = OTA_FLASH_SIZE,
+    .is_uniform  = OTA_TRUE,
+    .group_count = 1,
+    .groups      = host_groups,
+    .bank2_addr  = OTA_DUAL_BANK ? OTA_BANK2_START_ADDRESS : 0
+};
+
+const MiniOTA_FlashLayout* MiniOTA_GetLayout(void)
+{
+    return &host_layout;
+}
+
+/**
+ * @brief  结束子进程
+ * @param  code: HOST_BOOT_RESULT_E
+ */
+static void Host_Exit(int code)
+{
+    fflush(stdout);
+    _exit(code);
+}
+
+/**
+ * @brief  映射一段父子进程共享的内存
+ * @param  addr: 固定地址，NULL 表示任意
+ * @param  size: 大小
+ * @return 映射地址
+ */
+static void *Host_Map(void *addr, size_t size)
+{
+    int flags = MAP_SHARED | MAP_ANONYMOUS | (addr != NULL ? MAP_FIXED : 0);
+    void *p = mmap(addr, size, PROT_READ | PROT_WRITE, flags, -1, 0);
+
+    if (p == MAP_FAILED)
+    {
+        perror("mmap");
+        exit(2);
+    }
+    return p;
+}
+
+void Host_Init(void)
+{
+    /* 覆盖 Bank2 所在范围 */
+    flash_map_size = 0x100000U;
+    if (OTA_FLASH_SIZE > flash_map_size)
+    {
+        flash_map_size = OTA_FLASH_SIZE;
+    }
+    memset(Host_Map((void *)(uintptr_t)OTA_FLASH_START_ADDRESS, flash_map_size), 0xFF, flash_map_size);
+    nor = Host_Map(NULL, HOST_NOR_SIZE);
+    memset(nor, 0xFF, HOST_NOR_SIZE);
+    host_stats = Host_Map(NULL, sizeof(HOST_STATS));
+    host_log = Host_Map(NULL, HOST_LOG_SIZE + 1U);
+    host_verbose = (getenv("HOST_VERBOSE") != NULL) ? 1 : 0;
+    setvbuf(stdout, NULL, _IOLBF, 0);
+}
+
+HOST_BOOT_RESULT_E Host_Boot(uint8_t enter_iap)
+{
+    pid_t pid;
+    int status;
+
+    memset(host_stats, 0, sizeof(HOST_STATS));
+    fflush(stdout);
+    pid = fork();
+    if (pid < 0)
+    {
+        perror("fork");
+        exit(2);
+    }
+    if (pid == 0)
+    {
+        host_enter_iap = enter_iap;
+        OTA_Run();
+        Host_Exit(HOST_RETURNED);
+    }
+    host_cut_at = 0;
+    host_fail_addr = 0;
+    if (waitpid(pid, &status, 0) != pid || !WIFEXITED(status))
+    {
+        return HOST_CRASHED;
+    }
+    return (HOST_BOOT_RESULT_E)WEXITSTATUS(status);
+}
+
+const char *Host_Log(void)
+{
+    host_log[host_stats->log_len] = '\0';
+    return host_log;
+}
+
+void Host_PowerCutAt(uint32_t n)
+{
+    host_cut_at = n;
+}
+
+void Host_ProgFailAt(uint32_t addr)
+{
+    host_fail_addr = addr;
+}
+
+uint8_t *Host_SnapshotSave(void)
+{
+    uint8_t *snap = malloc(flash_map_size + HOST_NOR_SIZE);
+
+    if (snap == NULL)
+    {
+        exit(2);
+    }
+    memcpy(snap, (const void *)(uintptr_t)OTA_FLASH_START_ADDRESS, flash_map_size);
+    memcpy(snap + flash_map_size, nor, HOST_NOR_SIZE);
+    return snap;
+}
+
+void Host_SnapshotRestore(const uint8_t *snap)
+{
+    memcpy((void *)(uintptr_t)OTA_FLASH_START_ADDRESS, snap, flash_map_size);
+    memcpy(nor, snap + flash_map_size, HOST_NOR_SIZE);
+}
+
+void Host_SenderLoad(const uint8_t *img, uint32_t len, uint16_t pkt)
+{
+    tx_img = img;
+    tx_len = len;
+    tx_pkt = pkt;
+    tx_sent = 0;
+    tx_blk = 1;
+    tx_state = (img != NULL) ? TX_IDLE : TX_DONE;
+    tx_n = 0;
+}
+
+uint32_t Host_MakeImage(uint8_t *buf, uint32_t body, uint32_t version, uint8_t seed)
+{
+    OTA_APP_IMG_HEADER_E hdr;
+    uint32_t sp = 0x20005000UL;
+    uint32_t reset = OTA_FLASH_START_ADDRESS + 0x101UL;
+
+    for (uint32_t i = 0; i < body; i++)
+    {
+        buf[sizeof(hdr) + i] = (uint8_t)(i * 7U + seed);
+    }
+    memcpy(buf + sizeof(hdr), &sp, 4);
+    memcpy(buf + sizeof(hdr) + 4, &reset, 4);
+
+    hdr.magic     = APP_MAGIC_NUM;
+    hdr.img_size  = body;
+    hdr.version   = version;
+    hdr.img_crc16 = OTA_GetCrc16(buf + sizeof(hdr), body);
+    hdr.hdr_len   = 0xFFFF;
+    memcpy(buf, &hdr, sizeof(hdr));
+    return sizeof(hdr) + body;
+}
+
+uint32_t Host_LoadFile(const char *path, uint8_t *buf, uint32_t size)
+{
+    FILE *f = fopen(path, "rb");
+    uint32_t n;
+
+    if (f == NULL)
+    {
+        return 0;
+    }
+    n = (uint32_t)fread(buf, 1, size, f);
+    fclose(f);
+    return n;
+}
+
+uint8_t *Host_NorArray(void)
+{
+    return nor;
+}
+
+void Host_Check(int ok, const char *what, const char *file, int line)
+{
+    checks++;
+    if (!ok)
+    {
+        failures++;
+        printf("FAIL %s:%d: %s\n", file, line, what);
+    }
+}
+
+uint64_t Host_Cycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000U + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+int Host_Report(void)
+{
+    printf("%d checks, %d failed\n", checks, failures);
+    return failures;
+}
+
+/* ========================= 串口: Xmodem 发送端 ========================= */
+
+static void Tx_QueuePacket(void)
+{
+    uint16_t crc;
+
+    tx_n = 0;
+    tx_buf[tx_n++] = (tx_pkt == 1024) ? XM_STX : XM_SOH;
+    tx_buf[tx_n++] = tx_blk;
+    tx_buf[tx_n++] = (uint8_t)~tx_blk;
+    for (uint32_t i = 0; i < tx_pkt; i++)
+    {
+        tx_buf[tx_n++] = (tx_sent + i < tx_len) ? tx_img[tx_sent + i] : 0x1A;
+    }
+    crc = OTA_GetCrc16(tx_buf + 3, tx_pkt);
+    tx_buf[tx_n++] = (uint8_t)(crc >> 8);
+    tx_buf[tx_n++] = (uint8_t)crc;
+    host_stats->packets++;
+}
+
+uint8_t OTA_SendByte(uint8_t byte)
+{
+    if (byte == XM_CAN)
+    {
+        host_stats->cancels++;
+        tx_state = TX_DONE;
+        tx_n = 0;
+        return 0;
+    }
+
+    switch (tx_state)
+    {
+    case TX_IDLE:
+        if (byte == 'C')
+        {
+            tx_state = TX_DATA;
+            Tx_QueuePacket();
+        }
+        break;
+    case TX_DATA:
+        if (byte == XM_ACK)
+        {
+            tx_sent += tx_pkt;
+            tx_blk++;
+            if (tx_sent >= tx_len)
+            {
+                tx_buf[0] = XM_EOT;
+                tx_n = 1;
+                tx_state = TX_EOT;
+            }
+            else
+            {
+                Tx_QueuePacket();
+            }
+        }
+        else if (byte == XM_NAK)
+        {
+            Tx_QueuePacket();
+        }
+        break;
+    case TX_EOT:
+        if (byte == XM_ACK)
+        {
+            host_stats->sent_all = 1;
+            tx_state = TX_DONE;
+        }
+        else if (byte == XM_NAK)
+        {
+            tx_buf[0] = XM_EOT;
+            tx_n = 1;
+        }
+        break;
+    default:
+        break;
+    }
+    return 0;
+}
+
+/* ============================== 时钟与杂项 ============================== */
+
+uint32_t OTA_GetTickMs(void)
+{
+    uint32_t n = tx_n;
+
+    /* 发送端的整包在主循环读取时钟时作为接收中断送入 */
+    tx_n = 0;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        OTA_ReceiveTask(tx_buf[i]);
+    }
+
+    host_us += 100U;
+    if (host_us > HOST_TIME_LIMIT_US)
+    {
+        Host_Exit(HOST_RETURNED);
+    }
+    return (uint32_t)(host_us / 1000U);
+}
+
+uint8_t OTA_ShouldEnterIap(void)
+{
+    return host_enter_iap;
+}
+
+void OTA_PeripheralsDeInit(void)
+{
+}
+
+void OTA_JumpToApp(uint32_t des_addr)
+{
+    OTA_LogFlush();
+    host_stats->jump_addr = des_addr;
+    Host_Exit(HOST_JUMPED);
+}
+
+void OTA_DebugTxStart(void)
+{
+    uint8_t c;
+
+    while (OTA_DebugTxTask(&c))
+    {
+        if (host_stats->log_len < HOST_LOG_SIZE)
+        {
+            host_log[host_stats->log_len++] = (char)c;
+            host_log[host_stats->log_len] = '\0';
+        }
+        if (host_verbose)
+        {
+            putchar(c);
+        }
+    }
+}
+
+void OTA_WatchdogFeed(void)
+{
+}
+
+void OTA_TimebaseInit(void)
+{
+}
+
+void OTA_ClockHighPerf(void)
+{
+}
+
+void OTA_ClockRestore(void)
+{
+}
+
+/* ============================== 内部 Flash ============================== */
+
+/**
+ * @brief  记录一次 Flash 操作
+ * @return 1: 本次操作执行到一半时断电
+ */
+static int Host_FlashOp(void)
+{
+    host_ops++;
+    return (host_cut_at != 0 && host_ops == host_cut_at) ? 1 : 0;
+}
+
+uint8_t OTA_FlashUnlock(void)
+{
+    flash_locked = 0;
+    return 0;
+}
+
+uint8_t OTA_FlashLock(void)
+{
+    flash_locked = 1;
+    return 0;
+}
+
+int OTA_ErasePage(uint32_t addr)
+{
+    uint8_t *page = (uint8_t *)(uintptr_t)(addr & ~(uint32_t)(OTA_FLASH_PAGE_SIZE - 1));
+
+    if (flash_locked)
+    {
+        return 1;
+    }
+    if (Host_FlashOp())
+    {
+        host_stats->cut_addr = addr;
+        memset(page, 0xFF, OTA_FLASH_PAGE_SIZE / 2);
+        Host_Exit(HOST_POWER_CUT);
+    }
+    memset(page, 0xFF, OTA_FLASH_PAGE_SIZE);
+    host_stats->erase++;
+    host_stats->busy_us += HOST_FLASH_ERASE_US;
+    host_us += HOST_FLASH_ERASE_US;
+    return 0;
+}
+
+int OTA_EraseStart(uint32_t addr)
+{
+    int ret = OTA_ErasePage(addr);
+
+    flash_busy_polls = 5;
+    return ret;
+}
+
+uint8_t OTA_FlashIsBusy(uint32_t addr)
+{
+    (void)addr;
+    if (flash_busy_polls != 0)
+    {
+        flash_busy_polls--;
+        return 1;
+    }
+    return 0;
+}
+
+int OTA_EraseComplete(uint32_t addr)
+{
+    (void)addr;
+    return 0;
+}
+
+int OTA_DrvProgramHalfword(uint32_t addr, uint16_t data)
+{
+    uint16_t *p = (uint16_t *)(uintptr_t)addr;
+
+    if (flash_locked || (addr & 1U) != 0)
+    {
+        return 1;
+    }
+    if (Host_FlashOp())
+    {
+        host_stats->cut_addr = addr;
+        Host_Exit(HOST_POWER_CUT);
+    }
+    if (*p != 0xFFFF || addr == host_fail_addr)
+    {
+        return 1;
+    }
+    *p = data;
+    host_stats->prog++;
+    host_stats->busy_us += HOST_FLASH_PROG_US;
+    host_us += HOST_FLASH_PROG_US;
+    return 0;
+}
+
+void OTA_DrvRead(uint32_t addr, uint8_t *buf, uint16_t len)
+{
+    memcpy(buf, (const void *)(uintptr_t)addr, len);
+}
+
+/* =============================== SPI NOR =============================== */
+
+void OTA_SpiSelect(uint8_t sel)
+{
+    /* 片选释放时执行擦除与编程 (编程数据已在传输中写入) */
+    if (!sel && nor_cs && nor_n > 0)
+    {
+        if (nor_cmd == 0x20 && nor_n >= 4)
+        {
+            if (nor_wel)
+            {
+                memset(nor + ((nor_addr % HOST_NOR_SIZE) & ~4095U), 0xFF, 4096);
+                host_stats->nor_erase++;
+                host_stats->busy_us += HOST_NOR_ERASE_US;
+                nor_busy_until = host_us + HOST_NOR_ERASE_US;
+            }
+            else
+            {
+                host_stats->nor_violation++;
+            }
+            nor_wel = 0;
+        }
+        else if (nor_cmd == 0x02 && nor_n > 4 && nor_wel)
+        {
+            host_stats->nor_prog++;
+            host_stats->busy_us += HOST_NOR_PROG_US;
+            nor_busy_until = host_us + HOST_NOR_PROG_US;
+            nor_wel = 0;
+        }
+        else if (nor_cmd == 0x06)
+        {
+            nor_wel = 1;
+        }
+    }
+    nor_cs = sel;
+    nor_n = 0;
+}
+
+uint8_t OTA_SpiTransfer(uint8_t byte)
+{
+    static const uint8_t jedec_id[3] = { 0xEF, 0x40, 0x14 };
+    uint8_t r = 0xFF;
+
+    host_us += 1U;
+    if (!nor_cs)
+    {
+        return r;
+    }
+    if (nor_n == 0)
+    {
+        nor_cmd = byte;
+        nor_addr = 0;
+        if (byte != 0x05 && host_us < nor_busy_until)
+        {
+            /* 忙期间只响应读状态，其余命令被芯片忽略 */
+            host_stats->nor_violation++;
+            nor_cmd = 0x00;
+        }
+        if (byte == 0x02 && !nor_wel)
+        {
+            host_stats->nor_violation++;
+        }
+    }
+    else if (nor_cmd == 0x05)
+    {
+        r = (host_us < nor_busy_until) ? 0x01 : 0x00;
+    }
+    else if (nor_cmd == 0x9F)
+    {
+        r = (nor_n <= 3) ? jedec_id[nor_n - 1] : 0xFF;
+    }
+    else if (nor_n <= 3)
+    {
+        nor_addr = (nor_addr << 8) | byte;
+    }
+    else if (nor_cmd == 0x03)
+    {
+        r = nor[nor_addr % HOST_NOR_SIZE];
+        nor_addr++;
+    }
+    else if (nor_cmd == 0x02 && nor_wel)
+    {
+        /* 页内回绕，编程只能把 1 写成 0 */
+        uint32_t a = (nor_addr & ~255U) | ((nor_addr + nor_n - 4U) & 255U);
+        nor[a % HOST_NOR_SIZE] &= byte;
+    }
+    nor_n++;
+    return r;
+}
+
+void OTA_SpiTransferBlock(const uint8_t *tx, uint8_t *rx, uint32_t len)
+{
+    for (uint32_t i = 0; i < len; i++)
+    {
+        uint8_t r = OTA_SpiTransfer((tx != NULL) ? tx[i] : 0xFF);
+
+        if (rx != NULL)
+        {
+            rx[i] = r;
+        }
+    }
+}
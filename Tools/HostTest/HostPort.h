@@ -0,0 +1,164 @@
+/**
+ ******************************************************************************
+ * @file    HostPort.h
+ * @author  MiniOTA Team
+ * @brief   主机测试移植层头文件
+ *          内部 Flash 映射到 OTA_FLASH_START_ADDRESS，外部 SPI NOR 为 25 系列命令模型，
+ *          串口对端为 Xmodem-CRC 发送端; 每次启动在 fork 出的子进程中运行 OTA_Run，
+ *          RAM 状态与真实复位一致，Flash、SPI NOR 与统计数据为共享映射，复位与断电后保持
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 MiniOTA.
+ * All rights reserved.
+ *
+ ******************************************************************************
+ */
+
+#ifndef HOSTPORT_H
+#define HOSTPORT_H
+
+#include <stdio.h>
+#include "OtaInterface.h"
+#include "OtaUtils.h"
+
+/* 模拟时序 (us)，用于累计 Flash 忙时间: 内部 Flash 取 STM32F103 数据手册典型值，SPI NOR 取 W25Q 系列典型值 */
+#define HOST_FLASH_ERASE_US     20000U  /**< 内部 Flash 页擦除 */
+#define HOST_FLASH_PROG_US      52U     /**< 内部 Flash 半字编程 */
+#define HOST_NOR_ERASE_US       45000U  /**< SPI NOR 4KB 扇区擦除 */
+#define HOST_NOR_PROG_US        700U    /**< SPI NOR 页编程 */
+#define HOST_NOR_SIZE           0x100000U
+#define HOST_LOG_SIZE           0x10000U    /**< Host_Log 保存的日志字节数上限 */
+
+/**
+ * @brief Host_Boot 的结果
+ */
+typedef enum
+{
+    HOST_RETURNED = 1,      /**< OTA_Run 返回 */
+    HOST_JUMPED,            /**< 跳转到 App，地址见 host_stats->jump_addr */
+    HOST_POWER_CUT,         /**< 在第 Host_PowerCutAt 次 Flash 操作时断电 */
+    HOST_CRASHED            /**< 子进程异常退出 */
+} HOST_BOOT_RESULT_E;
+
+/**
+ * @brief 共享统计数据 (每次 Host_Boot 前清零)
+ */
+typedef struct
+{
+    uint32_t erase;         /**< 内部 Flash 页擦除次数 */
+    uint32_t prog;          /**< 内部 Flash 半字编程次数 */
+    uint32_t nor_erase;     /**< SPI NOR 扇区擦除次数 */
+    uint32_t nor_prog;      /**< SPI NOR 页编程次数 */
+    uint32_t nor_violation; /**< SPI NOR 时序违例: 忙时发命令、未写使能即编程/擦除 */
+    uint64_t busy_us;       /**< 按模拟时序累计的 Flash 忙时间 */
+    uint32_t packets;       /**< 发送端发出的数据包 (含重发) */
+    uint32_t cancels;       /**< 发送端收到的 CAN */
+    uint8_t  sent_all;      /**< 发送端收到了 EOT 的 ACK */
+    uint32_t jump_addr;     /**< 跳转地址 */
+    uint32_t cut_addr;      /**< 断电时正在擦写的地址 */
+    uint32_t log_len;       /**< 本次启动输出的调试日志字节数 (见 Host_Log) */
+} HOST_STATS;
+
+extern HOST_STATS *host_stats;
+
+/**
+ * @brief  初始化模拟 Flash、SPI NOR 与统计区 (全部擦除为 0xFF)，每个测试程序开始时调用一次
+ */
+void Host_Init(void);
+
+/**
+ * @brief  模拟一次上电启动: 在子进程中运行 OTA_Run
+ * @param  enter_iap: OTA_ShouldEnterIap 的返回值
+ * @return HOST_BOOT_RESULT_E
+ */
+HOST_BOOT_RESULT_E Host_Boot(uint8_t enter_iap);
+
+/**
+ * @brief  设置下一次启动时的断电点: 第 n 次内部 Flash 操作 (页擦除或半字编程) 执行到一半时断电
+ *         被中断的擦除只完成前半页，被中断的编程不写入; 0 表示不断电
+ * @param  n: 操作序号 (从 1 开始)
+ */
+void Host_PowerCutAt(uint32_t n);
+
+/**
+ * @brief  设置下一次启动时编程失败的内部 Flash 地址 (模拟坏单元): 编程该半字时返回错误
+ * @param  addr: 半字地址，0 表示不注入
+ */
+void Host_ProgFailAt(uint32_t addr);
+
+/**
+ * @brief  保存内部 Flash 与 SPI NOR 的全部内容
+ * @return 快照 (用 free 释放)
+ */
+uint8_t *Host_SnapshotSave(void);
+
+/**
+ * @brief  恢复 Host_SnapshotSave 保存的内容
+ * @param  snap: 快照
+ */
+void Host_SnapshotRestore(const uint8_t *snap);
+
+/**
+ * @brief  设置 Xmodem 发送端的固件，下一次进入 IAP 时发送
+ * @param  img: 固件 (含固件头)
+ * @param  len: 长度
+ * @param  pkt: 包长 128 或 1024
+ */
+void Host_SenderLoad(const uint8_t *img, uint32_t len, uint16_t pkt);
+
+/**
+ * @brief  生成带 v1 固件头的测试固件: 向量表有效，其余字节由 seed 决定
+ * @param  buf: 输出缓冲区 (至少 16 + body 字节)
+ * @param  body: 固件体长度
+ * @param  version: 版本号
+ * @param  seed: 内容种子
+ * @return 固件总长度
+ */
+uint32_t Host_MakeImage(uint8_t *buf, uint32_t body, uint32_t version, uint8_t seed);
+
+/**
+ * @brief  读取文件
+ * @param  path: 路径
+ * @param  buf: 输出缓冲区
+ * @param  size: 缓冲区大小
+ * @return 读取的长度，失败为 0
+ */
+uint32_t Host_LoadFile(const char *path, uint8_t *buf, uint32_t size);
+
+/**
+ * @brief  SPI NOR 存储阵列 (按偏移直接访问，不经过命令模型)
+ * @return 指向阵列起始的指针
+ */
+uint8_t *Host_NorArray(void);
+
+/**
+ * @brief  上一次 Host_Boot 输出的调试日志 (以 '\0' 结尾，超过 HOST_LOG_SIZE 的部分被截断)
+ *         令牌化日志为二进制帧，长度见 host_stats->log_len
+ */
+const char *Host_Log(void);
+
+/**
+ * @brief  读取主机周期计数，用于基准测试: x86 为 TSC，其他平台为纳秒
+ * @return 计数值
+ */
+uint64_t Host_Cycles(void);
+
+/**
+ * @brief  记录一条检查结果，失败时打印位置与说明
+ * @param  ok: 检查是否通过
+ * @param  what: 说明
+ * @param  file: 文件
+ * @param  line: 行号
+ */
+void Host_Check(int ok, const char *what, const char *file, int line);
+
+/**
+ * @brief  打印检查汇总
+ * @return 失败的检查数 (作为 main 的返回值)
+ */
+int Host_Report(void);
+
+#define HOST_CHECK(cond)    Host_Check((cond) ? 1 : 0, #cond, __FILE__, __LINE__)
+
+#endif
@@ -0,0 +1,114 @@
+/**
+ ******************************************************************************
+ * @file    TestAgent.c
+ * @author  MiniOTA Team
+ * @brief   App 侧预擦除与后台升级代理测试
+ *          - 预擦除完成后代理接收固件，复位后 Bootloader 安装
+ *          - 代理会话中断后插槽已不再空白: 预擦除标记应已清除，
+ *            下一次 Bootloader 会话须重新擦除，下载的固件完整可用
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 MiniOTA.
+ * All rights reserved.
+ *
+ ******************************************************************************
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "HostPort.h"
+#include "OtaApp.h"
+#include "OtaMeta.h"
+
+#define BODY_SIZE   6000U
+
+static uint8_t img1[16 + BODY_SIZE];
+static uint8_t img2[16 + BODY_SIZE];
+static uint8_t img3[16 + BODY_SIZE];
+
+/**
+ * @brief  插槽中是否为指定固件
+ */
+static int SlotHolds(OTA_ACIVE_SLOT_E slot, const uint8_t *img, uint32_t len)
+{
+    return memcmp((const void *)(uintptr_t)OTA_MetaSlotAddr(slot), img, len) == 0;
+}
+
+/**
+ * @brief  在 App 中预擦除下一次升级的目标插槽
+ * @return 目标插槽
+ */
+static OTA_ACIVE_SLOT_E PreErase(void)
+{
+    OTA_META_DATA_E meta;
+    OTA_APP_PRE_ERASE_E r;
+
+    do
+    {
+        r = OTA_AppPreErase(50);
+    } while (r == OTA_PRE_ERASE_BUSY);
+    HOST_CHECK(r == OTA_PRE_ERASE_DONE);
+    HOST_CHECK(OTA_MetaLoad(&meta) == OTA_TRUE);
+    HOST_CHECK(meta.pre_erased == OTA_MetaGetIapSlot(&meta));
+    return OTA_MetaGetIapSlot(&meta);
+}
+
+/**
+ * @brief  运行代理直到结束，或发送端发出 max_packets 个数据包后停止 (模拟会话中断)
+ * @return 代理状态
+ */
+static OTA_APP_AGENT_STATE_E RunAgent(uint32_t max_packets)
+{
+    OTA_APP_AGENT_STATE_E st;
+
+    do
+    {
+        st = OTA_AppAgentPoll();
+    } while (st == OTA_AGENT_RUNNING && host_stats->packets < max_packets);
+    return st;
+}
+
+int main(void)
+{
+    OTA_META_DATA_E meta;
+    OTA_ACIVE_SLOT_E slot;
+    uint32_t len1, len2, len3;
+
+    Host_Init();
+    len1 = Host_MakeImage(img1, BODY_SIZE, 1, 0x11);
+    len2 = Host_MakeImage(img2, BODY_SIZE, 2, 0x22);
+    len3 = Host_MakeImage(img3, BODY_SIZE, 3, 0x33);
+
+    Host_SenderLoad(img1, len1, 1024);
+    HOST_CHECK(Host_Boot(1) == HOST_JUMPED);
+
+    /* App 中预擦除后由代理接收完整固件，复位后启动新固件 */
+    slot = PreErase();
+    memset(host_stats, 0, sizeof(HOST_STATS));
+    Host_SenderLoad(img2, len2, 1024);
+    HOST_CHECK(OTA_AppAgentStart() == 0);
+    HOST_CHECK(OTA_MetaLoad(&meta) == OTA_TRUE && meta.pre_erased == OTA_PRE_ERASED_NONE);
+    HOST_CHECK(RunAgent(UINT32_MAX) == OTA_AGENT_DONE);
+    HOST_CHECK(host_stats->erase == 2);                 /* 插槽不再擦除，只有开始与完成时各写一次 Meta */
+    HOST_CHECK(SlotHolds(slot, img2, len2));
+    HOST_CHECK(Host_Boot(0) == HOST_JUMPED);
+    HOST_CHECK(host_stats->jump_addr == OTA_MetaSlotAddr(slot) + 16U);
+
+    /* 预擦除后代理只收到部分数据即中断: 插槽中已有数据，预擦除标记不能再被使用 */
+    slot = PreErase();
+    memset(host_stats, 0, sizeof(HOST_STATS));
+    Host_SenderLoad(img1, len1, 1024);
+    HOST_CHECK(OTA_AppAgentStart() == 0);
+    HOST_CHECK(RunAgent(3) == OTA_AGENT_RUNNING);
+    HOST_CHECK(OTA_MetaLoad(&meta) == OTA_TRUE && meta.pre_erased == OTA_PRE_ERASED_NONE);
+
+    /* 复位后在 Bootloader 中重新下载另一个固件到同一插槽 */
+    Host_SenderLoad(img3, len3, 1024);
+    HOST_CHECK(Host_Boot(1) == HOST_JUMPED);
+    HOST_CHECK(host_stats->erase > 0);
+    HOST_CHECK(SlotHolds(slot, img3, len3));
+    HOST_CHECK(host_stats->jump_addr == OTA_MetaSlotAddr(slot) + 16U);
+
+    return Host_Report();
+}
@@ -0,0 +1,94 @@
+/**
+ ******************************************************************************
+ * @file    TestBackup.c
+ * @author  MiniOTA Team
+ * @brief   压缩备份 (OTA_BACKUP_COMPRESSED) 的 LZ 压缩与解压往返测试
+ *          Slot A 中写入测试数据，压缩到 Slot B 后清除 Slot A，解压回 Slot A 应与原数据一致:
+ *          - 不可压缩的随机数据: 放得下时往返一致，整个 Slot A 的随机数据放不下时返回失败
+ *          - 全 0xFF (擦除后的空白区): 长度扩展字节
+ *          - 距离恰为 / 超过 64KB 窗口的重复块，与跨 64KB 位置的短周期重复段
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 MiniOTA.
+ * All rights reserved.
+ *
+ ******************************************************************************
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "HostPort.h"
+#include "OtaBackup.h"
+
+#define WINDOW      0xFFFFU         /* 与 OtaBackup.c 的 LZ_MAX_OFFSET 相同 */
+
+static uint8_t data[OTA_APP_SLOT_SIZE];
+
+/**
+ * @brief  压缩 Slot A 中的 len 字节，清除 Slot A 后解压，比对结果
+ * @param  name: 用例名称
+ * @param  len: 长度
+ */
+static void RoundTrip(const char *name, uint32_t len)
+{
+    uint8_t *slot_a = (uint8_t *)(uintptr_t)OTA_APP_A_ADDR;
+    int ok;
+
+    memcpy(slot_a, data, len);
+    HOST_CHECK(OTA_BackupSave(len) == 0);
+    HOST_CHECK(OTA_BackupIsCurrent(len) == OTA_TRUE);
+
+    memset(slot_a, 0x00, OTA_APP_SLOT_SIZE);
+    HOST_CHECK(OTA_BackupRestore() == 0);
+    ok = memcmp(slot_a, data, len) == 0;
+    HOST_CHECK(ok);
+    printf("%-22s %6u bytes -> %u-byte backup slot: %s\n",
+           name, (unsigned)len, (unsigned)OTA_APP_B_SIZE, ok ? "restored" : "MISMATCH");
+}
+
+int main(void)
+{
+    uint32_t i;
+
+    Host_Init();
+    srand(40);
+
+    /* 不可压缩 */
+    for (i = 0; i < sizeof(data); i++)
+    {
+        data[i] = (uint8_t)rand();
+    }
+    RoundTrip("incompressible", OTA_APP_B_SIZE * 3U / 4U);
+    memcpy((void *)(uintptr_t)OTA_APP_A_ADDR, data, sizeof(data));
+    HOST_CHECK(OTA_BackupSave(sizeof(data)) != 0);
+
+    /* 全 0xFF，长度为整个插槽与非 4 的倍数 */
+    memset(data, 0xFF, sizeof(data));
+    RoundTrip("all 0xFF", sizeof(data));
+    RoundTrip("all 0xFF, odd length", sizeof(data) - 3U);
+
+    /* 窗口边界 (压缩器只在匹配起点记录哈希，长段重复不会挤掉远处的位置):
+     * 随机块 R 之后隔 0xFF 段在距离恰为 WINDOW 处重复，可用最远的匹配;
+     * 随机块 S 之后隔 0x00 段在距离 WINDOW + 1 处重复，超出窗口只能作为字面量;
+     * 跨 64KB 位置与末尾为周期 5 / 7 的短周期重复段 */
+    for (i = 0; i < sizeof(data); i++)
+    {
+        data[i] = (uint8_t)rand();
+    }
+    memset(&data[6000], 0xFF, 64000U - 6000U);
+    for (i = 64005U; i < 67000U; i++)
+    {
+        data[i] = data[i - 5U];
+    }
+    memcpy(&data[2000U + WINDOW], &data[2000], 4000);
+    memset(&data[76000], 0x00, 72000U + WINDOW + 1U - 76000U);
+    memcpy(&data[72000U + WINDOW + 1U], &data[72000], 4000);
+    for (i = 142000U; i < sizeof(data); i++)
+    {
+        data[i] = data[i - 7U];
+    }
+    RoundTrip("window boundary", sizeof(data));
+
+    return Host_Report();
+}
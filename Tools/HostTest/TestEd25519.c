@@ -0,0 +1,163 @@
+/**
+ ******************************************************************************
+ * @file    TestEd25519.c
+ * @author  MiniOTA Team
+ * @brief   Ed25519 签名验证测试
+ *          - RFC 8032 第 7.1 节测试向量 (TEST 1/2/3 与 TEST SHA(abc))
+ *          - 签名、公钥、消息任一比特被篡改时拒绝; 拒绝 S >= L 与公钥 y >= p 的不规范编码
+ *          - 主机上每次验证的周期数
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 MiniOTA.
+ * All rights reserved.
+ *
+ ******************************************************************************
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "HostPort.h"
+#include "OtaEd25519.h"
+
+#define BENCH_ROUNDS    200U
+
+/**
+ * @brief 测试向量 (十六进制)
+ */
+typedef struct
+{
+    const char *pub;
+    const char *msg;
+    const char *sig;
+} ED_VECTOR_E;
+
+static const ED_VECTOR_E vectors[] =
+{
+    /* TEST 1 */
+    { "d75a980182b10ab7d54bfed3c964073a0ee172f3daa62325af021a68f707511a",
+      "",
+      "e5564300c360ac729086e2cc806e828a84877f1eb8e5d974d873e065224901555fb8821590a33bacc61e39701cf9b46bd25bf5f0595bbe24655141438e7a100b" },
+    /* TEST 2 */
+    { "3d4017c3e843895a92b70aa74d1b7ebc9c982ccf2ec4968cc0cd55f12af4660c",
+      "72",
+      "92a009a9f0d4cab8720e820b5f642540a2b27b5416503f8fb3762223ebdb69da085ac1e43e15996e458f3613d0f11d8c387b2eaeb4302aeeb00d291612bb0c00" },
+    /* TEST 3 */
+    { "fc51cd8e6218a1a38da47ed00230f0580816ed13ba3303ac5deb911548908025",
+      "af82",
+      "6291d657deec24024827e69c3abe01a30ce548a284743a445e3680d7db5ac3ac18ff9b538d16f290ae67f760984dc6594a7c15e9716ed28dc027beceea1ec40a" },
+    /* TEST SHA(abc): 消息为 "abc" 的 SHA-512 摘要 */
+    { "ec172b93ad5e563bf4932c70e1245034c35467ef2efd4d64ebf819683467e2bf",
+      "ddaf35a193617abacc417349ae20413112e6fa4e89a97ea20a9eeee64b55d39a2192992a274fc1a836ba3c23a3feebbd454d4423643ce80e2a9ac94fa54ca49f",
+      "dc2a4459e7369633a52b1bf277839a00201009a3efbf3ecb69bea2186c26b58909351fc9ac90b3ecfdfbc7c66431e0303dca179c138ac17ad9bef1177331a704" },
+};
+
+/* 群的阶 L = 2^252 + 27742317777372353535851937790883648493 (小端) */
+static const uint8_t order_l[32] =
+{
+    0xED, 0xD3, 0xF5, 0x5C, 0x1A, 0x63, 0x12, 0x58, 0xD6, 0x9C, 0xF7, 0xA2, 0xDE, 0xF9, 0xDE, 0x14,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10
+};
+
+/**
+ * @brief  十六进制字符串转字节
+ * @return 字节数
+ */
+static uint32_t FromHex(const char *hex, uint8_t *out)
+{
+    uint32_t n = (uint32_t)strlen(hex) / 2U;
+    unsigned int b;
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        sscanf(&hex[2U * i], "%2x", &b);
+        out[i] = (uint8_t)b;
+    }
+    return n;
+}
+
+int main(void)
+{
+    uint8_t pub[OTA_ED25519_KEY_SIZE];
+    uint8_t sig[OTA_ED25519_SIG_SIZE];
+    uint8_t bad[OTA_ED25519_SIG_SIZE];
+    uint8_t msg[64];
+    uint32_t len, carry, tampered = 0;
+    uint64_t t0, best = UINT64_MAX, total = 0;
+
+    for (uint32_t v = 0; v < sizeof(vectors) / sizeof(vectors[0]); v++)
+    {
+        FromHex(vectors[v].pub, pub);
+        FromHex(vectors[v].sig, sig);
+        len = FromHex(vectors[v].msg, msg);
+        HOST_CHECK(OTA_Ed25519Verify(sig, pub, msg, len) == 0);
+
+        /* 篡改签名的每一比特 */
+        for (uint32_t bit = 0; bit < 8U * OTA_ED25519_SIG_SIZE; bit++)
+        {
+            sig[bit / 8U] ^= (uint8_t)(1U << (bit % 8U));
+            HOST_CHECK(OTA_Ed25519Verify(sig, pub, msg, len) != 0);
+            sig[bit / 8U] ^= (uint8_t)(1U << (bit % 8U));
+            tampered++;
+        }
+        /* 篡改公钥的每一比特 (不在曲线上或为另一把公钥) */
+        for (uint32_t bit = 0; bit < 8U * OTA_ED25519_KEY_SIZE; bit++)
+        {
+            pub[bit / 8U] ^= (uint8_t)(1U << (bit % 8U));
+            HOST_CHECK(OTA_Ed25519Verify(sig, pub, msg, len) != 0);
+            pub[bit / 8U] ^= (uint8_t)(1U << (bit % 8U));
+            tampered++;
+        }
+        /* 篡改消息的每一比特，或截短一个字节 */
+        for (uint32_t bit = 0; bit < 8U * len; bit++)
+        {
+            msg[bit / 8U] ^= (uint8_t)(1U << (bit % 8U));
+            HOST_CHECK(OTA_Ed25519Verify(sig, pub, msg, len) != 0);
+            msg[bit / 8U] ^= (uint8_t)(1U << (bit % 8U));
+            tampered++;
+        }
+        if (len > 0U)
+        {
+            HOST_CHECK(OTA_Ed25519Verify(sig, pub, msg, len - 1U) != 0);
+            tampered++;
+        }
+
+        /* S + L 与 S 模 L 同余，但编码不规范，应拒绝 */
+        memcpy(bad, sig, sizeof(bad));
+        carry = 0;
+        for (uint32_t i = 0; i < 32U; i++)
+        {
+            carry += (uint32_t)bad[32U + i] + order_l[i];
+            bad[32U + i] = (uint8_t)carry;
+            carry >>= 8;
+        }
+        HOST_CHECK(carry == 0 && OTA_Ed25519Verify(bad, pub, msg, len) != 0);
+        HOST_CHECK(OTA_Ed25519Verify(sig, pub, msg, len) == 0);
+    }
+
+    /* 公钥 y = p + 1 (不规范编码，模 p 后为 y = 1 即单位元) */
+    memset(pub, 0xFF, sizeof(pub));
+    pub[0] = 0xEE;
+    pub[31] = 0x7F;
+    FromHex(vectors[0].sig, sig);
+    HOST_CHECK(OTA_Ed25519Verify(sig, pub, NULL, 0) != 0);
+    printf("ed25519: %u RFC 8032 vectors, %u tampered inputs rejected\n",
+           (unsigned)(sizeof(vectors) / sizeof(vectors[0])), (unsigned)tampered);
+
+    /* 基准: TEST SHA(abc) 的 64 字节消息 */
+    FromHex(vectors[3].pub, pub);
+    FromHex(vectors[3].sig, sig);
+    len = FromHex(vectors[3].msg, msg);
+    for (uint32_t r = 0; r < BENCH_ROUNDS; r++)
+    {
+        t0 = Host_Cycles();
+        HOST_CHECK(OTA_Ed25519Verify(sig, pub, msg, len) == 0);
+        t0 = Host_Cycles() - t0;
+        best = (t0 < best) ? t0 : best;
+        total += t0;
+    }
+    printf("ed25519 verify: best %.3f M cycles, mean %.3f M cycles (host)\n",
+           best / 1e6, total / 1e6 / BENCH_ROUNDS);
+
+    return Host_Report();
+}
@@ -0,0 +1,97 @@
+/**
+ ******************************************************************************
+ * @file    TestFlashPatch.c
+ * @author  MiniOTA Team
+ * @brief   外部 SPI NOR 上的页镜像读-改-写测试 (OTA_EXT_STAGING + OTA_REPAIR_ENABLE)
+ *          SPI NOR 按 4KB 扇区擦除，页镜像为 1KB: 修复时 OTA_FlashPatch 随机载入的页写回后，
+ *          同一扇区中的其他数据应保持不变; 顺序写入时每个扇区只擦除一次
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 MiniOTA.
+ * All rights reserved.
+ *
+ ******************************************************************************
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "HostPort.h"
+#include "OtaFlash.h"
+
+#define SECTOR      4096U
+#define AREA        (4U * SECTOR)
+
+static uint8_t expect[AREA];
+
+/**
+ * @brief  在暂存分区起始处 AREA 字节内按偏移打补丁，写回后与期望内容比对
+ * @param  off: 偏移
+ * @param  len: 长度
+ * @param  seed: 补丁内容种子
+ */
+static void Patch(uint32_t off, uint32_t len, uint8_t seed)
+{
+    uint8_t data[2048];
+
+    for (uint32_t i = 0; i < len; i++)
+    {
+        data[i] = (uint8_t)(i * 29U + seed);
+    }
+    memcpy(&expect[off], data, len);
+    HOST_CHECK(OTA_FlashPatch(OTA_APP_B_ADDR + off, data, len) == 0);
+    HOST_CHECK(OTA_FlashFlush() == 0);
+    HOST_CHECK(memcmp(Host_NorArray() + OTA_EXT_STAGING_OFFSET, expect, AREA) == 0);
+}
+
+int main(void)
+{
+    uint8_t *nor;
+    uint32_t erases;
+
+    Host_Init();
+    nor = Host_NorArray() + OTA_EXT_STAGING_OFFSET;
+    for (uint32_t i = 0; i < AREA; i++)
+    {
+        nor[i] = (uint8_t)(i ^ (i >> 8) ^ 0x5A);
+    }
+    memcpy(expect, nor, AREA);
+
+    /* 修复: 与 OTA_RepairSlot 相同，先初始化页镜像再按分块打补丁 */
+    memset(host_stats, 0, sizeof(HOST_STATS));
+    OTA_FlashHandleInit(OTA_APP_B_ADDR);
+    Patch(SECTOR + 1024U + 10U, 100, 0x11);          /* 扇区中间的页 */
+    Patch(2U * SECTOR + 5U, 300, 0x22);              /* 扇区起始的页 */
+    Patch(5U, 40, 0x33);                             /* 初始化地址所在的页 */
+    Patch(3U * SECTOR - 50U, 100, 0x44);             /* 跨扇区边界 */
+    Patch(SECTOR - 1024U, 2048, 0x55);               /* 连续两页: 上一页写回后下一页仍保留扇区数据 */
+    HOST_CHECK(host_stats->nor_violation == 0);
+    printf("patch 5 ranges: %u sector erases\n", (unsigned)host_stats->nor_erase);
+
+    /* 只需把 1 写成 0 时不擦除 */
+    erases = host_stats->nor_erase;
+    memset(&nor[3U * SECTOR], 0xFF, 1024);
+    memset(&expect[3U * SECTOR], 0xFF, 1024);
+    OTA_FlashHandleInit(OTA_APP_B_ADDR);
+    Patch(3U * SECTOR + 100U, 64, 0x66);
+    HOST_CHECK(host_stats->nor_erase == erases);
+
+    /* 顺序写入 (接收固件): 每个扇区在其第一页写入时擦除一次，之后的页直接编程 */
+    memset(host_stats, 0, sizeof(HOST_STATS));
+    OTA_FlashHandleInit(OTA_APP_B_ADDR);
+    for (uint32_t page = 0; page < AREA / OTA_FLASH_PAGE_SIZE; page++)
+    {
+        for (uint32_t i = 0; i < OTA_FLASH_PAGE_SIZE; i++)
+        {
+            OTA_FlashGetMirr()[i] = (uint8_t)(page * 3U + i);
+            expect[page * OTA_FLASH_PAGE_SIZE + i] = (uint8_t)(page * 3U + i);
+        }
+        OTA_FlashSetPageOffset(OTA_FLASH_PAGE_SIZE);
+        HOST_CHECK(OTA_FlashWrite() == 0);
+    }
+    HOST_CHECK(memcmp(nor, expect, AREA) == 0);
+    HOST_CHECK(host_stats->nor_erase == AREA / SECTOR);
+    HOST_CHECK(host_stats->nor_violation == 0);
+
+    return Host_Report();
+}
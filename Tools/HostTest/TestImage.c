@@ -0,0 +1,178 @@
+/**
+ ******************************************************************************
+ * @file    TestImage.c
+ * @author  MiniOTA Team
+ * @brief   v2 固件下载测试 (OtaImageGen.py 生成的加密、分段、带摘要与签名的固件)
+ *          同一源文件按三种配置编译 (见 Makefile):
+ *          - TestImage:      OTA_AES_ENABLE + OTA_SHA256_ENABLE + OTA_REPAIR_ENABLE
+ *          - TestImageSig:   OTA_AES_ENABLE + OTA_SHA256_ENABLE + OTA_SIG_ENABLE
+ *          - TestImageNoAes: OTA_SHA256_ENABLE
+ *          每个固件从空片以 128 与 1024 字节包下载，按配置检查启动或拒绝; 启动时插槽中应为明文
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 MiniOTA.
+ * All rights reserved.
+ *
+ ******************************************************************************
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "HostPort.h"
+
+#define FILE_MAX    (16U * 1024U)
+
+/**
+ * @brief 测试固件 (由 Makefile 调用 OtaImageGen.py 生成)
+ */
+typedef struct
+{
+    const char *name;       /**< 固件文件 */
+    const char *body;       /**< 对应的明文固件体 */
+    uint8_t     encrypted;  /**< --encrypt */
+    uint8_t     sign;       /**< --sign */
+    uint8_t     good_key;   /**< 用 Bootloader 中的密钥加密 (未加密时为 1) */
+} IMAGE_CASE_E;
+
+static const IMAGE_CASE_E cases[] =
+{
+    { "plain.img",   "app.bin",      0, 0, 1 },    /* 只带摘要与分块 CRC 表 */
+    { "enc.img",     "app.bin",      1, 0, 1 },    /* 加密，固件头 0x100 */
+    { "enc_odd.img", "app.bin",      1, 0, 1 },    /* 加密，固件头 0xF4: 固件体在包中的位置不对齐到分组 */
+    { "seg.img",     "app_flat.bin", 1, 0, 1 },    /* 加密的分段固件，各段长度不是 16 的倍数 */
+    { "sig.img",     "app.bin",      1, 1, 1 },    /* 加密并签名 */
+    { "sig_seg.img", "app_flat.bin", 1, 1, 1 },    /* 加密、分段并签名 */
+    { "wrong.img",   "app.bin",      1, 1, 0 },    /* 用另一把密钥加密: 解出的明文与摘要不符 */
+};
+
+static const char *data_dir;
+static uint8_t img[FILE_MAX];
+static uint8_t body[FILE_MAX];
+
+/**
+ * @brief  读取数据目录中的文件
+ * @return 长度
+ */
+static uint32_t Load(const char *name, uint8_t *buf)
+{
+    char path[256];
+    uint32_t len;
+
+    snprintf(path, sizeof(path), "%s/%s", data_dir, name);
+    len = Host_LoadFile(path, buf, FILE_MAX);
+    HOST_CHECK(len > 0 && len < FILE_MAX);
+    return len;
+}
+
+/**
+ * @brief  按配置判断固件是否应被接受
+ */
+static int Accepted(const IMAGE_CASE_E *c)
+{
+    if (c->encrypted && !OTA_AES_ENABLE)
+    {
+        return 0;
+    }
+    if (!c->sign && OTA_SIG_ENABLE)
+    {
+        return 0;
+    }
+    return c->good_key;
+}
+
+/**
+ * @brief  Slot A 中是否为 固件头 + 明文固件体
+ */
+static int SlotAHolds(uint32_t hdr_len, uint32_t body_len)
+{
+    const uint8_t *slot = (const uint8_t *)(uintptr_t)OTA_APP_A_ADDR;
+
+    return memcmp(slot, img, hdr_len) == 0 && memcmp(slot + hdr_len, body, body_len) == 0;
+}
+
+#if OTA_REPAIR_ENABLE
+/**
+ * @brief  加密固件的修复流: 损坏 Slot A 中的分块 1 与 3，上电后应以修复流补发这两块
+ * @param  empty: 空片快照
+ */
+static void TestRepair(const uint8_t *empty)
+{
+    static uint8_t rep[FILE_MAX];
+    uint8_t *slot = (uint8_t *)(uintptr_t)OTA_APP_A_ADDR;
+    uint32_t img_len, body_len, rep_len, hdr_len;
+
+    Host_SnapshotRestore(empty);
+    img_len  = Load("enc.img", img);
+    body_len = Load("app.bin", body);
+    rep_len  = Load("rep.img", rep);
+    hdr_len  = (uint32_t)img[14] | ((uint32_t)img[15] << 8);
+    Host_SenderLoad(img, img_len, 1024);
+    HOST_CHECK(Host_Boot(1) == HOST_JUMPED);
+    HOST_CHECK(SlotAHolds(hdr_len, body_len));
+
+    slot[hdr_len + 1024U + 5U] &= 0x0F;
+    slot[hdr_len + 3U * 1024U + 100U] &= 0xF0;
+    HOST_CHECK(!SlotAHolds(hdr_len, body_len));
+    Host_SenderLoad(rep, rep_len, 1024);
+    HOST_CHECK(Host_Boot(0) == HOST_JUMPED);
+    HOST_CHECK(host_stats->sent_all);
+    HOST_CHECK(SlotAHolds(hdr_len, body_len));
+    printf("encrypted repair stream: %u bytes fixed 2 chunks\n", (unsigned)rep_len);
+}
+#endif
+
+int main(int argc, char **argv)
+{
+    uint8_t *empty;
+    uint32_t img_len, body_len, hdr_len, booted = 0, rejected = 0;
+    HOST_BOOT_RESULT_E r;
+
+    if (argc < 2)
+    {
+        printf("usage: %s <data dir>\n", argv[0]);
+        return 1;
+    }
+    data_dir = argv[1];
+    Host_Init();
+    empty = Host_SnapshotSave();
+
+    for (uint32_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+    {
+        const IMAGE_CASE_E *c = &cases[i];
+
+        img_len  = Load(c->name, img);
+        body_len = Load(c->body, body);
+        hdr_len  = (uint32_t)img[14] | ((uint32_t)img[15] << 8);
+        for (uint16_t pkt = 128; pkt <= 1024U; pkt *= 8U)
+        {
+            Host_SnapshotRestore(empty);
+            Host_SenderLoad(img, img_len, pkt);
+            r = Host_Boot(1);
+            if (Accepted(c))
+            {
+                HOST_CHECK(r == HOST_JUMPED);
+                HOST_CHECK(host_stats->sent_all);
+                HOST_CHECK(host_stats->jump_addr == OTA_APP_A_ADDR + hdr_len);
+                HOST_CHECK(SlotAHolds(hdr_len, body_len));
+                booted++;
+            }
+            else
+            {
+                /* 拒绝后不跳转，留在 IAP 等待重新下载 */
+                HOST_CHECK(r == HOST_RETURNED);
+                HOST_CHECK(!SlotAHolds(hdr_len, body_len));
+                rejected++;
+            }
+        }
+    }
+    printf("v2 images (aes %d, sig %d): %u downloads booted, %u rejected\n",
+           OTA_AES_ENABLE, OTA_SIG_ENABLE, (unsigned)booted, (unsigned)rejected);
+
+#if OTA_REPAIR_ENABLE
+    TestRepair(empty);
+#endif
+    free(empty);
+
+    return Host_Report();
+}
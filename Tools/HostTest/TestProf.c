@@ -0,0 +1,125 @@
+/**
+ ******************************************************************************
+ * @file    TestProf.c
+ * @author  MiniOTA Team
+ * @brief   热路径耗时统计 (OTA_PROF_ENABLE) 的报告测试
+ *          同一源文件按两种日志配置编译 (见 Makefile):
+ *          - TestProf:      文本日志，OTA_LOG_LVL_INFO: 下载并启动后调试日志中应有各测量点的统计行与直方图，
+ *                           直方图各桶之和等于次数，单包 CRC 的次数等于数据包数
+ *          - TestProfQuiet: 令牌化日志，OTA_LOG_LVL_ERROR: 统计报告与链路报告均不输出，
+ *                           同一 ID 以 ERROR 等级输出时仍生成令牌帧
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 MiniOTA.
+ * All rights reserved.
+ *
+ ******************************************************************************
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "HostPort.h"
+#include "OtaLog.h"
+#include "OtaProf.h"
+
+#define BODY_SIZE   6000U
+
+static uint8_t img[16 + BODY_SIZE];
+
+#if OTA_LOG_LEVEL >= OTA_LOG_LVL_INFO
+/**
+ * @brief  解析文本日志中的统计报告
+ * @param  log: 日志
+ * @param  count: 输出各测量点的次数 (未输出的为 0)
+ * @param  hist: 输出各测量点直方图之和
+ * @return 统计行数
+ */
+static uint32_t ParseReport(const char *log, uint32_t *count, uint32_t *hist)
+{
+    const char *p;
+    uint32_t lines = 0;
+    unsigned a[6];
+
+    for (p = log; (p = strstr(p, "[OTA]:Prof ")) != NULL; p++)
+    {
+        if (sscanf(p, "[OTA]:Prof [point count min max mean] : %x %x %x %x %x",
+                   &a[0], &a[1], &a[2], &a[3], &a[4]) == 5 && a[0] < OTA_PROF_POINT_MAX)
+        {
+            count[a[0]] = a[1];
+            HOST_CHECK(a[2] <= a[4] && a[4] <= a[3]);
+            lines++;
+        }
+        else if (sscanf(p, "[OTA]:Prof hist [point bin n0 n1 n2 n3] : %x %x %x %x %x %x",
+                        &a[0], &a[1], &a[2], &a[3], &a[4], &a[5]) == 6 && a[0] < OTA_PROF_POINT_MAX)
+        {
+            hist[a[0]] += a[2] + a[3] + a[4] + a[5];
+        }
+    }
+    return lines;
+}
+#endif
+
+int main(void)
+{
+    uint32_t len;
+    const char *log;
+
+    Host_Init();
+    len = Host_MakeImage(img, BODY_SIZE, 1, 0x77);
+    Host_SenderLoad(img, len, 128);
+    HOST_CHECK(Host_Boot(1) == HOST_JUMPED);
+    log = Host_Log();
+    HOST_CHECK(host_stats->log_len < HOST_LOG_SIZE);
+
+#if OTA_LOG_LEVEL >= OTA_LOG_LVL_INFO
+    uint32_t count[OTA_PROF_POINT_MAX] = { 0 };
+    uint32_t hist[OTA_PROF_POINT_MAX] = { 0 };
+    uint32_t lines = ParseReport(log, count, hist);
+
+    HOST_CHECK(host_stats->log_len > 0);
+    HOST_CHECK(strstr(log, "[OTA]:Link [packets") != NULL);
+    HOST_CHECK(count[OTA_PROF_FLASH_PROGRAM] > 0);
+    HOST_CHECK(count[OTA_PROF_FLASH_VERIFY] == count[OTA_PROF_FLASH_PROGRAM]);
+    HOST_CHECK(count[OTA_PROF_PKT_CRC] == host_stats->packets);
+    HOST_CHECK(count[OTA_PROF_ACK_TURNAROUND] > 0);
+    HOST_CHECK(count[OTA_PROF_BOOT_CFG] > 0);
+    for (uint32_t i = 0; i < OTA_PROF_POINT_MAX; i++)
+    {
+        HOST_CHECK(hist[i] == count[i]);
+    }
+    printf("profiling report: %u points, %u packet CRCs, %u page programs\n",
+           (unsigned)lines, (unsigned)count[OTA_PROF_PKT_CRC], (unsigned)count[OTA_PROF_FLASH_PROGRAM]);
+#else
+    /* 等级被关闭: 既无文本也无令牌帧 (OTA_LOG_TOKEN_SYNC + ID) */
+    uint32_t frames = 0;
+
+    HOST_CHECK(strstr(log, "Prof") == NULL && strstr(log, "Link [") == NULL);
+    for (uint32_t i = 0; i + 1U < host_stats->log_len; i++)
+    {
+        uint8_t id = (uint8_t)log[i + 1U];
+
+        if ((uint8_t)log[i] == OTA_LOG_TOKEN_SYNC &&
+            (id == OTA_LOG_ID_PROF_STAT || id == OTA_LOG_ID_PROF_HIST ||
+             id == OTA_LOG_ID_LINK_XM || id == OTA_LOG_ID_LINK_UART))
+        {
+            frames++;
+        }
+    }
+    HOST_CHECK(frames == 0);
+
+    /* 同一 ID 以 ERROR 等级输出时仍生成令牌帧: 关闭的只是低于门限的等级 */
+    uint32_t args[5] = { OTA_PROF_PKT_CRC, 1, 2, 3, 2 };
+    uint32_t before = host_stats->log_len;
+
+    HOST_CHECK(OTA_LogIdArgs(OTA_LOG_LVL_INFO, OTA_LOG_ID_PROF_STAT, 5, args) == 0);
+    HOST_CHECK(host_stats->log_len == before);
+    HOST_CHECK(OTA_LogIdArgs(OTA_LOG_LVL_ERROR, OTA_LOG_ID_PROF_STAT, 5, args) == 1);
+    HOST_CHECK(host_stats->log_len == before + 3U + 5U * 4U);
+    HOST_CHECK((uint8_t)log[before] == OTA_LOG_TOKEN_SYNC && (uint8_t)log[before + 1U] == OTA_LOG_ID_PROF_STAT);
+    printf("log level %d: %u log bytes, no profiling or link report\n",
+           OTA_LOG_LEVEL, (unsigned)before);
+#endif
+
+    return Host_Report();
+}
@@ -0,0 +1,128 @@
+/**
+ ******************************************************************************
+ * @file    TestReloc.c
+ * @author  MiniOTA Team
+ * @brief   安装时重定位测试 (OTA_RELOC_ENABLE)
+ *          reloc.img 由 OtaRelocGen.py 生成的重定位表与 OtaImageGen.py --reloc 生成，以 0 为基址链接:
+ *          - 同一个固件先后下载到两个插槽，重定位项被加上 插槽地址 + 固件头长度，其余字节不变
+ *          - OTA_RelocCrc16 还原重定位的字后与原始固件的 CRC 一致，重定位量不符时不一致
+ *          - 插槽中的重定位字被改写后启动校验失败，回退到另一个插槽
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 MiniOTA.
+ * All rights reserved.
+ *
+ ******************************************************************************
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "HostPort.h"
+#include "OtaReloc.h"
+
+#define FILE_MAX    (16U * 1024U)
+#define HDR_LEN     0x100U          /* Makefile 中 IMG_reloc 的 --hdr-len */
+
+static const char *data_dir;
+static uint8_t img[FILE_MAX];
+static uint8_t body[FILE_MAX];
+static uint32_t img_len, body_len, count, table;
+
+/**
+ * @brief  读取数据目录中的文件
+ * @return 长度
+ */
+static uint32_t Load(const char *name, uint8_t *buf)
+{
+    char path[256];
+    uint32_t len;
+
+    snprintf(path, sizeof(path), "%s/%s", data_dir, name);
+    len = Host_LoadFile(path, buf, FILE_MAX);
+    HOST_CHECK(len > 0 && len < FILE_MAX);
+    return len;
+}
+
+/**
+ * @brief  第 idx 个重定位偏移
+ */
+static uint32_t RelocOff(uint32_t idx)
+{
+    uint32_t off;
+
+    memcpy(&off, &body[table + idx * 4U], 4);
+    return off;
+}
+
+/**
+ * @brief  检查插槽中的固件体: 重定位项为原值 + delta，其余字节与生成的固件相同
+ * @param  slot_addr: 插槽地址
+ */
+static void CheckSlot(uint32_t slot_addr)
+{
+    const uint8_t *slot = (const uint8_t *)(uintptr_t)(slot_addr + HDR_LEN);
+    uint32_t delta = slot_addr + HDR_LEN;
+    uint32_t pos = 0, off, word, expect, bad = 0;
+
+    for (uint32_t idx = 0; idx < count; idx++)
+    {
+        off = RelocOff(idx);
+        bad += (memcmp(slot + pos, body + pos, off - pos) != 0);
+        memcpy(&word, slot + off, 4);
+        memcpy(&expect, body + off, 4);
+        bad += (word != expect + delta);
+        pos = off + 4U;
+    }
+    bad += (memcmp(slot + pos, body + pos, body_len - pos) != 0);
+    HOST_CHECK(bad == 0);
+
+    /* 还原重定位字后的 CRC 与原始固件一致; 重定位量不符时不一致 */
+    HOST_CHECK(OTA_RelocCrc16(0, slot_addr + HDR_LEN, body_len, delta) == OTA_UpdateCrc16(0, body, body_len));
+    HOST_CHECK(OTA_RelocCrc16(0, slot_addr + HDR_LEN, body_len, delta + 4U) != OTA_UpdateCrc16(0, body, body_len));
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t first, second, off, word;
+
+    if (argc < 2)
+    {
+        printf("usage: %s <data dir>\n", argv[0]);
+        return 1;
+    }
+    data_dir = argv[1];
+    Host_Init();
+
+    img_len  = Load("reloc.img", img);
+    body_len = Load("reloc.bin", body);
+    HOST_CHECK(img_len == HDR_LEN + body_len);
+    memcpy(&count, &body[body_len - 8U], 4);
+    HOST_CHECK(count > 1U && count * 4U + 8U < body_len);
+    table = body_len - 8U - count * 4U;
+
+    /* 同一个固件先后写入两个插槽 */
+    Host_SenderLoad(img, img_len, 1024);
+    HOST_CHECK(Host_Boot(1) == HOST_JUMPED);
+    first = host_stats->jump_addr - HDR_LEN;
+    CheckSlot(first);
+
+    Host_SenderLoad(img, img_len, 128);
+    HOST_CHECK(Host_Boot(1) == HOST_JUMPED);
+    second = host_stats->jump_addr - HDR_LEN;
+    HOST_CHECK(second != first);
+    CheckSlot(second);
+    printf("reloc image: %u relocations applied at 0x%08X and 0x%08X\n",
+           (unsigned)count, (unsigned)first, (unsigned)second);
+
+    /* 重定位字被改写: 启动校验失败，回退到另一个插槽 */
+    off = RelocOff(count / 2U);
+    memcpy(&word, (const void *)(uintptr_t)(second + HDR_LEN + off), 4);
+    word += 4U;
+    memcpy((void *)(uintptr_t)(second + HDR_LEN + off), &word, 4);
+    Host_SenderLoad(NULL, 0, 1024);
+    HOST_CHECK(Host_Boot(0) == HOST_JUMPED);
+    HOST_CHECK(host_stats->jump_addr == first + HDR_LEN);
+
+    return Host_Report();
+}
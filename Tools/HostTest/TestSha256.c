@@ -0,0 +1,142 @@
+/**
+ ******************************************************************************
+ * @file    TestSha256.c
+ * @author  MiniOTA Team
+ * @brief   SHA-256 测试
+ *          - FIPS 180-4 (NIST CSHS 示例) 测试向量，含单分组、双分组、空消息与一百万个 'a'
+ *          - 按 Xmodem 包拆分输入与一次输入的结果一致 (每个拆分点)
+ *          - 主机上按包长 1024 输入的每字节周期数
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 MiniOTA.
+ * All rights reserved.
+ *
+ ******************************************************************************
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "HostPort.h"
+#include "OtaSha256.h"
+
+#define BENCH_SIZE      (1024U * 1024U)
+#define BENCH_ROUNDS    8U
+
+/**
+ * @brief 测试向量
+ */
+typedef struct
+{
+    const char *msg;
+    uint32_t    repeat;     /**< msg 重复次数 */
+    const char *digest;     /**< 十六进制摘要 */
+} SHA_VECTOR_E;
+
+static const SHA_VECTOR_E vectors[] =
+{
+    { "abc", 1,
+      "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad" },
+    { "", 1,
+      "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855" },
+    { "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq", 1,
+      "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1" },
+    { "a", 1000000,
+      "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0" },
+};
+
+/**
+ * @brief  摘要是否与十六进制字符串一致
+ */
+static int DigestIs(const uint8_t digest[OTA_SHA256_DIGEST_SIZE], const char *hex)
+{
+    char out[2U * OTA_SHA256_DIGEST_SIZE + 1U];
+
+    for (uint32_t i = 0; i < OTA_SHA256_DIGEST_SIZE; i++)
+    {
+        sprintf(&out[2U * i], "%02x", digest[i]);
+    }
+    return strcmp(out, hex) == 0;
+}
+
+/**
+ * @brief  一次输入整段数据计算摘要
+ */
+static void Sha256(const uint8_t *data, uint32_t len, uint8_t digest[OTA_SHA256_DIGEST_SIZE])
+{
+    OTA_SHA256_CTX_E ctx;
+
+    OTA_Sha256Init(&ctx);
+    OTA_Sha256Update(&ctx, data, len);
+    OTA_Sha256Final(&ctx, digest);
+}
+
+int main(void)
+{
+    OTA_SHA256_CTX_E ctx;
+    uint8_t digest[OTA_SHA256_DIGEST_SIZE];
+    uint8_t whole[OTA_SHA256_DIGEST_SIZE];
+    uint8_t msg[300];
+    uint8_t *buf;
+    uint64_t t0, cycles;
+
+    /* FIPS 180-4 测试向量: 重复的消息逐段输入 */
+    for (uint32_t v = 0; v < sizeof(vectors) / sizeof(vectors[0]); v++)
+    {
+        OTA_Sha256Init(&ctx);
+        for (uint32_t i = 0; i < vectors[v].repeat; i++)
+        {
+            OTA_Sha256Update(&ctx, (const uint8_t *)vectors[v].msg, (uint32_t)strlen(vectors[v].msg));
+        }
+        OTA_Sha256Final(&ctx, digest);
+        HOST_CHECK(DigestIs(digest, vectors[v].digest));
+    }
+
+    /* 一百万个 'a' 一次输入 */
+    buf = malloc(BENCH_SIZE);
+    memset(buf, 'a', 1000000U);
+    Sha256(buf, 1000000U, digest);
+    HOST_CHECK(DigestIs(digest, vectors[3].digest));
+
+    /* 分组边界附近的各种长度，每个拆分点分两次输入，结果应与一次输入一致 */
+    for (uint32_t i = 0; i < sizeof(msg); i++)
+    {
+        msg[i] = (uint8_t)(i * 7U + 3U);
+    }
+    for (uint32_t len = 0; len <= sizeof(msg); len += (len < 140U) ? 1U : 53U)
+    {
+        Sha256(msg, len, whole);
+        for (uint32_t split = 0; split <= len; split++)
+        {
+            OTA_Sha256Init(&ctx);
+            OTA_Sha256Update(&ctx, msg, split);
+            OTA_Sha256Update(&ctx, msg + split, len - split);
+            OTA_Sha256Final(&ctx, digest);
+            HOST_CHECK(memcmp(digest, whole, sizeof(digest)) == 0);
+        }
+    }
+
+    /* 基准: 1MB 按 Xmodem 包长 1024 逐包输入，取多轮中最快的一次 */
+    for (uint32_t i = 0; i < BENCH_SIZE; i++)
+    {
+        buf[i] = (uint8_t)(i ^ (i >> 8));
+    }
+    cycles = UINT64_MAX;
+    for (uint32_t r = 0; r < BENCH_ROUNDS; r++)
+    {
+        t0 = Host_Cycles();
+        OTA_Sha256Init(&ctx);
+        for (uint32_t off = 0; off < BENCH_SIZE; off += 1024U)
+        {
+            OTA_Sha256Update(&ctx, buf + off, 1024U);
+        }
+        OTA_Sha256Final(&ctx, digest);
+        t0 = Host_Cycles() - t0;
+        cycles = (t0 < cycles) ? t0 : cycles;
+    }
+    printf("sha256 %u KB in 1024-byte updates: %.1f cycles/byte (host)\n",
+           (unsigned)(BENCH_SIZE / 1024U), (double)cycles / BENCH_SIZE);
+    free(buf);
+
+    return Host_Report();
+}
@@ -0,0 +1,282 @@
+/**
+ ******************************************************************************
+ * @file    TestSlots.c
+ * @author  MiniOTA Team
+ * @brief   N 插槽 (OTA_SLOT_NUM=4) 的目标选择与分区表测试
+ *          同一源文件按两种选择策略编译 (见 Makefile):
+ *          - TestSlots:    OTA_SLOT_SELECT_POLICY 0，最久未写入 (LRU)
+ *          - TestSlotsVer: OTA_SLOT_SELECT_POLICY 1，版本号最低
+ *          内容:
+ *          - 空插槽按编号优先; 之后按策略选出的插槽与测试中的模型一致，当前启动的插槽从不被选中
+ *          - 当前插槽校验失败时回退到版本号最高的已验证插槽，无效插槽在下一次升级时优先
+ *          - seq_num 与 slot_seq 跨越 0xFFFFFFFF 回绕后 LRU 顺序不变
+ *          - 分区表: 合法的表启用后按表中地址下载; 缺插槽、重复、重叠、越界、未对齐、
+ *            用途未知等表被 OTA_PartSave 拒绝; Meta 页中损坏的表被忽略，使用默认布局
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 MiniOTA.
+ * All rights reserved.
+ *
+ ******************************************************************************
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "HostPort.h"
+#include "OtaMeta.h"
+
+#define BODY_SIZE   1500U
+#define NONE        0xFFU
+#define SLOT_C      ((OTA_ACIVE_SLOT_E)2)
+#define SLOT_D      ((OTA_ACIVE_SLOT_E)3)
+
+static uint8_t img[16 + BODY_SIZE];
+
+/* 模型: 各插槽的写入次序与版本号，当前启动的插槽 */
+static uint32_t model_seq[OTA_SLOT_NUM];
+static uint32_t model_ver[OTA_SLOT_NUM];
+static uint8_t  model_ok[OTA_SLOT_NUM];
+static uint8_t  model_boot = NONE;
+static uint32_t model_count;
+
+/**
+ * @brief  按模型计算下一次升级的目标插槽
+ */
+static uint8_t ModelIapSlot(void)
+{
+    uint8_t best = NONE;
+
+    for (uint8_t s = 0; s < OTA_SLOT_NUM; s++)
+    {
+        if (s == model_boot)
+        {
+            continue;
+        }
+        if (!model_ok[s])
+        {
+            return s;
+        }
+#if OTA_SLOT_SELECT_POLICY
+        if (best == NONE || model_ver[s] < model_ver[best])
+#else
+        if (best == NONE || model_seq[s] < model_seq[best])
+#endif
+        {
+            best = s;
+        }
+    }
+    return best;
+}
+
+/**
+ * @brief  由跳转地址得到插槽编号
+ */
+static uint8_t JumpSlot(void)
+{
+    for (uint8_t s = 0; s < OTA_SLOT_NUM; s++)
+    {
+        if (host_stats->jump_addr == OTA_MetaSlotAddr((OTA_ACIVE_SLOT_E)s) + 16U)
+        {
+            return s;
+        }
+    }
+    return NONE;
+}
+
+/**
+ * @brief  下载一个固件，检查写入的插槽与模型一致并更新模型
+ * @param  version: 版本号
+ * @return 写入的插槽
+ */
+static uint8_t Download(uint32_t version)
+{
+    uint8_t expect = ModelIapSlot();
+    uint8_t slot;
+    uint32_t len = Host_MakeImage(img, BODY_SIZE, version, (uint8_t)version);
+
+    Host_SenderLoad(img, len, 1024);
+    HOST_CHECK(Host_Boot(1) == HOST_JUMPED);
+    slot = JumpSlot();
+    HOST_CHECK(slot == expect);
+    if (slot < OTA_SLOT_NUM)
+    {
+        model_seq[slot] = ++model_count;
+        model_ver[slot] = version;
+        model_ok[slot]  = 1;
+        model_boot      = slot;
+    }
+    return slot;
+}
+
+/**
+ * @brief  直接检查 OTA_MetaGetIapSlot: 空插槽与无效插槽优先，启动插槽即使最旧也不被选中
+ */
+static void TestIapSlotRules(void)
+{
+    OTA_META_DATA_E meta;
+
+    OTA_MetaInit(&meta);
+    for (uint8_t s = 0; s < OTA_SLOT_NUM; s++)
+    {
+        meta.slot_status[s] = SLOT_STATE_VALID;
+    }
+    meta.seq_num     = 1;
+    meta.slot_seq[0] = 0xFFFFFFFEUL;        /* 回绕前写入的插槽最旧 */
+    meta.slot_seq[1] = 0xFFFFFFFFUL;
+    meta.slot_seq[2] = 0;
+    meta.slot_seq[3] = 1;
+    meta.active_slot = SLOT_D;
+#if !OTA_SLOT_SELECT_POLICY
+    HOST_CHECK(OTA_MetaGetIapSlot(&meta) == SLOT_A);
+    meta.active_slot = SLOT_A;              /* 最旧的插槽正在启动: 选次旧的 */
+    HOST_CHECK(OTA_MetaGetIapSlot(&meta) == SLOT_B);
+#endif
+    meta.slot_status[2] = SLOT_STATE_INVALID;
+    HOST_CHECK(OTA_MetaGetIapSlot(&meta) == SLOT_C);
+    meta.slot_status[3] = SLOT_STATE_EMPTY;
+    HOST_CHECK(OTA_MetaGetIapSlot(&meta) == SLOT_C);
+    meta.active_slot = SLOT_C;
+    meta.slot_status[2] = SLOT_STATE_VALID;
+    HOST_CHECK(OTA_MetaGetIapSlot(&meta) == SLOT_D);
+}
+
+/**
+ * @brief  保存分区表，返回 OTA_PartSave 的结果
+ */
+static int SaveTable(const OTA_PART_ENTRY_E *entry, uint16_t count)
+{
+    OTA_PART_TABLE_E table;
+
+    memset(&table, 0xFF, sizeof(table));
+    table.count = count;
+    memcpy(table.entry, entry, count * sizeof(OTA_PART_ENTRY_E));
+    return OTA_PartSave(&table);
+}
+
+/**
+ * @brief  分区表的启用与拒绝
+ * @param  empty: 空片快照
+ */
+static void TestPartTable(const uint8_t *empty)
+{
+    /* 大小不同的 4 个插槽与一个数据分区 (偏移相对 Flash 起始，Meta 位于 0x3000) */
+    static const OTA_PART_ENTRY_E good[5] =
+    {
+        { 0x3400, 0x2000, 0, 0, { 0 } },
+        { 0x5400, 0x1800, 1, 0, { 0 } },
+        { 0x6C00, 0x2000, 2, 0, { 0 } },
+        { 0x8C00, 0x2400, 3, 0, { 0 } },
+        { 0xB000, 0x1000, OTA_PART_ROLE_DATA, 0, { 0 } },
+    };
+    OTA_PART_ENTRY_E bad[5];
+    uint32_t reject = 0;
+    uint8_t *meta_page = (uint8_t *)(uintptr_t)OTA_META_ADDR;
+
+    /* 每种非法表: 以合法表为基础改动一处 */
+    for (int c = 0; c < 9; c++)
+    {
+        uint16_t count = 5;
+
+        memcpy(bad, good, sizeof(bad));
+        switch (c)
+        {
+        case 0: count = 4; bad[3] = good[4]; break;         /* 缺少插槽 3 */
+        case 1: bad[3].role = 2; break;                     /* 插槽 2 重复 */
+        case 2: bad[1].offset = 0x5000; break;              /* 与插槽 0 重叠 */
+        case 3: bad[0].offset = 0x3000; bad[0].size = 0x2400; break;    /* 占用 Meta 页 */
+        case 4: bad[4].offset = 0xF800; break;              /* 超出 Flash */
+        case 5: bad[2].size = 0x1F00; break;                /* 结束地址不在页边界 */
+        case 6: bad[4].role = 0x20; break;                  /* 未知用途 */
+        case 7: bad[1].flags = OTA_PART_FLAG_EXT; break;    /* 未使能外部暂存 */
+        default: bad[2].size = 0; break;                    /* 空分区 */
+        }
+        if (SaveTable(bad, count) != 0)
+        {
+            reject++;
+        }
+        HOST_CHECK(OTA_PartLoad() == OTA_PART_DEFAULT);
+    }
+    HOST_CHECK(reject == 9U);
+
+    /* 合法的表: 按表中的地址依次下载到 4 个插槽 */
+    HOST_CHECK(SaveTable(good, 5) == 0);
+    HOST_CHECK(OTA_PartLoad() == OTA_PART_LOADED);
+    for (uint8_t s = 0; s < OTA_SLOT_NUM; s++)
+    {
+        HOST_CHECK(OTA_MetaSlotAddr((OTA_ACIVE_SLOT_E)s) == OTA_FLASH_START_ADDRESS + good[s].offset);
+        HOST_CHECK(OTA_MetaSlotSize((OTA_ACIVE_SLOT_E)s) == good[s].size);
+        HOST_CHECK(Download(100U + s) == s);
+    }
+
+    /* Meta 页中的表损坏 (CRC 不符): 忽略并使用默认布局 */
+    Host_SnapshotRestore(empty);
+    memset(model_ok, 0, sizeof(model_ok));
+    model_boot = NONE;
+    HOST_CHECK(SaveTable(good, 5) == 0);
+    meta_page[OTA_PART_TABLE_OFFSET + 8U + 4U] ^= 0x04U;
+    HOST_CHECK(OTA_PartLoad() == OTA_PART_INVALID);
+    HOST_CHECK(OTA_MetaSlotAddr(SLOT_B) == OTA_APP_A_ADDR + OTA_APP_SLOT_SIZE);
+    HOST_CHECK(Download(200) == SLOT_A);
+    HOST_CHECK(Download(201) == SLOT_B);
+    HOST_CHECK(host_stats->jump_addr == OTA_APP_A_ADDR + OTA_APP_SLOT_SIZE + 16U);
+}
+
+int main(void)
+{
+    OTA_META_DATA_E meta;
+    uint8_t *empty;
+    uint8_t *slot;
+    uint32_t shift;
+
+    Host_Init();
+    empty = Host_SnapshotSave();
+    TestIapSlotRules();
+
+    /* 空插槽按编号依次写入; 第一个插槽的版本号最高，LRU 与版本策略的选择因此不同 */
+    HOST_CHECK(Download(10) == SLOT_A);
+    HOST_CHECK(Download(2) == SLOT_B);
+    HOST_CHECK(Download(3) == SLOT_C);
+    HOST_CHECK(Download(4) == SLOT_D);
+
+    /* 当前插槽损坏: 回退到版本号最高的已验证插槽 (而不是最近写入的插槽 C) */
+    slot = (uint8_t *)(uintptr_t)OTA_MetaSlotAddr(SLOT_D);
+    slot[100] ^= 0x01U;
+    Host_SenderLoad(NULL, 0, 1024);
+    HOST_CHECK(Host_Boot(0) == HOST_JUMPED);
+    HOST_CHECK(JumpSlot() == SLOT_A);
+    model_ok[SLOT_D] = 0;
+    model_boot = SLOT_A;
+
+    /* 无效插槽优先，之后按策略选择 */
+    HOST_CHECK(Download(5) == SLOT_D);
+    for (uint32_t v = 6; v < 12U; v++)
+    {
+        Download(v);
+    }
+
+    /* 序列号回绕: 整体平移到 0xFFFFFFFF 之前，LRU 顺序应延续 */
+    HOST_CHECK(OTA_MetaLoad(&meta) == OTA_TRUE);
+    shift = 0xFFFFFFFEUL - meta.seq_num;
+    meta.seq_num += shift;
+    for (uint8_t s = 0; s < OTA_SLOT_NUM; s++)
+    {
+        meta.slot_seq[s] += shift;
+    }
+    HOST_CHECK(OTA_MetaSave(&meta) == 0);
+    for (uint32_t v = 12; v < 20U; v++)
+    {
+        Download(v);
+    }
+    HOST_CHECK(OTA_MetaLoad(&meta) == OTA_TRUE && meta.seq_num < 8U);
+    printf("%u downloads across seq_num wraparound (policy %d)\n",
+           (unsigned)model_count, OTA_SLOT_SELECT_POLICY);
+
+    Host_SnapshotRestore(empty);
+    memset(model_ok, 0, sizeof(model_ok));
+    model_boot = NONE;
+    TestPartTable(empty);
+    free(empty);
+
+    return Host_Report();
+}
@@ -0,0 +1,113 @@
+/**
+ ******************************************************************************
+ * @file    TestSpiNor.c
+ * @author  MiniOTA Team
+ * @brief   SPI NOR 暂存分区测试 (OTA_EXT_STAGING)
+ *          经 Xmodem 下载到外部 SPI NOR 后安装到 Slot A; 在下载与安装的每个擦写点断电 (含 Meta 页)，
+ *          重新启动后应启动 Slot A 中完整的旧固件或新固件
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 MiniOTA.
+ * All rights reserved.
+ *
+ ******************************************************************************
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "HostPort.h"
+#include "OtaMeta.h"
+
+#define BODY_SIZE   6000U
+
+static uint8_t img1[16 + BODY_SIZE];
+static uint8_t img2[16 + BODY_SIZE];
+static uint8_t img3[16 + BODY_SIZE];
+
+/**
+ * @brief  Slot A 中是否为指定固件
+ */
+static int SlotAHolds(const uint8_t *img, uint32_t len)
+{
+    return memcmp((const void *)(uintptr_t)OTA_APP_A_ADDR, img, len) == 0;
+}
+
+int main(void)
+{
+    OTA_META_DATA_E meta;
+    uint32_t len1, len2, len3, ops, torn = 0, in_meta = 0;
+    uint8_t *snap;
+    HOST_BOOT_RESULT_E r;
+
+    Host_Init();
+    len1 = Host_MakeImage(img1, BODY_SIZE, 1, 0x11);
+    len2 = Host_MakeImage(img2, BODY_SIZE, 2, 0x22);
+    len3 = Host_MakeImage(img3, BODY_SIZE, 3, 0x33);
+
+    /* 空片: 同样经暂存分区安装到 Slot A */
+    Host_SenderLoad(img1, len1, 128);
+    r = Host_Boot(1);
+    HOST_CHECK(r == HOST_JUMPED);
+    HOST_CHECK(SlotAHolds(img1, len1));
+
+    /* 升级: 下载到 SPI NOR 暂存分区，校验后安装到 Slot A */
+    Host_SenderLoad(img2, len2, 1024);
+    r = Host_Boot(1);
+    HOST_CHECK(r == HOST_JUMPED);
+    HOST_CHECK(host_stats->sent_all);
+    HOST_CHECK(host_stats->nor_erase == (len2 + 4095U) / 4096U);
+    HOST_CHECK(host_stats->nor_prog >= (len2 + 255U) / 256U);
+    HOST_CHECK(host_stats->nor_violation == 0);
+    HOST_CHECK(memcmp(Host_NorArray() + OTA_EXT_STAGING_OFFSET, img2, len2) == 0);
+    HOST_CHECK(SlotAHolds(img2, len2));
+    HOST_CHECK(host_stats->jump_addr == OTA_APP_A_ADDR + 16U);
+    printf("stage+install %u bytes: nor erase %u prog %u, int erase %u, flash busy %.1f ms\n",
+           (unsigned)len2, (unsigned)host_stats->nor_erase, (unsigned)host_stats->nor_prog,
+           (unsigned)host_stats->erase, host_stats->busy_us / 1000.0);
+
+    /* 已安装的固件正常启动，不再安装 */
+    r = Host_Boot(0);
+    HOST_CHECK(r == HOST_JUMPED);
+    HOST_CHECK(host_stats->nor_erase == 0 && host_stats->nor_prog == 0);
+    HOST_CHECK(SlotAHolds(img2, len2));
+
+    /* 安装中途断电: 先完整运行一次得到 Flash 操作总数，再在各个位置断电 */
+    snap = Host_SnapshotSave();
+    Host_SenderLoad(img3, len3, 1024);
+    r = Host_Boot(1);
+    HOST_CHECK(r == HOST_JUMPED && SlotAHolds(img3, len3));
+    ops = host_stats->erase + host_stats->prog;
+    for (uint32_t cut = 1; cut <= ops; cut++)
+    {
+        Host_SnapshotRestore(snap);
+        Host_SenderLoad(img3, len3, 1024);
+        Host_PowerCutAt(cut);
+        r = Host_Boot(1);
+        HOST_CHECK(r == HOST_POWER_CUT);
+        if (!SlotAHolds(img2, len2) && !SlotAHolds(img3, len3))
+        {
+            torn++;
+        }
+        if ((host_stats->cut_addr & ~(OTA_FLASH_PAGE_SIZE - 1U)) == OTA_META_ADDR)
+        {
+            in_meta++;
+        }
+
+        /* 重新上电 (不进入 IAP): 暂存分区已标记时继续安装，否则仍运行旧固件;
+           断在 Meta 页的擦写中时同样应启动完整的旧固件或新固件 */
+        Host_SenderLoad(NULL, 0, 128);
+        r = Host_Boot(0);
+        HOST_CHECK(host_stats->nor_violation == 0);
+        HOST_CHECK(r == HOST_JUMPED && host_stats->jump_addr == OTA_APP_A_ADDR + 16U);
+        HOST_CHECK(SlotAHolds(img2, len2) || SlotAHolds(img3, len3));
+        HOST_CHECK(OTA_MetaLoad(&meta) == OTA_TRUE);
+    }
+    HOST_CHECK(torn > 0);
+    HOST_CHECK(in_meta > 0);
+    printf("power cut during install: %u cut points, %u left Slot A torn, %u in Meta\n",
+           (unsigned)ops, (unsigned)torn, (unsigned)in_meta);
+    free(snap);
+
+    return Host_Report();
+}
@@ -0,0 +1,123 @@
+/**
+ ******************************************************************************
+ * @file    TestSwap.c
+ * @author  MiniOTA Team
+ * @brief   交换安装测试 (OTA_SWAP_INSTALL)
+ *          - 按模拟的 Flash 时序统计交换每页的耗时
+ *          - 在交换的各个擦写点断电 (含恢复过程中再次断电，以及断在 Meta 页的擦写中)，
+ *            重新上电后应从进度页记录处继续，启动 Slot A 中完整的新固件或旧固件
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 MiniOTA.
+ * All rights reserved.
+ *
+ ******************************************************************************
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "HostPort.h"
+#include "OtaMeta.h"
+
+static uint8_t img1[16 + 7000];
+static uint8_t img2[16 + 6000];
+static uint32_t len1, len2;
+
+/**
+ * @brief  插槽中是否为指定固件
+ */
+static int SlotHolds(uint32_t addr, const uint8_t *img, uint32_t len)
+{
+    return memcmp((const void *)(uintptr_t)addr, img, len) == 0;
+}
+
+/**
+ * @brief  交换完成: A 为新固件，B 为旧固件
+ */
+static int SwapDone(void)
+{
+    return SlotHolds(OTA_APP_A_ADDR, img2, len2) && SlotHolds(OTA_APP_B_ADDR, img1, len1);
+}
+
+/**
+ * @brief  断电后重新上电 (不进入 IAP)，检查交换是否完成
+ *         每个断电点 (含断在 Meta 页的擦写中) 都应启动完整的固件: 交换完成时为新固件，
+ *         否则为 Slot A 中的旧固件; 之后 Meta 有效，Slot A 已确认
+ * @return 1: 启动新固件, 0: 启动旧固件
+ */
+static int CheckRecovery(void)
+{
+    OTA_META_DATA_E meta;
+    HOST_BOOT_RESULT_E r = Host_Boot(0);
+    int done = SwapDone();
+
+    HOST_CHECK(r == HOST_JUMPED);
+    HOST_CHECK(host_stats->jump_addr == OTA_APP_A_ADDR + 16U);
+    HOST_CHECK(done || SlotHolds(OTA_APP_A_ADDR, img1, len1));
+    HOST_CHECK(OTA_MetaLoad(&meta) == OTA_TRUE && meta.slot_status[SLOT_A] == SLOT_STATE_VALID);
+    return done;
+}
+
+int main(void)
+{
+    OTA_META_DATA_E meta;
+    uint8_t *staged;
+    uint32_t ops, pages, cuts = 0, swapped = 0;
+    HOST_BOOT_RESULT_E r;
+
+    Host_Init();
+    len1 = Host_MakeImage(img1, sizeof(img1) - 16U, 1, 0x11);
+    len2 = Host_MakeImage(img2, sizeof(img2) - 16U, 2, 0x22);
+
+    /* 空片: 下载 v1 */
+    Host_SenderLoad(img1, len1, 1024);
+    r = Host_Boot(1);
+    HOST_CHECK(r == HOST_JUMPED);
+    HOST_CHECK(SlotHolds(OTA_APP_A_ADDR, img1, len1));
+
+    /* 构造待安装状态: v2 位于 Slot B 并标记为待确认 (相当于下载完成、尚未开始交换) */
+    memcpy((void *)(uintptr_t)OTA_APP_B_ADDR, img2, len2);
+    HOST_CHECK(OTA_MetaLoad(&meta) == OTA_TRUE);
+    OTA_MetaMarkPending(&meta, SLOT_B);
+    memcpy((void *)(uintptr_t)OTA_META_ADDR, &meta, sizeof(meta));
+    staged = Host_SnapshotSave();
+
+    /* 完整交换一次，按模拟时序统计每页耗时 */
+    r = Host_Boot(0);
+    HOST_CHECK(r == HOST_JUMPED);
+    HOST_CHECK(SwapDone());
+    ops = host_stats->erase + host_stats->prog;
+    pages = (len1 + OTA_FLASH_PAGE_SIZE - 1U) / OTA_FLASH_PAGE_SIZE;
+    printf("swap %u pages: %u erases, %u halfword programs, %.1f ms flash busy, %.2f ms/page\n",
+           (unsigned)pages, (unsigned)host_stats->erase, (unsigned)host_stats->prog,
+           host_stats->busy_us / 1000.0, host_stats->busy_us / 1000.0 / pages);
+    /* 每页三次擦除，另有进度页与 Meta 页 */
+    HOST_CHECK(host_stats->erase <= 3U * pages + 4U);
+
+    /* 在交换的各个擦写点断电: 开头的进度页擦除与交换头逐个覆盖，之后每隔 11 次操作 */
+    for (uint32_t cut = 1; cut <= ops; cut += (cut < 64U) ? 1U : 11U)
+    {
+        Host_SnapshotRestore(staged);
+        Host_PowerCutAt(cut);
+        HOST_CHECK(Host_Boot(0) == HOST_POWER_CUT);
+        swapped += CheckRecovery();
+        cuts++;
+    }
+
+    /* 恢复过程中再次断电 */
+    for (uint32_t cut = 5; cut <= ops; cut += 397)
+    {
+        Host_SnapshotRestore(staged);
+        Host_PowerCutAt(cut);
+        HOST_CHECK(Host_Boot(0) == HOST_POWER_CUT);
+        Host_PowerCutAt(1U + cut % 300U);
+        Host_Boot(0);
+        swapped += CheckRecovery();
+        cuts++;
+    }
+    printf("power cut during swap: %u cut points, %u booted the new image\n", (unsigned)cuts, (unsigned)swapped);
+    free(staged);
+
+    return Host_Report();
+}
@@ -0,0 +1,51 @@
+/**
+ ******************************************************************************
+ * @file    TestXmodem.c
+ * @author  MiniOTA Team
+ * @brief   Xmodem 接收结束处理测试
+ *          最后一页在 EOT 之后由 Flash 提交任务写入: 写入失败时应以 CAN 代替对 EOT 的应答，
+ *          插槽不被标记为待确认; 重新下载后正常启动
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026 MiniOTA.
+ * All rights reserved.
+ *
+ ******************************************************************************
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "HostPort.h"
+
+#define BODY_SIZE   6000U
+
+static uint8_t img[16 + BODY_SIZE];
+
+int main(void)
+{
+    uint32_t len, last_page;
+
+    Host_Init();
+    len = Host_MakeImage(img, BODY_SIZE, 1, 0x5C);
+    last_page = OTA_APP_A_ADDR + ((len - 1U) & ~(uint32_t)(OTA_FLASH_PAGE_SIZE - 1U));
+
+    /* 最后一页中的一个半字编程失败 */
+    Host_SenderLoad(img, len, 1024);
+    Host_ProgFailAt(last_page + 2U);
+    HOST_CHECK(Host_Boot(1) != HOST_JUMPED);
+    HOST_CHECK(host_stats->sent_all == 0);
+    HOST_CHECK(host_stats->cancels > 0);
+
+    /* 不进入 IAP 上电: 没有待确认的固件可启动，停在 IAP 等待下载 */
+    Host_SenderLoad(NULL, 0, 1024);
+    HOST_CHECK(Host_Boot(0) == HOST_RETURNED);
+
+    /* 重新下载 */
+    Host_SenderLoad(img, len, 1024);
+    HOST_CHECK(Host_Boot(1) == HOST_JUMPED);
+    HOST_CHECK(host_stats->sent_all);
+    HOST_CHECK(memcmp((const void *)(uintptr_t)OTA_APP_A_ADDR, img, len) == 0);
+
+    return Host_Report();
+}
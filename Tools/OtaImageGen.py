@@ -0,0 +1,486 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+MiniOTA v2 固件头生成工具
+
+为 bin 添加 v2 固件头 (魔数 "BLA2" + TLV 扩展区)，可选写入链接地址、入口偏移、
+特性标志、SHA-256 摘要、Ed25519 签名与分块 CRC 表; 也可根据 Bootloader 输出的损坏分块序号，
+从完整固件中取出这些分块生成修复流 (Bootloader 需使能 OTA_REPAIR_ENABLE)。
+
+--encrypt 用 AES-128-CTR 加密传输的固件体 (Bootloader 需使能 OTA_AES_ENABLE): 固件头带随机的
+初始计数块，CRC、摘要与签名仍按明文计算; --aes-keygen 生成 16 字节密钥文件并输出 OTA_AES_KEY。
+加密固件的修复流同样加密，生成时需给出同一密钥。
+
+签名覆盖整个固件头 (img_crc16 与签名值按 0 计算)，固件头中的摘要再覆盖固件体;
+--keygen 生成 32 字节私钥种子文件，并输出填入 OTA_SIG_PUBKEY 的公钥。
+
+输入为 Intel HEX 或 ELF (.axf) 时按其中的地址生成分段固件: 只传输各段的数据，
+不小于 --min-gap 的空隙不传输，由 Bootloader 在插槽中写为 0xFF; 链接地址取最低的段地址。
+
+用法:
+    python OtaImageGen.py app.bin 3 app_v2.img --hdr-len 0x100 --load-addr 0x08003500 --chunk-size 1024 --hash
+    python OtaImageGen.py app.hex 3 app_v2.img --hdr-len 0x100
+    python OtaImageGen.py --keygen ota.key
+    python OtaImageGen.py app.bin 3 app_v2.img --sign ota.key
+    python OtaImageGen.py --repair 2,7 app_v2.img app_repair.img
+    python OtaImageGen.py --aes-keygen ota.aes
+    python OtaImageGen.py app.bin 3 app_v2.img --sign ota.key --encrypt ota.aes
+"""
+
+import argparse
+import hashlib
+import os
+import struct
+import sys
+
+MAGIC_V2 = 0x32414C42
+HDR_MAX = 256
+
+TLV_LOAD_ADDR = 0x01
+TLV_ENTRY = 0x02
+TLV_HASH = 0x03
+TLV_CHUNKS = 0x04
+TLV_SIGNATURE = 0x05
+TLV_IV = 0x06
+TLV_FLAGS = 0x81
+TLV_REPAIR = 0x82
+TLV_SEGMENTS = 0x83
+
+FLAG_RELOC = 0x00000001
+FLAG_ENCRYPTED = 0x00000008
+FLAG_SEGMENTED = 0x00000010
+
+
+def crc16(data, crc=0):
+    """XMODEM CRC16，与 OTA_UpdateCrc16 一致"""
+    for b in data:
+        crc ^= b << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+# Ed25519 (RFC 8032)，只在生成固件时签名一次，直接按定义计算
+ED_P = 2 ** 255 - 19
+ED_L = 2 ** 252 + 27742317777372353535851937790883648493
+ED_D = -121665 * pow(121666, ED_P - 2, ED_P) % ED_P
+
+
+def ed_add(a, b):
+    """扩展坐标点加法"""
+    x1, y1, z1, t1 = a
+    x2, y2, z2, t2 = b
+    pa = (y1 - x1) * (y2 - x2) % ED_P
+    pb = (y1 + x1) * (y2 + x2) % ED_P
+    pc = t1 * 2 * ED_D * t2 % ED_P
+    pd = z1 * 2 * z2 % ED_P
+    e, f, g, h = pb - pa, pd - pc, pd + pc, pb + pa
+    return e * f % ED_P, g * h % ED_P, f * g % ED_P, e * h % ED_P
+
+
+def ed_mul(k, pt):
+    q = (0, 1, 1, 0)
+    while k:
+        if k & 1:
+            q = ed_add(q, pt)
+        pt = ed_add(pt, pt)
+        k >>= 1
+    return q
+
+
+def ed_encode(pt):
+    x, y, z, _ = pt
+    zi = pow(z, ED_P - 2, ED_P)
+    x, y = x * zi % ED_P, y * zi % ED_P
+    return (y | ((x & 1) << 255)).to_bytes(32, "little")
+
+
+def ed_base():
+    y = 4 * pow(5, ED_P - 2, ED_P) % ED_P
+    u, v = (y * y - 1) % ED_P, (ED_D * y * y + 1) % ED_P
+    x = u * pow(v, 3, ED_P) * pow(u * pow(v, 7, ED_P), (ED_P - 5) // 8, ED_P) % ED_P
+    if (v * x * x - u) % ED_P:
+        x = x * pow(2, (ED_P - 1) // 4, ED_P) % ED_P
+    if x & 1:
+        x = ED_P - x
+    return x, y, 1, x * y % ED_P
+
+
+def ed_secret(seed):
+    h = hashlib.sha512(seed).digest()
+    a = int.from_bytes(h[:32], "little") & ((1 << 254) - 8) | (1 << 254)
+    return a, h[32:]
+
+
+def ed_public(seed):
+    return ed_encode(ed_mul(ed_secret(seed)[0], ed_base()))
+
+
+def ed_sign(seed, msg):
+    a, prefix = ed_secret(seed)
+    pub = ed_encode(ed_mul(a, ed_base()))
+    r = int.from_bytes(hashlib.sha512(prefix + msg).digest(), "little") % ED_L
+    big_r = ed_encode(ed_mul(r, ed_base()))
+    k = int.from_bytes(hashlib.sha512(big_r + pub + msg).digest(), "little") % ED_L
+    return big_r + ((r + k * a) % ED_L).to_bytes(32, "little")
+
+
+def read_key(path):
+    with open(path, "rb") as f:
+        seed = f.read()
+    if len(seed) != 32:
+        raise ValueError("%s is not a 32-byte key seed (see --keygen)" % path)
+    return seed
+
+
+def key_initializer(key):
+    """密钥的 C 初始化列表 (OTA_SIG_PUBKEY / OTA_AES_KEY)"""
+    return "{ " + ", ".join("0x%02X" % b for b in key) + " }"
+
+
+def aes_sbox():
+    sbox = [0] * 256
+    for x in range(1, 256):
+        # x 的乘法逆元: 在 GF(2^8) 中穷举
+        inv = next(y for y in range(1, 256) if gf_mul(x, y) == 1)
+        b = inv
+        sbox[x] = b ^ (((b << 1) | (b >> 7)) & 0xFF) ^ (((b << 2) | (b >> 6)) & 0xFF) \
+            ^ (((b << 3) | (b >> 5)) & 0xFF) ^ (((b << 4) | (b >> 4)) & 0xFF) ^ 0x63
+    sbox[0] = 0x63
+    return sbox
+
+
+def gf_mul(a, b):
+    r = 0
+    while b:
+        if b & 1:
+            r ^= a
+        a = ((a << 1) ^ 0x11B) if a & 0x80 else a << 1
+        b >>= 1
+    return r
+
+
+AES_SBOX = aes_sbox()
+AES_MUL2 = [gf_mul(x, 2) for x in range(256)]
+AES_MUL3 = [gf_mul(x, 3) for x in range(256)]
+
+
+def aes_expand(key):
+    """AES-128 轮密钥: 11 个 16 字节轮密钥"""
+    w = [list(key[i:i + 4]) for i in range(0, 16, 4)]
+    rcon = 1
+    for i in range(4, 44):
+        t = list(w[i - 1])
+        if i % 4 == 0:
+            t = [AES_SBOX[t[1]] ^ rcon, AES_SBOX[t[2]], AES_SBOX[t[3]], AES_SBOX[t[0]]]
+            rcon = gf_mul(rcon, 2)
+        w.append([a ^ b for a, b in zip(w[i - 4], t)])
+    return [sum(w[r * 4:r * 4 + 4], []) for r in range(11)]
+
+
+def aes_encrypt(rk, block):
+    s = [a ^ b for a, b in zip(block, rk[0])]
+    for r in range(1, 11):
+        s = [AES_SBOX[s[(i + 4 * (i % 4)) % 16]] for i in range(16)]
+        if r < 10:
+            s = sum(([AES_MUL2[c[0]] ^ AES_MUL3[c[1]] ^ c[2] ^ c[3],
+                      c[0] ^ AES_MUL2[c[1]] ^ AES_MUL3[c[2]] ^ c[3],
+                      c[0] ^ c[1] ^ AES_MUL2[c[2]] ^ AES_MUL3[c[3]],
+                      AES_MUL3[c[0]] ^ c[1] ^ c[2] ^ AES_MUL2[c[3]]]
+                     for c in (s[i:i + 4] for i in range(0, 16, 4))), [])
+        s = [a ^ b for a, b in zip(s, rk[r])]
+    return bytes(s)
+
+
+def aes_ctr(key, iv, off, data):
+    """AES-128-CTR: data 位于固件体偏移 off 处; 第 n 个分组的计数块为 iv 的低 32 位 (大端) 加 n"""
+    rk = aes_expand(key)
+    prefix, low = iv[:12], int.from_bytes(iv[12:], "big")
+    out = bytearray()
+    pos = off
+    while len(out) < len(data):
+        ks = aes_encrypt(rk, prefix + ((low + pos // 16) & 0xFFFFFFFF).to_bytes(4, "big"))
+        n = min(16 - pos % 16, len(data) - len(out))
+        out += bytes(a ^ b for a, b in zip(data[len(out):len(out) + n], ks[pos % 16:pos % 16 + n]))
+        pos += n
+    return bytes(out)
+
+
+def read_aes_key(path):
+    with open(path, "rb") as f:
+        key = f.read()
+    if len(key) != 16:
+        raise ValueError("%s is not a 16-byte AES key (see --aes-keygen)" % path)
+    return key
+
+
+def tlv(tlv_type, value):
+    """TLV 项，值补齐到 4 字节"""
+    return struct.pack("<BBH", tlv_type, 0, len(value)) + value + b"\x00" * (-len(value) % 4)
+
+
+def build_header(body_size, version, crc, tlvs):
+    hdr_len = 16 + len(tlvs)
+    if hdr_len > HDR_MAX:
+        raise ValueError("header is %d bytes, more than OTA_IMG_HDR_MAX (%d); use a larger chunk size"
+                         % (hdr_len, HDR_MAX))
+    return struct.pack("<IIIHH", MAGIC_V2, body_size, version, crc, hdr_len) + tlvs
+
+
+def parse_header(image, aes_key=None):
+    """返回 (hdr_len, body, version, crc, {type: value})，分段固件还原为连续的固件体，加密固件用 aes_key 解密"""
+    magic, body_size, version, crc, hdr_len = struct.unpack_from("<IIIHH", image, 0)
+    if magic != MAGIC_V2:
+        raise ValueError("not a v2 image")
+    items = {}
+    off = 16
+    while off + 4 <= hdr_len:
+        tlv_type, _, length = struct.unpack_from("<BBH", image, off)
+        items[tlv_type] = image[off + 4:off + 4 + length]
+        off += 4 + length + (-length % 4)
+
+    decrypt = lambda off, data: data
+    if image_flags(items) & FLAG_ENCRYPTED:
+        if aes_key is None:
+            raise ValueError("image is encrypted, give its key with --encrypt")
+        decrypt = lambda off, data: aes_ctr(aes_key, items[TLV_IV], off, data)
+    if TLV_SEGMENTS not in items:
+        return hdr_len, decrypt(0, image[hdr_len:hdr_len + body_size]), version, crc, items
+    body = bytearray(b"\xFF" * body_size)
+    pos = hdr_len
+    for i in range(0, len(items[TLV_SEGMENTS]), 8):
+        seg_off, seg_len = struct.unpack_from("<II", items[TLV_SEGMENTS], i)
+        body[seg_off:seg_off + seg_len] = decrypt(seg_off, image[pos:pos + seg_len])
+        pos += seg_len
+    return hdr_len, bytes(body), version, crc, items
+
+
+def image_flags(items):
+    return struct.unpack("<I", items[TLV_FLAGS])[0] if TLV_FLAGS in items else 0
+
+
+def read_hex(path):
+    """Intel HEX -> {地址: bytes}"""
+    data = {}
+    base = 0
+    with open(path) as f:
+        for line in f:
+            line = line.strip()
+            if not line.startswith(":"):
+                continue
+            rec = bytes.fromhex(line[1:])
+            if sum(rec) & 0xFF:
+                raise ValueError("bad checksum in %s" % line)
+            length, addr, rtype = rec[0], (rec[1] << 8) | rec[2], rec[3]
+            value = rec[4:4 + length]
+            if rtype == 0x00:
+                data[base + addr] = value
+            elif rtype == 0x02:
+                base = int.from_bytes(value, "big") << 4
+            elif rtype == 0x04:
+                base = int.from_bytes(value, "big") << 16
+            elif rtype == 0x01:
+                break
+    return data
+
+
+def read_elf(path):
+    """ELF32 小端 -> {物理地址: bytes}，取带文件内容的 PT_LOAD 段"""
+    with open(path, "rb") as f:
+        elf = f.read()
+    if elf[:4] != b"\x7fELF" or elf[4] != 1 or elf[5] != 1:
+        raise ValueError("only little-endian ELF32 is supported")
+    phoff, = struct.unpack_from("<I", elf, 0x1C)
+    phentsize, phnum = struct.unpack_from("<HH", elf, 0x2A)
+    data = {}
+    for i in range(phnum):
+        p_type, p_offset, _, p_paddr, p_filesz = struct.unpack_from("<IIIII", elf, phoff + i * phentsize)
+        if p_type == 1 and p_filesz > 0:
+            data[p_paddr] = elf[p_offset:p_offset + p_filesz]
+    return data
+
+
+def to_segments(data, min_gap):
+    """合并相邻及间隔小于 min_gap 的块 (空隙补 0xFF)，返回 (基址, [(偏移, bytes)])"""
+    runs = []
+    for addr in sorted(data):
+        if runs and addr < runs[-1][0] + len(runs[-1][1]):
+            raise ValueError("overlapping data at 0x%08X" % addr)
+        if runs and addr - (runs[-1][0] + len(runs[-1][1])) < min_gap:
+            start, buf = runs[-1]
+            runs[-1] = (start, buf + b"\xFF" * (addr - start - len(buf)) + data[addr])
+        else:
+            runs.append((addr, bytes(data[addr])))
+    if not runs:
+        raise ValueError("no data")
+    base = runs[0][0]
+    return base, [(addr - base, buf) for addr, buf in runs]
+
+
+def make_image(args):
+    segments = None
+    if args.input.lower().endswith((".hex", ".ihex")):
+        base, segments = to_segments(read_hex(args.input), args.min_gap)
+    elif args.input.lower().endswith((".elf", ".axf")):
+        base, segments = to_segments(read_elf(args.input), args.min_gap)
+    else:
+        with open(args.input, "rb") as f:
+            body = f.read()
+
+    if segments is not None:
+        if args.load_addr is None and not args.reloc:
+            args.load_addr = base
+        last_off, last = segments[-1]
+        body = bytearray(b"\xFF" * (last_off + len(last)))
+        for off, buf in segments:
+            body[off:off + len(buf)] = buf
+        body = bytes(body)
+        if len(segments) == 1:
+            segments = None
+    body += b"\xFF" * (-len(body) % 4)
+
+    tlvs = b""
+    if args.load_addr is not None:
+        tlvs += tlv(TLV_LOAD_ADDR, struct.pack("<I", args.load_addr))
+    if args.entry:
+        tlvs += tlv(TLV_ENTRY, struct.pack("<I", args.entry))
+    if args.hash or args.sign:
+        tlvs += tlv(TLV_HASH, hashlib.sha256(body).digest())
+    if args.sign:
+        seed = read_key(args.sign)
+        sig_pos = len(tlvs) + 4
+        tlvs += tlv(TLV_SIGNATURE, b"\x00" * 64)
+    if args.encrypt:
+        aes_key = read_aes_key(args.encrypt)
+        iv = os.urandom(16)
+        tlvs += tlv(TLV_IV, iv)
+    flags = (FLAG_RELOC if args.reloc else 0) | (FLAG_SEGMENTED if segments else 0) | \
+        (FLAG_ENCRYPTED if args.encrypt else 0)
+    if flags:
+        tlvs += tlv(TLV_FLAGS, struct.pack("<I", flags))
+    if segments:
+        tlvs += tlv(TLV_SEGMENTS, b"".join(struct.pack("<II", off, len(buf)) for off, buf in segments))
+    if args.chunk_size:
+        crcs = [crc16(body[i:i + args.chunk_size]) for i in range(0, len(body), args.chunk_size)]
+        tlvs += tlv(TLV_CHUNKS, struct.pack("<I%dH" % len(crcs), args.chunk_size, *crcs))
+
+    # 补齐到固定的固件头长度，App 可预先按 插槽起始 + 固件头长度 链接
+    if args.hdr_len:
+        if args.hdr_len % 4 or args.hdr_len < 16 + len(tlvs):
+            raise ValueError("--hdr-len must be 4-byte aligned and at least %d" % (16 + len(tlvs)))
+        tlvs += b"\x00" * (args.hdr_len - 16 - len(tlvs))
+
+    # 签名时 img_crc16 与签名值为 0，CRC 在填入签名之后计算
+    if args.sign:
+        sig = ed_sign(seed, build_header(len(body), args.version, 0, tlvs))
+        tlvs = tlvs[:sig_pos] + sig + tlvs[sig_pos + 64:]
+    header = build_header(len(body), args.version, crc16(body, crc16(tlvs)), tlvs)
+    # 只加密传输的数据，各段按其在固件体中的偏移取密钥流
+    if args.encrypt:
+        encrypt = lambda off, data: aes_ctr(aes_key, iv, off, data)
+    else:
+        encrypt = lambda off, data: data
+    with open(args.output, "wb") as f:
+        f.write(header)
+        if segments:
+            for off, buf in segments:
+                f.write(encrypt(off, buf))
+        else:
+            f.write(encrypt(0, body))
+    if segments:
+        print("header %d bytes, %d segments, %d of %d body bytes sent -> %s"
+              % (len(header), len(segments), sum(len(b) for _, b in segments), len(body), args.output))
+    else:
+        print("header %d bytes, body %d bytes -> %s" % (len(header), len(body), args.output))
+
+
+def make_key(args):
+    seed = os.urandom(32)
+    with open(args.keygen, "xb") as f:
+        f.write(seed)
+    print("private key seed -> %s (keep it secret)" % args.keygen)
+    print("#define OTA_SIG_PUBKEY            %s" % key_initializer(ed_public(seed)))
+
+
+def make_aes_key(args):
+    key = os.urandom(16)
+    with open(args.aes_keygen, "xb") as f:
+        f.write(key)
+    print("AES key -> %s (keep it secret)" % args.aes_keygen)
+    print("#define OTA_AES_KEY               %s" % key_initializer(key))
+
+
+def make_repair(args):
+    with open(args.input, "rb") as f:
+        image = f.read()
+    aes_key = read_aes_key(args.encrypt) if args.encrypt else None
+    hdr_len, body, version, crc, items = parse_header(image, aes_key)
+    if TLV_CHUNKS not in items:
+        raise ValueError("image has no chunk table")
+    chunk_size, = struct.unpack_from("<I", items[TLV_CHUNKS], 0)
+    chunk_num = (len(items[TLV_CHUNKS]) - 4) // 2
+
+    chunks = sorted(set(int(s, 0) for s in args.repair.split(",")))
+    if chunks[-1] >= chunk_num:
+        raise ValueError("chunk %d out of range (%d chunks)" % (chunks[-1], chunk_num))
+
+    # 加密固件的修复流沿用原来的初始计数块，各分块按其在固件体中的偏移加密
+    tlvs = tlv(TLV_REPAIR, struct.pack("<%dH" % len(chunks), *chunks))
+    encrypt = lambda off, data: data
+    if image_flags(items) & FLAG_ENCRYPTED:
+        tlvs = tlv(TLV_IV, items[TLV_IV]) + tlv(TLV_FLAGS, struct.pack("<I", FLAG_ENCRYPTED)) + tlvs
+        encrypt = lambda off, data: aes_ctr(aes_key, items[TLV_IV], off, data)
+    header = build_header(len(body), version, crc, tlvs)
+    data = b"".join(encrypt(i * chunk_size, body[i * chunk_size:(i + 1) * chunk_size]) for i in chunks)
+    with open(args.output, "wb") as f:
+        f.write(header + data)
+    print("%d chunks, %d bytes -> %s" % (len(chunks), len(header) + len(data), args.output))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="MiniOTA v2 image generator")
+    parser.add_argument("input", nargs="?", help="bin / hex / elf (生成固件) 或 v2 固件 (--repair)")
+    parser.add_argument("version", nargs="?", help="版本号 (默认 1)")
+    parser.add_argument("output", nargs="?", help="输出文件")
+    parser.add_argument("--load-addr", type=lambda s: int(s, 0), help="固件体的链接地址 (插槽起始 + 固件头长度)")
+    parser.add_argument("--entry", type=lambda s: int(s, 0), default=0, help="向量表相对固件体的偏移")
+    parser.add_argument("--reloc", action="store_true", help="固件尾部带 OtaRelocGen.py 生成的重定位表")
+    parser.add_argument("--hash", action="store_true", help="写入固件体的 SHA-256 摘要 (Bootloader 需使能 OTA_SHA256_ENABLE)")
+    parser.add_argument("--sign", metavar="KEY", help="用私钥种子文件签名 (隐含 --hash，Bootloader 需使能 OTA_SIG_ENABLE)")
+    parser.add_argument("--keygen", metavar="KEY", help="生成私钥种子文件并输出 OTA_SIG_PUBKEY")
+    parser.add_argument("--encrypt", metavar="KEY",
+                        help="用 16 字节密钥文件加密传输的固件体 (Bootloader 需使能 OTA_AES_ENABLE); --repair 时为原固件的密钥")
+    parser.add_argument("--aes-keygen", metavar="KEY", help="生成 16 字节 AES 密钥文件并输出 OTA_AES_KEY")
+    parser.add_argument("--chunk-size", type=lambda s: int(s, 0), default=0, help="分块 CRC 表的分块大小，如 1024")
+    parser.add_argument("--hdr-len", type=lambda s: int(s, 0), default=0, help="以填充补齐的固件头长度，如 0x100")
+    parser.add_argument("--min-gap", type=lambda s: int(s, 0), default=256,
+                        help="hex/elf 输入中不传输的最小空隙 (更小的空隙补 0xFF 传输)")
+    parser.add_argument("--repair", help="Bootloader 输出的损坏分块序号，逗号分隔")
+    args = parser.parse_args()
+
+    # 输入与输出均为可选位置参数 (--keygen、--aes-keygen 不需要)，省略版本号时第二个位置参数即输出文件
+    if args.output is None:
+        args.output, args.version = args.version, None
+    if not (args.keygen or args.aes_keygen) and (args.input is None or args.output is None):
+        parser.error("input and output are required")
+    try:
+        args.version = int(args.version, 0) if args.version is not None else 1
+    except ValueError:
+        parser.error("invalid version: %s" % args.version)
+
+    try:
+        if args.keygen:
+            make_key(args)
+        elif args.aes_keygen:
+            make_aes_key(args)
+        elif args.repair:
+            make_repair(args)
+        else:
+            make_image(args)
+    except (ValueError, OSError) as e:
+        sys.exit("error: %s" % e)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,139 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+MiniOTA 令牌化日志解码工具
+
+根据 Core/ota_src/OtaLogDict.h 生成日志字典，并将调试串口输出的令牌帧
+(OTA_LOG_TOKEN_SYNC + ID + 参数个数 + 小端参数) 还原为文本；
+帧以外的字节 (OTA_LogWrite 输出的原始字符串) 原样显示。
+
+用法:
+    python OtaLogDecode.py --dump                       # 打印生成的字典 (JSON)
+    python OtaLogDecode.py capture.bin                  # 解码抓取的原始串口数据
+    python OtaLogDecode.py --port COM5 --baud 115200    # 实时解码 (需要 pyserial)
+"""
+
+import argparse
+import json
+import os
+import re
+import sys
+
+TOKEN_SYNC = 0xA5
+
+DEFAULT_DICT = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                            "..", "Core", "ota_src", "OtaLogDict.h")
+
+# 与 OtaLogDict.h 中列表顺序一致，决定 ID 编号与输出前缀
+LEVEL_LISTS = (
+    ("OTA_LOG_DICT_ERROR", "[OTA][Error]:"),
+    ("OTA_LOG_DICT_INFO",  "[OTA]:"),
+    ("OTA_LOG_DICT_DEBUG", "[OTA]:"),
+)
+
+ENTRY_RE = re.compile(r'X\(\s*(\w+)\s*,\s*"((?:[^"\\]|\\.)*)"\s*\)')
+
+
+def load_dict(path):
+    """解析 OtaLogDict.h，返回按 ID 排列的 (名称, 前缀, 文本) 列表"""
+    with open(path, encoding="utf-8") as f:
+        src = f.read()
+
+    entries = []
+    for macro, prefix in LEVEL_LISTS:
+        m = re.search(r"#define\s+%s\(X\)((?:.*\\\n)*.*)" % macro, src)
+        if m is None:
+            raise ValueError("%s not found in %s" % (macro, path))
+        for name, text in ENTRY_RE.findall(m.group(1)):
+            entries.append((name, prefix, bytes(text, "utf-8").decode("unicode_escape")))
+    return entries
+
+
+def decode(stream, entries, out):
+    """逐字节解码，stream 为可迭代的 bytes 块"""
+    state = 0
+    frame = bytearray()
+    argc = 0
+
+    for chunk in stream:
+        for b in chunk:
+            if state == 0:
+                if b == TOKEN_SYNC:
+                    frame = bytearray()
+                    state = 1
+                else:
+                    out.write(chr(b))
+            elif state == 1:
+                frame.append(b)
+                state = 2
+            elif state == 2:
+                argc = b
+                if argc == 0:
+                    emit(frame[0], [], entries, out)
+                    state = 0
+                else:
+                    frame = bytearray([frame[0]])
+                    state = 3
+            else:
+                frame.append(b)
+                if len(frame) == 1 + 4 * argc:
+                    args = [int.from_bytes(frame[1 + 4 * i:5 + 4 * i], "little")
+                            for i in range(argc)]
+                    emit(frame[0], args, entries, out)
+                    state = 0
+        out.flush()
+
+
+def emit(tok, args, entries, out):
+    if tok >= len(entries):
+        out.write("[OTA][Unknown token %d]%s\r\n" % (tok, "".join(" 0x%08X" % a for a in args)))
+        return
+    _, prefix, text = entries[tok]
+    out.write(prefix + text + " ".join("0x%08X" % a for a in args) + "\r\n")
+
+
+def serial_stream(port, baud):
+    import serial  # pyserial
+    with serial.Serial(port, baud, timeout=0.1) as ser:
+        while True:
+            data = ser.read(256)
+            if data:
+                yield data
+
+
+def file_stream(path):
+    with open(path, "rb") if path != "-" else sys.stdin.buffer as f:
+        while True:
+            data = f.read(4096)
+            if not data:
+                break
+            yield data
+
+
+def main():
+    ap = argparse.ArgumentParser(description="MiniOTA tokenized log decoder")
+    ap.add_argument("input", nargs="?", default="-", help="raw capture file, '-' for stdin")
+    ap.add_argument("--dict", default=DEFAULT_DICT, help="path to OtaLogDict.h")
+    ap.add_argument("--dump", action="store_true", help="print the generated dictionary as JSON")
+    ap.add_argument("--port", help="serial port for live decoding")
+    ap.add_argument("--baud", type=int, default=115200)
+    opt = ap.parse_args()
+
+    entries = load_dict(opt.dict)
+
+    if opt.dump:
+        json.dump([{"id": i, "name": n, "prefix": p, "text": t}
+                   for i, (n, p, t) in enumerate(entries)],
+                  sys.stdout, ensure_ascii=False, indent=2)
+        sys.stdout.write("\n")
+        return
+
+    stream = serial_stream(opt.port, opt.baud) if opt.port else file_stream(opt.input)
+    try:
+        decode(stream, entries, sys.stdout)
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,72 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+MiniOTA 重定位固件生成工具
+
+同一工程分别以 0 和另一个基址 (如 0x00100000) 为 R/O Base 链接并导出 bin，
+比较两个 bin 中相差恰好为基址差的字，得到需要重定位的绝对地址，
+在以 0 为基址的 bin 后追加重定位表 (升序 uint32_t 偏移 + 项数 + "RELO" 魔数)。
+输出文件再用固件头工具添加固件头即可写入任意插槽 (Bootloader 需使能 OTA_RELOC_ENABLE)。
+
+用法:
+    python OtaRelocGen.py app_0.bin app_100000.bin 0x100000 app_reloc.bin
+"""
+
+import argparse
+import struct
+import sys
+
+RELOC_MAGIC = 0x4F4C4552
+
+
+def find_relocs(bin0, bin1, delta):
+    """返回 4 字节对齐、在两个 bin 中相差 delta 且指向固件内部的字的偏移"""
+    if len(bin0) != len(bin1):
+        raise ValueError("images differ in size (%d / %d), link both with the same options"
+                         % (len(bin0), len(bin1)))
+
+    relocs = []
+    for off in range(0, len(bin0) - 3, 4):
+        w0, = struct.unpack_from("<I", bin0, off)
+        w1, = struct.unpack_from("<I", bin1, off)
+        if w0 == w1:
+            continue
+        if (w1 - w0) & 0xFFFFFFFF != delta or w0 >= len(bin0):
+            raise ValueError("word at 0x%08X is not a plain absolute address (0x%08X / 0x%08X)"
+                             % (off, w0, w1))
+        relocs.append(off)
+    return relocs
+
+
+def main():
+    parser = argparse.ArgumentParser(description="MiniOTA relocatable image generator")
+    parser.add_argument("bin0", help="以 0 为基址链接的 bin")
+    parser.add_argument("bin1", help="以 delta 为基址链接的 bin")
+    parser.add_argument("delta", type=lambda s: int(s, 0), help="第二个 bin 的基址")
+    parser.add_argument("output", help="输出文件")
+    args = parser.parse_args()
+
+    with open(args.bin0, "rb") as f:
+        bin0 = f.read()
+    with open(args.bin1, "rb") as f:
+        bin1 = f.read()
+
+    # 固件长度补齐到 4 字节，重定位表与偏移保持对齐
+    bin0 += b"\xFF" * (-len(bin0) % 4)
+    bin1 += b"\xFF" * (-len(bin1) % 4)
+
+    try:
+        relocs = find_relocs(bin0, bin1, args.delta)
+    except ValueError as e:
+        sys.exit("error: %s" % e)
+
+    with open(args.output, "wb") as f:
+        f.write(bin0)
+        f.write(struct.pack("<%dI" % len(relocs), *relocs))
+        f.write(struct.pack("<II", len(relocs), RELOC_MAGIC))
+
+    print("%d relocations, %d bytes -> %s" % (len(relocs), len(bin0) + 4 * len(relocs) + 8, args.output))
+
+
+if __name__ == "__main__":
+    main()